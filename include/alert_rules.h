@@ -0,0 +1,123 @@
+// -----------------------------------------------------------------------------
+// Règles d'alerte envoyées par l'hôte ({"cmd":"rules"}), par exemple
+// "cpu > 90 pendant 30 s" ou "disque libre < 5 Go". L'hôte les compile
+// (tools/alert_rules.py) en table compacte: métrique, sens, seuil, durée, effets.
+// Évaluation incrémentale: chaque échantillon d'une métrique ne touche que les
+// règles de cette métrique, en O(1) chacune. Une règle retient depuis quand sa
+// condition tient (since); elle se déclenche quand cela dure holdMs, et retombe
+// au premier échantillon qui ne la vérifie plus. Aucun historique n'est relu.
+// -----------------------------------------------------------------------------
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include "time_source.h"
+
+enum AlertMetric : uint8_t {
+  kAlertCpu,       // %
+  kAlertRam,       // % utilisée
+  kAlertRamFree,   // Mo
+  kAlertNet,       // Ko/s rx+tx
+  kAlertTemp,      // °C
+  kAlertDiskFree,  // Mo, disque le moins libre
+  kAlertMetrics
+};
+
+static const char *const kAlertMetricNames[kAlertMetrics] = {"cpu", "ram", "ram_free", "net", "temp", "disk_free"};
+
+// Effets d'affichage (combinables)
+#define ALERT_FX_BANNER 0x01  // bandeau inversé à la place du ticker tant que l'alerte dure
+#define ALERT_FX_FLASH 0x02   // écran inversé quelques battements au déclenchement
+
+static inline int8_t alertMetricByName(const char *s) {
+  for (uint8_t m = 0; m < kAlertMetrics; m++)
+    if (!strcmp(s, kAlertMetricNames[m])) return (int8_t)m;
+  return -1;
+}
+
+struct AlertRule {
+  float threshold;
+  uint32_t holdMs;
+  uint32_t since;        // premier échantillon de la série qui vérifie la condition
+  uint16_t latencyMs;    // au déclenchement: retard sur since + holdMs (cadence des échantillons)
+  uint8_t metric;
+  uint8_t fx;
+  uint8_t below : 1;     // condition "<" (sinon ">")
+  uint8_t holding : 1;   // condition vraie depuis since
+  uint8_t active : 1;    // déclenchée, pas encore retombée
+};
+
+template <uint8_t N>
+class AlertEngine {
+ public:
+  static_assert(N <= 32, "un bit par règle dans les masques");
+
+  void clear() {
+    n_ = 0;
+    memset(byMetric_, 0, sizeof(byMetric_));
+  }
+
+  bool add(uint8_t metric, bool below, float threshold, uint32_t holdMs, uint8_t fx) {
+    if (n_ >= N || metric >= kAlertMetrics || isnan(threshold)) return false;
+    AlertRule &r = rules_[n_];
+    r = AlertRule();
+    r.metric = metric; r.below = below; r.threshold = threshold;
+    r.holdMs = holdMs; r.fx = fx;
+    byMetric_[metric] |= 1u << n_;
+    n_++;
+    return true;
+  }
+
+  uint8_t size() const { return n_; }
+  const AlertRule &rule(uint8_t i) const { return rules_[i]; }
+
+  // Un échantillon v de la métrique m reçu à now. Retourne les règles qui ont
+  // changé d'état (bit i): déclenchées si rule(i).active, sinon retombées.
+  uint32_t sample(uint8_t m, float v, uint32_t now) {
+    if (m >= kAlertMetrics || isnan(v)) return 0;
+    uint32_t changed = 0;
+    for (uint32_t bits = byMetric_[m]; bits; bits &= bits - 1) {
+      const uint8_t i = (uint8_t)__builtin_ctz(bits);
+      AlertRule &r = rules_[i];
+      const bool cond = r.below ? v < r.threshold : v > r.threshold;
+      if (!cond) {
+        r.holding = false;
+        if (r.active) { r.active = false; changed |= 1u << i; }
+        continue;
+      }
+      if (!r.holding) { r.holding = true; r.since = now; }
+      const uint32_t held = (uint32_t)msSince(now, r.since);
+      if (!r.active && held >= r.holdMs) {
+        const uint32_t late = held - r.holdMs;
+        r.active = true;
+        r.latencyMs = (uint16_t)(late > 0xFFFF ? 0xFFFF : late);
+        newest_ = i;
+        changed |= 1u << i;
+      }
+    }
+    return changed;
+  }
+
+  // Plus d'échantillons (liaison perdue): tout retombe. Retourne les règles retombées.
+  uint32_t release() {
+    uint32_t changed = 0;
+    for (uint8_t i = 0; i < n_; i++) {
+      if (rules_[i].active) changed |= 1u << i;
+      rules_[i].active = rules_[i].holding = false;
+    }
+    return changed;
+  }
+
+  // Dernière règle déclenchée encore active qui porte l'effet fx, -1 sinon
+  int8_t newestActive(uint8_t fx) const {
+    if (newest_ < n_ && rules_[newest_].active && (rules_[newest_].fx & fx)) return (int8_t)newest_;
+    for (int8_t i = (int8_t)n_ - 1; i >= 0; i--)
+      if (rules_[i].active && (rules_[i].fx & fx)) return i;
+    return -1;
+  }
+
+ private:
+  AlertRule rules_[N];
+  uint32_t byMetric_[kAlertMetrics] = {};  // règles de chaque métrique (bit i)
+  uint8_t n_ = 0, newest_ = 0xFF;
+};
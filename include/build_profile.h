@@ -0,0 +1,119 @@
+// -----------------------------------------------------------------------------
+// Profils de compilation: tous les réglages de performance / consommation
+// regroupés dans une structure constexpr choisie par -D SMON_PROFILE=<n>
+// (voir les environnements PlatformIO). Ce qui doit disparaître du binaire
+// (instrumentation) passe aussi par une macro; le reste est du code mort
+// éliminé par le compilateur quand le drapeau constexpr est faux.
+// -----------------------------------------------------------------------------
+#pragma once
+#include <stdint.h>
+
+#define SMON_PROFILE_DEFAULT 0
+#define SMON_PROFILE_HIGH_FPS 1
+#define SMON_PROFILE_LOW_POWER 2
+#define SMON_PROFILE_INSTRUMENTED 3
+#define SMON_PROFILE_MINIMAL_FLASH 4
+
+#ifndef SMON_PROFILE
+#define SMON_PROFILE SMON_PROFILE_DEFAULT
+#endif
+
+// Instrumentation (compteurs, histogrammes, {"t":"stat"}): forçable par -D SMON_INSTRUMENT=0/1
+#ifndef SMON_INSTRUMENT
+#if SMON_PROFILE == SMON_PROFILE_MINIMAL_FLASH || SMON_PROFILE == SMON_PROFILE_LOW_POWER
+#define SMON_INSTRUMENT 0
+#else
+#define SMON_INSTRUMENT 1
+#endif
+#endif
+
+template <int P>
+struct BuildProfile {
+  static constexpr const char *name() { return "default"; }
+  // Rendu
+  static constexpr uint16_t frameMs = 60;         // ~16 FPS
+  static constexpr float ease = 0.15f;            // lissage des jauges par frame
+  static constexpr float easeLive = 0.5f;         // idem pendant les lots rapides {"t":"b"}
+  static constexpr uint8_t tickerEvery = 1;       // le ticker avance d'1 px toutes les N frames
+  static constexpr uint32_t i2cHz = 400000;       // horloge I2C pendant display()
+  static constexpr bool animations = true;        // clin d'œil, sueur, balancement
+  static constexpr bool netView = true;           // page RX/TX en alternance avec CPU/RAM
+  static constexpr bool hostFrames = true;        // frames rendues par l'hôte ({"t":"fb"}, SH1106)
+  static constexpr bool uiPages = true;           // pages historique/processus/réseau ({"cmd":"page"}, SH1106)
+  // Écrans (include/panel.h)
+  static constexpr uint16_t flushSliceUs = 3500;  // temps de bus par passage de loop() (~1 page à 400 kHz)
+  static constexpr uint16_t histFrameMs = 1000;    // 2e écran (historique), -D SMON_PANEL2_ADDR=0x3D
+  // Liaison série
+  static constexpr uint16_t rxBuffer = 1024;
+  static constexpr uint16_t lineMax = 1536;
+  static constexpr uint16_t jsonDocBytes = 2048;
+  static constexpr bool jsonFastPath = true;      // instantanés lus sans ArduinoJson (src/main.cpp)
+  static constexpr bool newestWins = true;        // file série en retard: seul le dernier instantané est lu
+  static constexpr bool deltaIngest = true;       // instantanés en delta {"t":"d"} (include/snap_delta.h)
+  static constexpr uint8_t liveQueue = 64;
+  static constexpr uint16_t histSlots = 120;      // créneaux d'une minute
+  static constexpr uint8_t alertRules = 8;        // règles {"cmd":"rules"} retenues
+  static constexpr bool flashHistory = true;      // historique raw/1m/15m sur LittleFS ({"cmd":"dump"})
+  // Sommeil du tamagochi
+  static constexpr uint16_t noDataSleepMs = 4000;
+  static constexpr uint16_t lowLoadSleepMs = 9000;
+  static constexpr bool instrument = SMON_INSTRUMENT;
+};
+
+// 30 FPS: I2C poussé à 800 kHz (hors spécification SH1106, tenu par la plupart
+// des modules) pour que display() (~1 Ko) tienne dans la frame
+template <>
+struct BuildProfile<SMON_PROFILE_HIGH_FPS> : BuildProfile<SMON_PROFILE_DEFAULT> {
+  static constexpr const char *name() { return "high-fps"; }
+  static constexpr uint16_t frameMs = 33;
+  static constexpr float ease = 0.10f;
+  static constexpr float easeLive = 0.35f;
+  static constexpr uint8_t tickerEvery = 2;
+  static constexpr uint32_t i2cHz = 800000;
+  static constexpr uint16_t rxBuffer = 2048;
+  static constexpr uint8_t liveQueue = 128;
+};
+
+// 8 FPS, CPU à 80 MHz (board_build.f_cpu), pas d'instrumentation: le cœur dort
+// entre deux frames
+template <>
+struct BuildProfile<SMON_PROFILE_LOW_POWER> : BuildProfile<SMON_PROFILE_DEFAULT> {
+  static constexpr const char *name() { return "low-power"; }
+  static constexpr uint16_t frameMs = 125;
+  static constexpr float ease = 0.30f;
+  static constexpr float easeLive = 0.7f;
+  static constexpr bool animations = false;
+  static constexpr bool netView = false;
+  static constexpr uint16_t histFrameMs = 2000;
+  static constexpr uint8_t liveQueue = 32;
+  static constexpr uint16_t noDataSleepMs = 3000;
+  static constexpr uint16_t lowLoadSleepMs = 5000;
+};
+
+// Réglages par défaut, instrumentation forcée: pour le soak test et les mesures
+template <>
+struct BuildProfile<SMON_PROFILE_INSTRUMENTED> : BuildProfile<SMON_PROFILE_DEFAULT> {
+  static constexpr const char *name() { return "instrumented"; }
+};
+
+// Binaire minimal: ni instrumentation ni animations secondaires, tampons réduits
+template <>
+struct BuildProfile<SMON_PROFILE_MINIMAL_FLASH> : BuildProfile<SMON_PROFILE_DEFAULT> {
+  static constexpr const char *name() { return "minimal-flash"; }
+  static constexpr bool animations = false;
+  static constexpr bool netView = false;
+  static constexpr bool hostFrames = false;
+  static constexpr bool uiPages = false;
+  static constexpr uint16_t rxBuffer = 512;
+  static constexpr uint16_t lineMax = 1024;
+  static constexpr uint16_t jsonDocBytes = 1536;
+  static constexpr bool jsonFastPath = false;
+  static constexpr bool newestWins = false;
+  static constexpr bool deltaIngest = false;
+  static constexpr uint8_t liveQueue = 16;
+  static constexpr uint16_t histSlots = 60;
+  static constexpr uint8_t alertRules = 4;
+  static constexpr bool flashHistory = false;
+};
+
+typedef BuildProfile<SMON_PROFILE> Profile;
@@ -0,0 +1,74 @@
+// -----------------------------------------------------------------------------
+// Conteneurs à capacité fixe pour les tableaux du payload (disques, interfaces...)
+// Aucune allocation: la taille est connue à la compilation, le surplus est
+// ignoré et compté par l'appelant (compteurs de troncature).
+// -----------------------------------------------------------------------------
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include "utf8.h"
+
+// Chaîne courte dans un tampon fixe (N caractères utiles + '\0')
+template <uint8_t N>
+class FixedString {
+ public:
+  FixedString() { buf_[0] = 0; }
+
+  // Copie au plus N octets sans couper de caractère UTF-8; retourne false si la source a été tronquée
+  bool assign(const char *s) {
+    if (!s) s = "";
+    uint8_t i = 0;
+    for (; i < N && s[i]; i++) buf_[i] = s[i];
+    const bool whole = s[i] == 0;
+    if (!whole) i = (uint8_t)utf8Fit(buf_, i);
+    buf_[i] = 0;
+    len_ = i;
+    return whole;
+  }
+
+  const char *c_str() const { return buf_; }
+  uint8_t length() const { return len_; }
+  bool empty() const { return len_ == 0; }
+  bool operator==(const char *s) const { return s && strcmp(buf_, s) == 0; }
+  static uint8_t capacity() { return N; }
+
+ private:
+  char buf_[N + 1];
+  uint8_t len_ = 0;
+};
+
+// Tableau contigu de capacité N: éléments construits en place, pas de tas
+template <typename T, uint8_t N>
+class StaticVector {
+ public:
+  // Nouvel élément (réinitialisé) en fin de tableau, ou nullptr si plein
+  T *emplace() {
+    if (size_ >= N) return nullptr;
+    items_[size_] = T();
+    return &items_[size_++];
+  }
+  void pop() { if (size_) size_--; }
+  void clear() { size_ = 0; }
+
+  uint8_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  bool full() const { return size_ >= N; }
+  static uint8_t capacity() { return N; }
+
+  T &operator[](uint8_t i) { return items_[i]; }
+  const T &operator[](uint8_t i) const { return items_[i]; }
+  T *begin() { return items_; }
+  T *end() { return items_ + size_; }
+  const T *begin() const { return items_; }
+  const T *end() const { return items_ + size_; }
+
+  // Recherche par identifiant court (champ `id` de type FixedString)
+  const T *find(const char *id) const {
+    for (uint8_t i = 0; i < size_; i++) if (items_[i].id == id) return &items_[i];
+    return nullptr;
+  }
+
+ private:
+  T items_[N];
+  uint8_t size_ = 0;
+};
@@ -0,0 +1,159 @@
+// -----------------------------------------------------------------------------
+// Texte en police proportionnelle (font_data.h, générée par tools/gen_font.py)
+// Les glyphes sont des colonnes 1 bit posées par Raster::blit, donc écrites
+// page par page sur le SH1106 au lieu d'un drawPixel virtuel par point.
+// Les largeurs se mesurent sans crénage (somme des avances).
+//   fontDraw / WidthCache  chaînes ASCII du firmware (libellés, nombres)
+//   GlyphString            champs reçus en UTF-8 (app, météo, ticker): décodés
+//                          et repliés sur la police une fois à l'arrivée, le
+//                          rendu ne lit plus que des numéros de glyphes
+// -----------------------------------------------------------------------------
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include "font_data.h"
+#include "utf8.h"
+
+// Glyphe d'un octet; hors du sous-ensemble généré: '?'
+static inline uint8_t fontGlyph(uint8_t c) {
+  uint8_t g = (c >= kFontFirst && c <= kFontLast) ? kFontIndex[c - kFontFirst] : 0xFF;
+  return g == 0xFF ? kFontMissing : g;
+}
+static inline uint8_t fontGlyphWidth(uint8_t g) { return (uint8_t)(kFontOffset[g + 1] - kFontOffset[g]); }
+static inline uint8_t fontAdvance(uint8_t c) { return (uint8_t)(fontGlyphWidth(fontGlyph(c)) + kFontSpacing); }
+
+// Largeur en pixels, sans l'espacement qui suit le dernier glyphe
+static inline uint16_t fontWidth(const char *s, uint16_t len) {
+  uint16_t w = 0;
+  for (uint16_t i = 0; i < len; i++) w += fontAdvance((uint8_t)s[i]);
+  return w ? (uint16_t)(w - kFontSpacing) : 0;
+}
+
+// Glyphes d'un point de code (1 à 3 par repli, 0 s'il est ignoré); inconnu: '?'
+static inline uint8_t fontFold(uint32_t cp, uint8_t out[3]) {
+  if (cp < 0x80) { out[0] = fontGlyph((uint8_t)cp); return 1; }
+  uint16_t lo = 0, hi = kFoldCount;
+  while (cp <= 0xFFFF && lo < hi) {
+    const uint16_t mid = (uint16_t)((lo + hi) / 2);
+    if (kFoldCp[mid] < cp) lo = (uint16_t)(mid + 1);
+    else hi = mid;
+  }
+  if (cp > 0xFFFF || lo >= kFoldCount || kFoldCp[lo] != cp) { out[0] = kFontMissing; return 1; }
+  uint8_t n = 0;
+  while (n < 3 && kFoldTo[lo][n] != 0xFF) { out[n] = kFoldTo[lo][n]; n++; }
+  return n;
+}
+
+static inline uint32_t fontHash(const char *s, uint16_t len) {
+  uint32_t h = 2166136261u;  // FNV-1a
+  for (uint16_t i = 0; i < len; i++) h = (h ^ (uint8_t)s[i]) * 16777619u;
+  return h;
+}
+
+// Dessine à partir de (x, y) = coin haut gauche; les glyphes entièrement hors
+// de la surface sont sautés (ticker). Retourne le x qui suit le texte.
+template <class Surf>
+static int fontDrawGlyphs(Surf &surf, int x, int y, const uint8_t *glyphs, uint16_t n, uint8_t ink) {
+  for (uint16_t i = 0; i < n && x < Surf::kW; i++) {
+    const uint8_t g = glyphs[i], w = fontGlyphWidth(g);
+    if (x + w > 0) surf.blit(kFontCols + kFontOffset[g], w, kFontHeight, x, y, ink);
+    x += w + kFontSpacing;
+  }
+  return x;
+}
+
+// Idem pour une chaîne ASCII (un octet = un glyphe)
+template <class Surf>
+static int fontDraw(Surf &surf, int x, int y, const char *s, uint16_t len, uint8_t ink) {
+  for (uint16_t i = 0; i < len && x < Surf::kW; i++) {
+    const uint8_t g = fontGlyph((uint8_t)s[i]);
+    x = fontDrawGlyphs(surf, x, y, &g, 1, ink);
+  }
+  return x;
+}
+
+// Largeurs mesurées des N dernières chaînes (clé FNV-1a + longueur),
+// remplacement circulaire
+template <uint8_t N>
+class WidthCache {
+ public:
+  uint16_t measure(const char *s, uint16_t len) {
+    const uint32_t key = fontHash(s, len);
+    for (uint8_t i = 0; i < count_; i++)
+      if (key_[i] == key && len_[i] == len) return w_[i];
+    const uint8_t slot = next_;
+    next_ = (uint8_t)((next_ + 1) % N);
+    if (count_ < N) count_++;
+    key_[slot] = key;
+    len_[slot] = len;
+    return w_[slot] = fontWidth(s, len);
+  }
+
+ private:
+  uint32_t key_[N] = {};
+  uint16_t len_[N] = {};
+  uint16_t w_[N] = {};
+  uint8_t count_ = 0, next_ = 0;
+};
+
+// Chaîne UTF-8 décodée en numéros de glyphes (au plus N), largeur comprise
+template <uint16_t N>
+class GlyphString {
+ public:
+  struct Fit {
+    uint16_t n;      // glyphes gardés
+    uint16_t w;      // largeur affichée, ellipse comprise
+    bool ellipsis;
+  };
+
+  // Décode et replie s; false si c'est la chaîne déjà en place (rien refait)
+  bool assign(const char *s) { return assign(s, (uint16_t)strlen(s)); }
+  bool assign(const char *s, uint16_t len) {
+    const uint32_t h = fontHash(s, len);
+    if (set_ && h == srcHash_ && len == srcLen_) return false;
+    set_ = true; srcHash_ = h; srcLen_ = len;
+    n_ = 0; w_ = 0; truncated_ = false;
+    for (uint16_t i = 0; i < len;) {
+      uint8_t g[3];
+      const uint8_t k = fontFold(utf8Next(s, len, i), g);
+      if (n_ + k > N) { truncated_ = true; break; }
+      for (uint8_t j = 0; j < k; j++) { g_[n_++] = g[j]; w_ += fontGlyphWidth(g[j]) + kFontSpacing; }
+    }
+    if (w_) w_ -= kFontSpacing;
+    return true;
+  }
+
+  uint16_t size() const { return n_; }
+  uint16_t width() const { return w_; }
+  bool truncated() const { return truncated_; }
+  const uint8_t *glyphs() const { return g_; }
+
+  // Coupe à px de large, points de suspension si tout ne tient pas
+  Fit fit(int px) const {
+    if (w_ <= px) return Fit{n_, w_, false};
+    const int ell = fontGlyphWidth(fontGlyph((uint8_t)kFontEllipsis));
+    if (ell > px) return Fit{0, 0, false};
+    uint16_t n = 0, w = 0;
+    while (n < n_) {
+      const uint8_t adv = (uint8_t)(fontGlyphWidth(g_[n]) + kFontSpacing);
+      if (w + adv + ell > px) break;
+      w += adv;
+      n++;
+    }
+    return Fit{n, (uint16_t)(w + ell), true};
+  }
+
+  template <class Surf>
+  int draw(Surf &surf, int x, int y, uint8_t ink) const { return fontDrawGlyphs(surf, x, y, g_, n_, ink); }
+  template <class Surf>
+  int draw(Surf &surf, int x, int y, uint8_t ink, const Fit &f) const {
+    x = fontDrawGlyphs(surf, x, y, g_, f.n, ink);
+    return f.ellipsis ? fontDraw(surf, x, y, &kFontEllipsis, 1, ink) : x;
+  }
+
+ private:
+  uint8_t g_[N];
+  uint16_t n_ = 0, w_ = 0, srcLen_ = 0;
+  uint32_t srcHash_ = 0;
+  bool set_ = false, truncated_ = false;
+};
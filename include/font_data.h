@@ -0,0 +1,134 @@
+// -----------------------------------------------------------------------------
+// Police proportionnelle 7 px, GÉNÉRÉE par tools/gen_font.py: ne pas éditer.
+// 96 glyphes, 428 colonnes; octet = colonne, bit 0 en haut.
+// -----------------------------------------------------------------------------
+#pragma once
+#include <stdint.h>
+
+static constexpr uint8_t kFontHeight = 7;
+static constexpr uint8_t kFontSpacing = 1;   // colonne vide après chaque glyphe
+static constexpr uint8_t kFontFirst = 0x20, kFontLast = 0x7F;
+static constexpr char kFontEllipsis = 0x7F;  // '...' sur un seul glyphe
+static constexpr uint8_t kFontMissing = 0x1F;   // glyphe de '?'
+static constexpr uint8_t kFontGlyphs = 96;
+
+// Code - kFontFirst -> numéro de glyphe (0xFF: absent du sous-ensemble)
+static constexpr uint8_t kFontIndex[kFontLast - kFontFirst + 1] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F,
+    0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F,
+    0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F,
+    0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0x3E, 0x3F,
+    0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4A, 0x4B, 0x4C, 0x4D, 0x4E, 0x4F,
+    0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x5B, 0x5C, 0x5D, 0x5E, 0x5F,
+};
+
+// Début de chaque glyphe dans kFontCols; largeur = kFontOffset[g + 1] - kFontOffset[g]
+static constexpr uint16_t kFontOffset[kFontGlyphs + 1] = {
+    0, 2, 3, 6, 11, 16, 21, 26, 28, 31, 34, 39, 44, 46, 51, 53,
+    58, 63, 68, 73, 78, 83, 88, 93, 98, 103, 108, 110, 112, 116, 121, 125,
+    130, 135, 140, 145, 150, 155, 160, 165, 170, 175, 178, 183, 188, 193, 198, 203,
+    208, 213, 218, 223, 228, 233, 238, 243, 248, 253, 258, 263, 266, 271, 274, 279,
+    284, 287, 292, 297, 302, 307, 312, 317, 322, 327, 330, 334, 338, 341, 346, 351,
+    356, 361, 366, 371, 376, 381, 386, 391, 396, 401, 406, 411, 414, 415, 418, 423,
+    428,
+};
+
+static constexpr uint8_t kFontCols[] = {
+    0x00, 0x00, 0x5F, 0x07, 0x00, 0x07, 0x14, 0x7F, 0x14, 0x7F, 0x14, 0x24, 0x2A, 0x7F, 0x2A, 0x12,
+    0x23, 0x13, 0x08, 0x64, 0x62, 0x36, 0x49, 0x55, 0x22, 0x50, 0x05, 0x03, 0x1C, 0x22, 0x41, 0x41,
+    0x22, 0x1C, 0x14, 0x08, 0x3E, 0x08, 0x14, 0x08, 0x08, 0x3E, 0x08, 0x08, 0x50, 0x30, 0x08, 0x08,
+    0x08, 0x08, 0x08, 0x60, 0x60, 0x20, 0x10, 0x08, 0x04, 0x02, 0x3E, 0x51, 0x49, 0x45, 0x3E, 0x00,
+    0x42, 0x7F, 0x40, 0x00, 0x42, 0x61, 0x51, 0x49, 0x46, 0x21, 0x41, 0x45, 0x4B, 0x31, 0x18, 0x14,
+    0x12, 0x7F, 0x10, 0x27, 0x45, 0x45, 0x45, 0x39, 0x3C, 0x4A, 0x49, 0x49, 0x30, 0x01, 0x71, 0x09,
+    0x05, 0x03, 0x36, 0x49, 0x49, 0x49, 0x36, 0x06, 0x49, 0x49, 0x29, 0x1E, 0x36, 0x36, 0x56, 0x36,
+    0x08, 0x14, 0x22, 0x41, 0x14, 0x14, 0x14, 0x14, 0x14, 0x41, 0x22, 0x14, 0x08, 0x02, 0x01, 0x51,
+    0x09, 0x06, 0x32, 0x49, 0x79, 0x41, 0x3E, 0x7E, 0x11, 0x11, 0x11, 0x7E, 0x7F, 0x49, 0x49, 0x49,
+    0x36, 0x3E, 0x41, 0x41, 0x41, 0x22, 0x7F, 0x41, 0x41, 0x22, 0x1C, 0x7F, 0x49, 0x49, 0x49, 0x41,
+    0x7F, 0x09, 0x09, 0x01, 0x01, 0x3E, 0x41, 0x41, 0x51, 0x32, 0x7F, 0x08, 0x08, 0x08, 0x7F, 0x41,
+    0x7F, 0x41, 0x20, 0x40, 0x41, 0x3F, 0x01, 0x7F, 0x08, 0x14, 0x22, 0x41, 0x7F, 0x40, 0x40, 0x40,
+    0x40, 0x7F, 0x02, 0x04, 0x02, 0x7F, 0x7F, 0x04, 0x08, 0x10, 0x7F, 0x3E, 0x41, 0x41, 0x41, 0x3E,
+    0x7F, 0x09, 0x09, 0x09, 0x06, 0x3E, 0x41, 0x51, 0x21, 0x5E, 0x7F, 0x09, 0x19, 0x29, 0x46, 0x46,
+    0x49, 0x49, 0x49, 0x31, 0x01, 0x01, 0x7F, 0x01, 0x01, 0x3F, 0x40, 0x40, 0x40, 0x3F, 0x1F, 0x20,
+    0x40, 0x20, 0x1F, 0x7F, 0x20, 0x18, 0x20, 0x7F, 0x63, 0x14, 0x08, 0x14, 0x63, 0x03, 0x04, 0x78,
+    0x04, 0x03, 0x61, 0x51, 0x49, 0x45, 0x43, 0x7F, 0x41, 0x41, 0x02, 0x04, 0x08, 0x10, 0x20, 0x41,
+    0x41, 0x7F, 0x04, 0x02, 0x01, 0x02, 0x04, 0x40, 0x40, 0x40, 0x40, 0x40, 0x01, 0x02, 0x04, 0x20,
+    0x54, 0x54, 0x54, 0x78, 0x7F, 0x48, 0x44, 0x44, 0x38, 0x38, 0x44, 0x44, 0x44, 0x20, 0x38, 0x44,
+    0x44, 0x48, 0x7F, 0x38, 0x54, 0x54, 0x54, 0x18, 0x08, 0x7E, 0x09, 0x01, 0x02, 0x08, 0x14, 0x54,
+    0x54, 0x3C, 0x7F, 0x08, 0x04, 0x04, 0x78, 0x44, 0x7D, 0x40, 0x20, 0x40, 0x44, 0x3D, 0x7F, 0x10,
+    0x28, 0x44, 0x41, 0x7F, 0x40, 0x7C, 0x04, 0x18, 0x04, 0x78, 0x7C, 0x08, 0x04, 0x04, 0x78, 0x38,
+    0x44, 0x44, 0x44, 0x38, 0x7C, 0x14, 0x14, 0x14, 0x08, 0x08, 0x14, 0x14, 0x18, 0x7C, 0x7C, 0x08,
+    0x04, 0x04, 0x08, 0x48, 0x54, 0x54, 0x54, 0x20, 0x04, 0x3F, 0x44, 0x40, 0x20, 0x3C, 0x40, 0x40,
+    0x20, 0x7C, 0x1C, 0x20, 0x40, 0x20, 0x1C, 0x3C, 0x40, 0x30, 0x40, 0x3C, 0x44, 0x28, 0x10, 0x28,
+    0x44, 0x0C, 0x50, 0x50, 0x50, 0x3C, 0x44, 0x64, 0x54, 0x4C, 0x44, 0x08, 0x36, 0x41, 0x7F, 0x41,
+    0x36, 0x08, 0x02, 0x01, 0x02, 0x04, 0x02, 0x40, 0x00, 0x40, 0x00, 0x40,
+};
+
+// Repli des caractères hors police: kFoldCp trié, kFoldTo = jusqu'à 3 glyphes
+// (0xFF en bourrage; aucun: caractère ignoré). Absent de la table: '?'
+static constexpr uint16_t kFoldCount = 245;
+static constexpr uint16_t kFoldCp[kFoldCount] = {
+    0x00A0, 0x00A1, 0x00A2, 0x00A3, 0x00A5, 0x00A6, 0x00A7, 0x00A8, 0x00A9, 0x00AA, 0x00AB, 0x00AC,
+    0x00AD, 0x00AE, 0x00AF, 0x00B0, 0x00B1, 0x00B2, 0x00B3, 0x00B4, 0x00B5, 0x00B6, 0x00B7, 0x00B8,
+    0x00B9, 0x00BA, 0x00BB, 0x00BC, 0x00BD, 0x00BE, 0x00BF, 0x00C0, 0x00C1, 0x00C2, 0x00C3, 0x00C4,
+    0x00C5, 0x00C6, 0x00C7, 0x00C8, 0x00C9, 0x00CA, 0x00CB, 0x00CC, 0x00CD, 0x00CE, 0x00CF, 0x00D0,
+    0x00D1, 0x00D2, 0x00D3, 0x00D4, 0x00D5, 0x00D6, 0x00D7, 0x00D8, 0x00D9, 0x00DA, 0x00DB, 0x00DC,
+    0x00DD, 0x00DE, 0x00DF, 0x00E0, 0x00E1, 0x00E2, 0x00E3, 0x00E4, 0x00E5, 0x00E6, 0x00E7, 0x00E8,
+    0x00E9, 0x00EA, 0x00EB, 0x00EC, 0x00ED, 0x00EE, 0x00EF, 0x00F0, 0x00F1, 0x00F2, 0x00F3, 0x00F4,
+    0x00F5, 0x00F6, 0x00F7, 0x00F8, 0x00F9, 0x00FA, 0x00FB, 0x00FC, 0x00FD, 0x00FE, 0x00FF, 0x0100,
+    0x0101, 0x0102, 0x0103, 0x0104, 0x0105, 0x0106, 0x0107, 0x0108, 0x0109, 0x010A, 0x010B, 0x010C,
+    0x010D, 0x010E, 0x010F, 0x0110, 0x0111, 0x0112, 0x0113, 0x0114, 0x0115, 0x0116, 0x0117, 0x0118,
+    0x0119, 0x011A, 0x011B, 0x011C, 0x011D, 0x011E, 0x011F, 0x0120, 0x0121, 0x0122, 0x0123, 0x0124,
+    0x0125, 0x0126, 0x0127, 0x0128, 0x0129, 0x012A, 0x012B, 0x012C, 0x012D, 0x012E, 0x012F, 0x0130,
+    0x0131, 0x0132, 0x0133, 0x0134, 0x0135, 0x0136, 0x0137, 0x0138, 0x0139, 0x013A, 0x013B, 0x013C,
+    0x013D, 0x013E, 0x013F, 0x0140, 0x0141, 0x0142, 0x0143, 0x0144, 0x0145, 0x0146, 0x0147, 0x0148,
+    0x0149, 0x014A, 0x014B, 0x014C, 0x014D, 0x014E, 0x014F, 0x0150, 0x0151, 0x0152, 0x0153, 0x0154,
+    0x0155, 0x0156, 0x0157, 0x0158, 0x0159, 0x015A, 0x015B, 0x015C, 0x015D, 0x015E, 0x015F, 0x0160,
+    0x0161, 0x0162, 0x0163, 0x0164, 0x0165, 0x0166, 0x0167, 0x0168, 0x0169, 0x016A, 0x016B, 0x016C,
+    0x016D, 0x016E, 0x016F, 0x0170, 0x0171, 0x0172, 0x0173, 0x0174, 0x0175, 0x0176, 0x0177, 0x0178,
+    0x0179, 0x017A, 0x017B, 0x017C, 0x017D, 0x017E, 0x017F, 0x2010, 0x2011, 0x2012, 0x2013, 0x2014,
+    0x2015, 0x2017, 0x2018, 0x2019, 0x201A, 0x201C, 0x201D, 0x201E, 0x2022, 0x2024, 0x2025, 0x2026,
+    0x202F, 0x2039, 0x203A, 0x20AC, 0x2122,
+};
+static constexpr uint8_t kFoldTo[kFoldCount][3] = {
+    {0x00, 0xFF, 0xFF}, {0x01, 0xFF, 0xFF}, {0x43, 0xFF, 0xFF}, {0x2C, 0xFF, 0xFF}, {0x39, 0xFF, 0xFF}, {0x5C, 0xFF, 0xFF},
+    {0x33, 0xFF, 0xFF}, {0x02, 0xFF, 0xFF}, {0x08, 0x43, 0x09}, {0x41, 0xFF, 0xFF}, {0x1C, 0x1C, 0xFF}, {0x0D, 0xFF, 0xFF},
+    {0xFF, 0xFF, 0xFF}, {0x08, 0x32, 0x09}, {0x0D, 0xFF, 0xFF}, {0xFF, 0xFF, 0xFF}, {0x0B, 0x0D, 0xFF}, {0x12, 0xFF, 0xFF},
+    {0x13, 0xFF, 0xFF}, {0x07, 0xFF, 0xFF}, {0x55, 0xFF, 0xFF}, {0x30, 0xFF, 0xFF}, {0x0E, 0xFF, 0xFF}, {0x0C, 0xFF, 0xFF},
+    {0x11, 0xFF, 0xFF}, {0x4F, 0xFF, 0xFF}, {0x1E, 0x1E, 0xFF}, {0x11, 0x0F, 0x14}, {0x11, 0x0F, 0x12}, {0x13, 0x0F, 0x14},
+    {0x1F, 0xFF, 0xFF}, {0x21, 0xFF, 0xFF}, {0x21, 0xFF, 0xFF}, {0x21, 0xFF, 0xFF}, {0x21, 0xFF, 0xFF}, {0x21, 0xFF, 0xFF},
+    {0x21, 0xFF, 0xFF}, {0x21, 0x25, 0xFF}, {0x23, 0xFF, 0xFF}, {0x25, 0xFF, 0xFF}, {0x25, 0xFF, 0xFF}, {0x25, 0xFF, 0xFF},
+    {0x25, 0xFF, 0xFF}, {0x29, 0xFF, 0xFF}, {0x29, 0xFF, 0xFF}, {0x29, 0xFF, 0xFF}, {0x29, 0xFF, 0xFF}, {0x24, 0xFF, 0xFF},
+    {0x2E, 0xFF, 0xFF}, {0x2F, 0xFF, 0xFF}, {0x2F, 0xFF, 0xFF}, {0x2F, 0xFF, 0xFF}, {0x2F, 0xFF, 0xFF}, {0x2F, 0xFF, 0xFF},
+    {0x58, 0xFF, 0xFF}, {0x2F, 0xFF, 0xFF}, {0x35, 0xFF, 0xFF}, {0x35, 0xFF, 0xFF}, {0x35, 0xFF, 0xFF}, {0x35, 0xFF, 0xFF},
+    {0x39, 0xFF, 0xFF}, {0x34, 0x48, 0xFF}, {0x53, 0x53, 0xFF}, {0x41, 0xFF, 0xFF}, {0x41, 0xFF, 0xFF}, {0x41, 0xFF, 0xFF},
+    {0x41, 0xFF, 0xFF}, {0x41, 0xFF, 0xFF}, {0x41, 0xFF, 0xFF}, {0x41, 0x45, 0xFF}, {0x43, 0xFF, 0xFF}, {0x45, 0xFF, 0xFF},
+    {0x45, 0xFF, 0xFF}, {0x45, 0xFF, 0xFF}, {0x45, 0xFF, 0xFF}, {0x49, 0xFF, 0xFF}, {0x49, 0xFF, 0xFF}, {0x49, 0xFF, 0xFF},
+    {0x49, 0xFF, 0xFF}, {0x44, 0xFF, 0xFF}, {0x4E, 0xFF, 0xFF}, {0x4F, 0xFF, 0xFF}, {0x4F, 0xFF, 0xFF}, {0x4F, 0xFF, 0xFF},
+    {0x4F, 0xFF, 0xFF}, {0x4F, 0xFF, 0xFF}, {0x0F, 0xFF, 0xFF}, {0x4F, 0xFF, 0xFF}, {0x55, 0xFF, 0xFF}, {0x55, 0xFF, 0xFF},
+    {0x55, 0xFF, 0xFF}, {0x55, 0xFF, 0xFF}, {0x59, 0xFF, 0xFF}, {0x54, 0x48, 0xFF}, {0x59, 0xFF, 0xFF}, {0x21, 0xFF, 0xFF},
+    {0x41, 0xFF, 0xFF}, {0x21, 0xFF, 0xFF}, {0x41, 0xFF, 0xFF}, {0x21, 0xFF, 0xFF}, {0x41, 0xFF, 0xFF}, {0x23, 0xFF, 0xFF},
+    {0x43, 0xFF, 0xFF}, {0x23, 0xFF, 0xFF}, {0x43, 0xFF, 0xFF}, {0x23, 0xFF, 0xFF}, {0x43, 0xFF, 0xFF}, {0x23, 0xFF, 0xFF},
+    {0x43, 0xFF, 0xFF}, {0x24, 0xFF, 0xFF}, {0x44, 0xFF, 0xFF}, {0x24, 0xFF, 0xFF}, {0x44, 0xFF, 0xFF}, {0x25, 0xFF, 0xFF},
+    {0x45, 0xFF, 0xFF}, {0x25, 0xFF, 0xFF}, {0x45, 0xFF, 0xFF}, {0x25, 0xFF, 0xFF}, {0x45, 0xFF, 0xFF}, {0x25, 0xFF, 0xFF},
+    {0x45, 0xFF, 0xFF}, {0x25, 0xFF, 0xFF}, {0x45, 0xFF, 0xFF}, {0x27, 0xFF, 0xFF}, {0x47, 0xFF, 0xFF}, {0x27, 0xFF, 0xFF},
+    {0x47, 0xFF, 0xFF}, {0x27, 0xFF, 0xFF}, {0x47, 0xFF, 0xFF}, {0x27, 0xFF, 0xFF}, {0x47, 0xFF, 0xFF}, {0x28, 0xFF, 0xFF},
+    {0x48, 0xFF, 0xFF}, {0x28, 0xFF, 0xFF}, {0x48, 0xFF, 0xFF}, {0x29, 0xFF, 0xFF}, {0x49, 0xFF, 0xFF}, {0x29, 0xFF, 0xFF},
+    {0x49, 0xFF, 0xFF}, {0x29, 0xFF, 0xFF}, {0x49, 0xFF, 0xFF}, {0x29, 0xFF, 0xFF}, {0x49, 0xFF, 0xFF}, {0x29, 0xFF, 0xFF},
+    {0x49, 0xFF, 0xFF}, {0x29, 0x2A, 0xFF}, {0x49, 0x4A, 0xFF}, {0x2A, 0xFF, 0xFF}, {0x4A, 0xFF, 0xFF}, {0x2B, 0xFF, 0xFF},
+    {0x4B, 0xFF, 0xFF}, {0x4B, 0xFF, 0xFF}, {0x2C, 0xFF, 0xFF}, {0x4C, 0xFF, 0xFF}, {0x2C, 0xFF, 0xFF}, {0x4C, 0xFF, 0xFF},
+    {0x2C, 0xFF, 0xFF}, {0x4C, 0xFF, 0xFF}, {0x2C, 0xFF, 0xFF}, {0x4C, 0xFF, 0xFF}, {0x2C, 0xFF, 0xFF}, {0x4C, 0xFF, 0xFF},
+    {0x2E, 0xFF, 0xFF}, {0x4E, 0xFF, 0xFF}, {0x2E, 0xFF, 0xFF}, {0x4E, 0xFF, 0xFF}, {0x2E, 0xFF, 0xFF}, {0x4E, 0xFF, 0xFF},
+    {0x07, 0x4E, 0xFF}, {0x2E, 0xFF, 0xFF}, {0x4E, 0xFF, 0xFF}, {0x2F, 0xFF, 0xFF}, {0x4F, 0xFF, 0xFF}, {0x2F, 0xFF, 0xFF},
+    {0x4F, 0xFF, 0xFF}, {0x2F, 0xFF, 0xFF}, {0x4F, 0xFF, 0xFF}, {0x2F, 0x25, 0xFF}, {0x4F, 0x45, 0xFF}, {0x32, 0xFF, 0xFF},
+    {0x52, 0xFF, 0xFF}, {0x32, 0xFF, 0xFF}, {0x52, 0xFF, 0xFF}, {0x32, 0xFF, 0xFF}, {0x52, 0xFF, 0xFF}, {0x33, 0xFF, 0xFF},
+    {0x53, 0xFF, 0xFF}, {0x33, 0xFF, 0xFF}, {0x53, 0xFF, 0xFF}, {0x33, 0xFF, 0xFF}, {0x53, 0xFF, 0xFF}, {0x33, 0xFF, 0xFF},
+    {0x53, 0xFF, 0xFF}, {0x34, 0xFF, 0xFF}, {0x54, 0xFF, 0xFF}, {0x34, 0xFF, 0xFF}, {0x54, 0xFF, 0xFF}, {0x34, 0xFF, 0xFF},
+    {0x54, 0xFF, 0xFF}, {0x35, 0xFF, 0xFF}, {0x55, 0xFF, 0xFF}, {0x35, 0xFF, 0xFF}, {0x55, 0xFF, 0xFF}, {0x35, 0xFF, 0xFF},
+    {0x55, 0xFF, 0xFF}, {0x35, 0xFF, 0xFF}, {0x55, 0xFF, 0xFF}, {0x35, 0xFF, 0xFF}, {0x55, 0xFF, 0xFF}, {0x35, 0xFF, 0xFF},
+    {0x55, 0xFF, 0xFF}, {0x37, 0xFF, 0xFF}, {0x57, 0xFF, 0xFF}, {0x39, 0xFF, 0xFF}, {0x59, 0xFF, 0xFF}, {0x39, 0xFF, 0xFF},
+    {0x3A, 0xFF, 0xFF}, {0x5A, 0xFF, 0xFF}, {0x3A, 0xFF, 0xFF}, {0x5A, 0xFF, 0xFF}, {0x3A, 0xFF, 0xFF}, {0x5A, 0xFF, 0xFF},
+    {0x53, 0xFF, 0xFF}, {0x0D, 0xFF, 0xFF}, {0x0D, 0xFF, 0xFF}, {0x0D, 0xFF, 0xFF}, {0x0D, 0xFF, 0xFF}, {0x0D, 0xFF, 0xFF},
+    {0x0D, 0xFF, 0xFF}, {0x00, 0xFF, 0xFF}, {0x07, 0xFF, 0xFF}, {0x07, 0xFF, 0xFF}, {0x0C, 0xFF, 0xFF}, {0x02, 0xFF, 0xFF},
+    {0x02, 0xFF, 0xFF}, {0x02, 0xFF, 0xFF}, {0x0A, 0xFF, 0xFF}, {0x0E, 0xFF, 0xFF}, {0x0E, 0x0E, 0xFF}, {0x5F, 0xFF, 0xFF},
+    {0x00, 0xFF, 0xFF}, {0x1C, 0xFF, 0xFF}, {0x1E, 0xFF, 0xFF}, {0x25, 0x35, 0x32}, {0x34, 0x2D, 0xFF},
+};
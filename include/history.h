@@ -0,0 +1,76 @@
+// -----------------------------------------------------------------------------
+// Historique en RAM: anneau de créneaux à durée fixe (CPU moyen/max, RAM %)
+// Alimenté par les échantillons reçus et, après reconnexion, par le backlog
+// {"t":"hist"} que le bridge extrait de son journal. Mémoire fixe: N * 3 octets.
+// -----------------------------------------------------------------------------
+#pragma once
+#include <stdint.h>
+
+struct HistSlot {
+  static const uint8_t kEmpty = 0xFF;
+  uint8_t cpu = kEmpty;     // moyenne 0..100
+  uint8_t cpuMax = kEmpty;  // pic 0..100
+  uint8_t ram = kEmpty;     // 0..100
+  bool empty() const { return cpu == kEmpty; }
+};
+
+template <uint16_t N, uint32_t SLOT_MS>
+class SlotHistory {
+ public:
+  static const uint16_t kSlots = N;
+  static const uint32_t kSlotMs = SLOT_MS;
+
+  // Échantillon courant; clôt les créneaux écoulés (vides si trou de données)
+  void add(uint32_t now, float cpu, float ramPct) {
+    roll(now);
+    if (cpu >= 0) { cpuSum_ += cpu; if (cpu > cpuMax_) cpuMax_ = cpu; cpuN_++; }
+    if (ramPct >= 0) { ramSum_ += ramPct; ramN_++; }
+  }
+
+  // Âge 0 = dernier créneau clos, N-1 = le plus ancien
+  const HistSlot &at(uint16_t age) const { return slots_[(head_ + N - 1 - age) % N]; }
+
+  // Remplace un créneau clos (backlog hôte); âge hors de l'anneau ignoré
+  void set(uint16_t age, uint8_t cpu, uint8_t cpuMax, uint8_t ram) {
+    if (age >= N) return;
+    HistSlot &s = slots_[(head_ + N - 1 - age) % N];
+    s.cpu = cpu; s.cpuMax = cpuMax; s.ram = ram;
+    version_++;
+  }
+
+  // Incrémenté à chaque modification: permet aux vues de ne redessiner qu'au besoin
+  uint16_t version() const { return version_; }
+
+  void roll(uint32_t now) {
+    if (!started_) { started_ = true; slotStart_ = now; return; }
+    uint16_t guard = 0;
+    while ((uint32_t)(now - slotStart_) >= SLOT_MS && guard++ <= N) {
+      push();
+      slotStart_ += SLOT_MS;
+    }
+    if (guard > N) slotStart_ = now; // très long trou: on repart de maintenant
+  }
+
+ private:
+  void push() {
+    HistSlot &s = slots_[head_];
+    if (cpuN_) {
+      s.cpu = (uint8_t)(cpuSum_ / cpuN_ + 0.5f);
+      s.cpuMax = (uint8_t)(cpuMax_ + 0.5f);
+    } else {
+      s.cpu = s.cpuMax = HistSlot::kEmpty;
+    }
+    s.ram = ramN_ ? (uint8_t)(ramSum_ / ramN_ + 0.5f) : HistSlot::kEmpty;
+    head_ = (head_ + 1) % N;
+    cpuSum_ = ramSum_ = 0; cpuMax_ = 0; cpuN_ = ramN_ = 0;
+    version_++;
+  }
+
+  HistSlot slots_[N];
+  uint16_t head_ = 0;         // prochain créneau à écrire (= plus ancien)
+  uint16_t version_ = 0;
+  bool started_ = false;
+  uint32_t slotStart_ = 0;
+  float cpuSum_ = 0, cpuMax_ = 0, ramSum_ = 0;
+  uint32_t cpuN_ = 0, ramN_ = 0;  // un créneau de 60 s dépasse 65535 lignes en rafale
+};
@@ -0,0 +1,118 @@
+// -----------------------------------------------------------------------------
+// Frames rendues par l'hôte ({"t":"fb"}): le bridge dessine toute l'interface
+// 128x64 dans la disposition des pages du SH1106 et n'envoie que les pages
+// modifiées, compressées en PackBits puis écrites en hexadécimal:
+//   {"t":"fb","s":<seq>,"k":1?,"e":1?,"p":[[page,"hex"],...]}
+// Une frame peut tenir sur plusieurs lignes (même s, "e" sur la dernière).
+// Les pages sont copiées telles quelles dans le framebuffer de l'écran, puis
+// commit() n'envoie que les colonnes qui changent.
+//
+// Une frame delta ne vaut que si le framebuffer contient la précédente: s doit
+// suivre la dernière frame complète, sinon (ligne perdue, rendu local entre
+// deux, reset) on attend une keyframe ("k", toutes les pages) et on la
+// demande. Sans frame depuis timeoutMs, le rendu local reprend.
+// -----------------------------------------------------------------------------
+#pragma once
+#include <stdint.h>
+#include "time_source.h"
+
+static inline int hexNibble(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+// PackBits en hexadécimal -> exactement n octets dans out; false si la donnée
+// est mal formée ou ne fait pas n octets (out peut alors être entamé)
+static inline bool unpackHexPackBits(const char *hex, uint8_t *out, uint16_t n) {
+  uint16_t o = 0;
+  auto next = [&hex](int &v) -> bool {
+    const int hi = hexNibble(hex[0]);
+    if (hi < 0) return false;
+    const int lo = hexNibble(hex[1]);
+    if (lo < 0) return false;
+    v = (hi << 4) | lo;
+    hex += 2;
+    return true;
+  };
+  int h, b;
+  while (next(h)) {
+    if (h < 128) { // h + 1 octets littéraux
+      if (o + h + 1 > n) return false;
+      for (int i = 0; i <= h; i++) {
+        if (!next(b)) return false;
+        out[o++] = (uint8_t)b;
+      }
+    } else if (h > 128) { // octet suivant répété 257 - h fois
+      if (o + 257 - h > n || !next(b)) return false;
+      for (int i = 0; i < 257 - h; i++) out[o++] = (uint8_t)b;
+    }
+  }
+  return *hex == 0 && o == n;
+}
+
+class HostFrameSink {
+ public:
+  explicit HostFrameSink(uint16_t timeoutMs) : timeoutMs_(timeoutMs) {}
+
+  // Première ligne d'une frame ou suite de la frame ouverte? false: frame
+  // inapplicable (delta sans base), il faut une keyframe
+  bool open(uint16_t seq, bool key) {
+    if (open_ && seq == cur_) return true;
+    if (!key && !(synced_ && seq == (uint16_t)(last_ + 1))) { drop(); gaps++; return false; }
+    open_ = true;
+    cur_ = seq;
+    return true;
+  }
+
+  // Page décodée dans le framebuffer (ou non: tout est à refaire)
+  void page(bool ok) {
+    if (ok) pages++;
+    else { drop(); bad++; }
+  }
+
+  // Dernière ligne de la frame: true si elle est complète (à afficher), l'accusé
+  // partira quand l'écran sera à jour
+  bool close(uint32_t now) {
+    if (!open_) return false;
+    open_ = false;
+    synced_ = true;
+    last_ = cur_;
+    lastMs_ = now;
+    ackDue_ = true;
+    wantKey_ = keyAsked_ = false;
+    frames++;
+    return true;
+  }
+
+  // L'écran montre les frames de l'hôte; faux après timeoutMs sans frame, et
+  // alors le rendu local écrase le framebuffer: retour par une keyframe
+  bool active(uint32_t now) {
+    if (synced_ && msSince(now, lastMs_) > (int32_t)timeoutMs_) { drop(); fallbacks++; }
+    return synced_;
+  }
+
+  // Accusé de la dernière frame à envoyer une fois ses pages sur l'écran
+  bool takeAck() { bool a = ackDue_; ackDue_ = false; return a; }
+  // Demande de keyframe, au plus une par intervalle
+  bool takeKeyRequest(uint32_t now, uint16_t everyMs) {
+    if (!wantKey_ || (keyAsked_ && msSince(now, keyAskedMs_) < (int32_t)everyMs)) return false;
+    keyAsked_ = true;
+    keyAskedMs_ = now;
+    return true;
+  }
+  uint16_t last() const { return last_; }
+
+  uint32_t frames = 0, pages = 0;
+  uint32_t gaps = 0, bad = 0, fallbacks = 0;
+
+ private:
+  void drop() { open_ = synced_ = ackDue_ = false; wantKey_ = true; }
+
+  const uint16_t timeoutMs_;
+  uint16_t cur_ = 0, last_ = 0;
+  uint32_t lastMs_ = 0, keyAskedMs_ = 0;
+  bool open_ = false, synced_ = false, ackDue_ = false;
+  bool wantKey_ = false, keyAsked_ = false;
+};
@@ -0,0 +1,270 @@
+// -----------------------------------------------------------------------------
+// Lecture JSON sans document: un curseur sur la ligne, une seule passe
+// Sert au chemin rapide des instantanés (src/main.cpp). Les clés sont hachées
+// pendant leur lecture (FNV-1a à graine) et aiguillées par un switch dont les
+// étiquettes sont calculées à la compilation (JKEY); les nombres vont droit
+// dans leur champ. Tout écart (syntaxe, échappement exotique, nombre hors
+// format) fait échouer la lecture: l'appelant repasse alors par ArduinoJson.
+// -----------------------------------------------------------------------------
+#pragma once
+#include <stdint.h>
+#include <string.h>
+
+// Graine et largeur choisies pour que les clés du schéma tombent chacune dans
+// leur case; une collision ne compilerait pas (étiquettes de case en double)
+#define JSON_KEY_SEED 427u
+#define JSON_KEY_BITS 6
+#define JSON_MAX_DEPTH 8   // valeurs ignorées: imbrication au-delà -> échec
+
+static constexpr uint32_t jsonKeyStep(uint32_t h, uint8_t c) { return (h ^ c) * 16777619u; }
+static constexpr uint32_t jsonKeyHash(const char *s, uint32_t h = JSON_KEY_SEED) {
+  return *s ? jsonKeyHash(s + 1, jsonKeyStep(h, (uint8_t)*s)) : h;
+}
+static constexpr uint8_t jsonKeySlot(uint32_t h) { return (uint8_t)(h >> (32 - JSON_KEY_BITS)); }
+#define JKEY(s) jsonKeySlot(jsonKeyHash(s))
+
+// Chaîne décodée (au plus N-1 octets gardés), hachée sur toute sa longueur
+template <uint16_t N>
+struct JsonStr {
+  char s[N];
+  uint16_t len;     // octets gardés
+  uint32_t hash;
+  bool whole;       // rien de coupé
+  uint8_t slot() const { return jsonKeySlot(hash); }
+  bool is(const char *k) const { return whole && strlen(k) == len && !memcmp(s, k, len); }
+};
+
+// Nombre: valeur flottante, et entière si écrit sans fraction ni exposant
+// (ArduinoJson ne prend que ceux-là pour un champ entier)
+struct JsonNum {
+  float f;
+  int64_t i;
+  bool isInt;
+};
+
+class JsonScan {
+ public:
+  JsonScan(const char *s, uint16_t n) : p_(s), end_(s + n) {}
+
+  char peek() { ws(); return p_ < end_ ? *p_ : 0; }
+  bool eat(char c) {
+    if (peek() != c) return false;
+    p_++;
+    return true;
+  }
+  bool done() { ws(); return p_ == end_; }
+
+  // Objet: onMember(clé) pour chaque membre, qui doit consommer la valeur
+  template <class F>
+  bool object(F onMember) {
+    if (!eat('{')) return false;
+    if (eat('}')) return true;
+    do {
+      JsonStr<24> k;
+      if (!str(k) || !eat(':') || !onMember(k)) return false;
+    } while (eat(','));
+    return eat('}');
+  }
+
+  // Tableau: onItem() pour chaque élément, qui doit le consommer
+  template <class F>
+  bool array(F onItem) {
+    if (!eat('[')) return false;
+    if (eat(']')) return true;
+    do {
+      if (!onItem()) return false;
+    } while (eat(','));
+    return eat(']');
+  }
+
+  template <uint16_t N>
+  bool str(JsonStr<N> &out) { return str(out.s, N, out.len, out.hash, out.whole); }
+
+  // Chaîne: échappements et \uXXXX (paires de substitution comprises) décodés en UTF-8
+  bool str(char *out, uint16_t cap, uint16_t &len, uint32_t &hash, bool &whole) {
+    if (!eat('"')) return false;
+    len = 0; hash = JSON_KEY_SEED; whole = true;
+    while (p_ < end_) {
+      const uint8_t c = (uint8_t)*p_++;
+      if (c == '"') {
+        if (cap) out[len] = 0;
+        return true;
+      }
+      if (c < 0x20) return false;
+      if (c != '\\') { put(c, out, cap, len, hash, whole); continue; }
+      if (p_ >= end_) return false;
+      const char e = *p_++;
+      uint32_t cp;
+      switch (e) {
+        case '"': case '\\': case '/': cp = (uint8_t)e; break;
+        case 'b': cp = '\b'; break;
+        case 'f': cp = '\f'; break;
+        case 'n': cp = '\n'; break;
+        case 'r': cp = '\r'; break;
+        case 't': cp = '\t'; break;
+        case 'u':
+          if (!hex4(cp) || cp == 0 || (cp >= 0xDC00 && cp <= 0xDFFF)) return false;
+          if (cp >= 0xD800 && cp <= 0xDBFF) { // paire de substitution
+            uint32_t lo;
+            if (end_ - p_ < 6 || p_[0] != '\\' || p_[1] != 'u') return false;
+            p_ += 2;
+            if (!hex4(lo) || lo < 0xDC00 || lo > 0xDFFF) return false;
+            cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+          }
+          break;
+        default: return false;
+      }
+      if (cp < 0x80) put((uint8_t)cp, out, cap, len, hash, whole);
+      else if (cp < 0x800) {
+        put((uint8_t)(0xC0 | (cp >> 6)), out, cap, len, hash, whole);
+        put((uint8_t)(0x80 | (cp & 0x3F)), out, cap, len, hash, whole);
+      } else if (cp < 0x10000) {
+        put((uint8_t)(0xE0 | (cp >> 12)), out, cap, len, hash, whole);
+        put((uint8_t)(0x80 | ((cp >> 6) & 0x3F)), out, cap, len, hash, whole);
+        put((uint8_t)(0x80 | (cp & 0x3F)), out, cap, len, hash, whole);
+      } else {
+        put((uint8_t)(0xF0 | (cp >> 18)), out, cap, len, hash, whole);
+        put((uint8_t)(0x80 | ((cp >> 12) & 0x3F)), out, cap, len, hash, whole);
+        put((uint8_t)(0x80 | ((cp >> 6) & 0x3F)), out, cap, len, hash, whole);
+        put((uint8_t)(0x80 | (cp & 0x3F)), out, cap, len, hash, whole);
+      }
+    }
+    return false;
+  }
+
+  // Nombre JSON strict; mantisse sur 18 chiffres significatifs, puissance de 10 en float
+  bool num(JsonNum &n) {
+    ws();
+    const bool neg = p_ < end_ && *p_ == '-';
+    if (neg) p_++;
+    if (p_ >= end_ || !digit(*p_)) return false;
+    if (*p_ == '0' && p_ + 1 < end_ && digit(p_[1])) return false; // zéro en tête
+    uint64_t m = 0;
+    int16_t e = 0;
+    bool isInt = true;
+    for (; p_ < end_ && digit(*p_); p_++) {
+      if (m < 100000000000000000ULL) m = m * 10 + (uint64_t)(*p_ - '0');
+      else { e++; isInt = false; } // trop grand pour un entier: flottant, comme ArduinoJson
+    }
+    if (p_ < end_ && *p_ == '.') {
+      p_++;
+      isInt = false;
+      if (p_ >= end_ || !digit(*p_)) return false;
+      for (; p_ < end_ && digit(*p_); p_++)
+        if (m < 100000000000000000ULL) { m = m * 10 + (uint64_t)(*p_ - '0'); e--; }
+    }
+    if (p_ < end_ && (*p_ == 'e' || *p_ == 'E')) {
+      p_++;
+      isInt = false;
+      const bool eneg = p_ < end_ && *p_ == '-';
+      if (p_ < end_ && (*p_ == '-' || *p_ == '+')) p_++;
+      if (p_ >= end_ || !digit(*p_)) return false;
+      int16_t x = 0;
+      for (; p_ < end_ && digit(*p_); p_++) if (x < 1000) x = (int16_t)(x * 10 + (*p_ - '0'));
+      e = (int16_t)(eneg ? e - x : e + x);
+    }
+    if (e > 38 || e < -45) return false;
+    float f = (float)m;
+    if (e > 0) f *= pow10(e);
+    else if (e < 0) f = -e > 38 ? f / pow10(38) / pow10(-e - 38) : f / pow10(-e);
+    n.f = neg ? -f : f;
+    n.i = neg ? -(int64_t)m : (int64_t)m;
+    n.isInt = isInt;
+    return true;
+  }
+
+  // Lecteurs de champ: la cible ne change que si la valeur a le bon type (sinon
+  // elle est ignorée, comme "doc[k] | défaut"); set: mis à true si elle change
+  bool f32(float &dst, bool *set = nullptr) {
+    if (!numAhead()) return skip();
+    JsonNum n;
+    if (!num(n)) return false;
+    dst = n.f;
+    if (set) *set = true;
+    return true;
+  }
+  bool i32(int32_t &dst, bool *set = nullptr) {
+    if (!numAhead()) return skip();
+    JsonNum n;
+    if (!num(n)) return false;
+    if (n.isInt && n.i >= INT32_MIN && n.i <= INT32_MAX) {
+      dst = (int32_t)n.i;
+      if (set) *set = true;
+    }
+    return true;
+  }
+  bool u32(uint32_t &dst, bool *set = nullptr) {
+    if (!numAhead()) return skip();
+    JsonNum n;
+    if (!num(n)) return false;
+    if (n.isInt && n.i >= 0 && n.i <= (int64_t)UINT32_MAX) {
+      dst = (uint32_t)n.i;
+      if (set) *set = true;
+    }
+    return true;
+  }
+
+  // Valeur quelconque, sans la garder
+  bool skip(uint8_t depth = 0) {
+    switch (peek()) {
+      case '"': {
+        uint16_t len;
+        uint32_t hash;
+        bool whole;
+        return str(nullptr, 0, len, hash, whole);
+      }
+      case '{': return depth < JSON_MAX_DEPTH && object([this, depth](JsonStr<24> &) { return skip((uint8_t)(depth + 1)); });
+      case '[': return depth < JSON_MAX_DEPTH && array([this, depth]() { return skip((uint8_t)(depth + 1)); });
+      case 't': return lit("true");
+      case 'f': return lit("false");
+      case 'n': return lit("null");
+      default: {
+        JsonNum n;
+        return num(n);
+      }
+    }
+  }
+
+ private:
+  static bool digit(char c) { return c >= '0' && c <= '9'; }
+  bool numAhead() { const char c = peek(); return c == '-' || digit(c); }
+
+  void ws() {
+    while (p_ < end_ && (*p_ == ' ' || *p_ == '\t' || *p_ == '\n' || *p_ == '\r')) p_++;
+  }
+
+  bool lit(const char *w) {
+    const size_t n = strlen(w);
+    if ((size_t)(end_ - p_) < n || memcmp(p_, w, n)) return false;
+    p_ += n;
+    return true;
+  }
+
+  bool hex4(uint32_t &v) {
+    if (end_ - p_ < 4) return false;
+    v = 0;
+    for (uint8_t i = 0; i < 4; i++) {
+      const char c = *p_++;
+      const int d = c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10 : c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1;
+      if (d < 0) return false;
+      v = (v << 4) | (uint32_t)d;
+    }
+    return true;
+  }
+
+  static void put(uint8_t c, char *out, uint16_t cap, uint16_t &len, uint32_t &hash, bool &whole) {
+    hash = jsonKeyStep(hash, c);
+    if (len + 1 < cap) out[len++] = (char)c;
+    else whole = false;
+  }
+
+  static float pow10(int16_t e) { // 0 <= e <= 38
+    static const float k[] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+    float r = 1;
+    while (e > 10) { r *= 1e10f; e -= 10; }
+    return r * k[e];
+  }
+
+  const char *p_;
+  const char *const end_;
+};
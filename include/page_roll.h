@@ -0,0 +1,88 @@
+// -----------------------------------------------------------------------------
+// Transition de page par la ligne de départ du SH1106 (1 bit, pages de 8 lignes)
+// La RAM de l'écran ne contient qu'une image (64 lignes, 132 colonnes dont 4
+// hors champ): pas de place pour une page entière hors de l'écran. On la fait
+// donc défiler: à l'étape k, la ligne de départ vaut k et l'écran montre les
+// lignes k..63 de la page sortante puis, en bas, les lignes 0..k-1 de RAM, qui
+// ont déjà reçu la page entrante. Chaque étape coûte une commande de 2 octets
+// plus les colonnes modifiées des bandes que la frontière a traversées: la page
+// entrante est écrite une fois, au fil du défilement, au lieu d'une image
+// complète par frame. À k = 64 la ligne de départ revient à 0 sur la nouvelle page.
+//
+// La composition se fait dans le framebuffer de l'écran (image de sa RAM);
+// commit() et le flusher n'envoient que ce qui change. La ligne de départ ne
+// part qu'une fois ces bandes sur l'écran (takeLine()).
+// -----------------------------------------------------------------------------
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include "time_source.h"
+
+template <uint16_t W, uint16_t H>
+class PageRoll {
+ public:
+  static const uint16_t kBytes = W * H / 8;
+
+  explicit PageRoll(uint16_t durationMs) : durationMs_(durationMs) {}
+
+  // from: image à l'écran (ligne de départ 0); retourne le tampon où dessiner la page entrante
+  uint8_t *begin(const uint8_t *from, uint32_t now) {
+    memcpy(from_, from, kBytes);
+    t0_ = now;
+    rows_ = 0;
+    active_ = true;
+    lineDue_ = false;
+    return to_;
+  }
+
+  // Étape suivante dans fb si la précédente est affichée; true: fb à commit()
+  bool step(uint32_t now, uint8_t *fb) {
+    if (!active_ || lineDue_) return false;
+    const int32_t el = msSince(now, t0_);
+    float t = el <= 0 ? 0 : (float)el / durationMs_;
+    if (t > 1) t = 1;
+    uint16_t rows = (uint16_t)(H * t * t * (3 - 2 * t) + 0.5f); // départ et arrivée en douceur
+    if (rows <= rows_) rows = (uint16_t)(rows_ + 1);
+    rows_ = rows;
+    compose(fb);
+    lineDue_ = true;
+    return true;
+  }
+
+  // Ligne de départ à envoyer, une fois les bandes de l'étape sur l'écran; la
+  // dernière (0) termine la transition
+  bool takeLine(uint8_t &line) {
+    if (!lineDue_) return false;
+    lineDue_ = false;
+    line = (uint8_t)(rows_ % H);
+    steps++;
+    if (rows_ >= H) active_ = false;
+    return true;
+  }
+
+  // Abandon (frames de l'hôte): l'appelant remet la ligne de départ à 0
+  void cancel() { active_ = lineDue_ = false; }
+  bool active() const { return active_; }
+
+  uint32_t steps = 0;
+
+ private:
+  // Lignes [0, rows_) de la page entrante, [rows_, H) de la sortante
+  void compose(uint8_t *fb) const {
+    for (uint16_t b = 0; b < H / 8; b++) {
+      const uint16_t row = b * 8, at = b * W;
+      if (rows_ >= row + 8) memcpy(fb + at, to_ + at, W);
+      else if (rows_ <= row) memcpy(fb + at, from_ + at, W);
+      else {
+        const uint8_t m = (uint8_t)((1u << (rows_ - row)) - 1);
+        for (uint16_t x = 0; x < W; x++) fb[at + x] = (uint8_t)((to_[at + x] & m) | (from_[at + x] & ~m));
+      }
+    }
+  }
+
+  const uint16_t durationMs_;
+  uint8_t from_[kBytes], to_[kBytes];
+  uint32_t t0_ = 0;
+  uint16_t rows_ = 0;
+  bool active_ = false, lineDue_ = false;
+};
@@ -0,0 +1,199 @@
+// -----------------------------------------------------------------------------
+// Écrans partageant un bus I2C
+// Chaque écran garde une copie de ce qu'il affiche et, à chaque commit(), ne
+// marque que les bandes (pages de 8 lignes) qui en diffèrent; seules leurs
+// colonnes modifiées sont envoyées. FlushScheduler pousse ces bandes par
+// tranches de temps de bus entre deux passages de loop(), en entrelaçant les
+// écrans: priorité d'abord, mais un écran dont l'échéance est dépassée passe
+// avant (la plus ancienne en premier), si bien qu'aucun n'est affamé.
+//
+//   PagedSH1106<W, H>    SH1106 1 bit (ce fichier), ligne de départ pour les
+//                        transitions de page (include/page_roll.h)
+//   BandedSSD1327<W, H>  SSD1327 4 bits (panel_ssd1327.h)
+// -----------------------------------------------------------------------------
+#pragma once
+#include <Adafruit_SH110X.h>
+#include <string.h>
+#include "time_source.h"
+
+// Partie commune: suivi des bandes sales, échéance, statistiques
+class FlushTarget {
+ public:
+  // priority: plus grand = servi d'abord; latencyMs: délai commit -> écran visé
+  FlushTarget(uint8_t bands, uint8_t priority, uint16_t latencyMs)
+      : all_(bands >= 32 ? 0xFFFFFFFFu : (1u << bands) - 1), bands_(bands), priority_(priority), latencyMs_(latencyMs) {}
+  virtual ~FlushTarget() {}
+
+  // Frame dessinée: marque les bandes modifiées depuis le dernier envoi
+  void commit(uint32_t now) {
+    frames_++;
+    uint32_t dirty = stale_;
+    for (uint8_t b = 0; b < bands_; b++) {
+      const uint32_t bit = 1u << b;
+      if (dirty & bit) continue;
+      if (bandChanged(b)) dirty |= bit;
+      else pagesSkipped++;
+    }
+    if (dirty && !pending_) since_ = now; // sinon l'échéance de la frame en retard est conservée
+    pending_ |= dirty;
+  }
+
+  // Envoi bloquant de tout ce qui est en attente (écran de démarrage)
+  void flushAll(uint32_t now) {
+    commit(now);
+    while (pending_) flushPage(now);
+  }
+
+  // Envoie la première bande en attente; retourne le temps de bus estimé (µs)
+  uint32_t flushPage(uint32_t now) {
+    uint8_t b = 0;
+    while (!(pending_ & (1u << b))) b++;
+    const uint32_t bit = 1u << b;
+    pending_ &= ~bit;
+    uint32_t us = sendBand(b, (stale_ & bit) != 0);
+    stale_ &= ~bit;
+    if (us) pagesWritten++;
+    else pagesSkipped++; // revenue à l'identique entre commit et envoi
+    if (!pending_) {
+      int32_t lag = msSince(now, since_);
+      if (lag > (int32_t)maxLagMs_) maxLagMs_ = (uint16_t)(lag > 0xFFFF ? 0xFFFF : lag);
+    }
+    return us;
+  }
+
+  bool pending() const { return pending_ != 0; }
+  uint32_t deadline() const { return since_ + latencyMs_; }
+  uint8_t priority() const { return priority_; }
+  uint16_t latencyMs() const { return latencyMs_; }
+  uint32_t frames() const { return frames_; }
+  // Pire délai commit -> écran à jour depuis le dernier appel
+  uint16_t takeMaxLag() { uint16_t l = maxLagMs_; maxLagMs_ = 0; return l; }
+
+  uint32_t pagesWritten = 0;
+  uint32_t pagesSkipped = 0;  // bandes inchangées, non envoyées
+
+ protected:
+  // RAM de l'écran inconnue (après begin()): la prochaine frame part en entier
+  void invalidate() { stale_ = all_; pending_ = 0; }
+  virtual bool bandChanged(uint8_t band) const = 0;
+  // Envoie la bande (en entier si full, sinon ses colonnes modifiées) et met la
+  // copie à jour; retourne le temps de bus estimé (µs), 0 si rien n'a changé
+  virtual uint32_t sendBand(uint8_t band, bool full) = 0;
+
+ private:
+  uint32_t pending_ = 0, stale_ = 0;  // une bande par bit, 32 au plus
+  const uint32_t all_;
+  const uint8_t bands_;
+  uint8_t priority_;
+  uint16_t latencyMs_;
+  uint16_t maxLagMs_ = 0;
+  uint32_t since_ = 0, frames_ = 0;
+};
+
+// Coût d'un transfert I2C: 8 bits + ACK par octet, adresse comprise
+static inline uint32_t i2cBusUs(uint32_t bytes, uint32_t hz) { return bytes * 9000000UL / hz; }
+
+template <uint16_t W, uint16_t H>
+class PagedSH1106 : public Adafruit_SH1106G, public FlushTarget {
+ public:
+  PagedSH1106(TwoWire *twi, int8_t rst, uint32_t hz, uint8_t priority, uint16_t latencyMs)
+      : Adafruit_SH1106G(W, H, twi, rst, hz), FlushTarget(H / 8, priority, latencyMs) {}
+
+  bool begin(uint8_t addr) {
+    if (!Adafruit_SH1106G::begin(addr, true)) return false;
+    invalidate();
+    startLine_ = 0;
+    return true;
+  }
+
+  // Ligne de RAM montrée en haut de l'écran (commande 0x40 | ligne): défilement
+  // vertical matériel en une commande; retourne le temps de bus estimé (µs)
+  uint32_t setStartLine(uint8_t line) {
+    line %= H;
+    if (line == startLine_) return 0;
+    uint8_t cmd[] = {0x00, (uint8_t)(0x40 | line)};
+    i2c_dev->setSpeed(i2c_preclk);
+    i2c_dev->write(cmd, sizeof(cmd));
+    i2c_dev->setSpeed(i2c_postclk);
+    startLine_ = line;
+    return i2cBusUs(1 + sizeof(cmd), i2c_preclk);
+  }
+  uint8_t startLine() const { return startLine_; }
+
+ protected:
+  bool bandChanged(uint8_t p) const override { return memcmp(buffer + p * W, shown_ + p * W, W) != 0; }
+
+  uint32_t sendBand(uint8_t p, bool full) override {
+    const uint8_t *src = buffer + p * W;
+    uint8_t *dst = shown_ + p * W;
+    uint16_t lo = 0, hi = W;
+    if (!full) {
+      while (lo < W && src[lo] == dst[lo]) lo++;
+      while (hi > lo && src[hi - 1] == dst[hi - 1]) hi--;
+      if (lo == hi) return 0;
+    }
+    const uint8_t col = (uint8_t)(lo + _page_start_offset);
+    uint8_t cmd[] = {0x00, (uint8_t)(SH110X_SETPAGEADDR + p), (uint8_t)(0x10 + (col >> 4)), (uint8_t)(col & 0xF)};
+    i2c_dev->setSpeed(i2c_preclk);
+    i2c_dev->write(cmd, sizeof(cmd));
+    uint32_t bytes = 1 + sizeof(cmd);
+    const uint8_t dc = 0x40;
+    const uint16_t maxData = (uint16_t)(i2c_dev->maxBufferSize() - 1);
+    for (uint16_t c = lo; c < hi;) {
+      uint16_t n = (uint16_t)(hi - c) < maxData ? (uint16_t)(hi - c) : maxData;
+      i2c_dev->write(src + c, n, true, &dc, 1);
+      bytes += 2 + n; // adresse + 0x40
+      c += n;
+    }
+    i2c_dev->setSpeed(i2c_postclk);
+    memcpy(dst + lo, src + lo, hi - lo);
+    return i2cBusUs(bytes, i2c_preclk);
+  }
+
+ private:
+  uint8_t shown_[W * H / 8] = {};
+  uint8_t startLine_ = 0;
+};
+
+template <uint8_t N>
+class FlushScheduler {
+ public:
+  bool attach(FlushTarget &panel) {
+    if (count_ >= N) return false;
+    panels_[count_++] = &panel;
+    return true;
+  }
+
+  // Envoie des bandes jusqu'à épuiser sliceUs de temps de bus (au moins une
+  // si quelque chose attend); retourne le temps de bus estimé consommé
+  uint32_t service(uint32_t now, uint32_t sliceUs) {
+    uint32_t spent = 0;
+    while (spent < sliceUs) {
+      FlushTarget *p = pick(now);
+      if (!p) break;
+      spent += p->flushPage(now);
+    }
+    return spent;
+  }
+
+ private:
+  FlushTarget *pick(uint32_t now) const {
+    FlushTarget *best = nullptr;
+    bool bestLate = false;
+    for (uint8_t i = 0; i < count_; i++) {
+      FlushTarget *p = panels_[i];
+      if (!p->pending()) continue;
+      bool late = reached(now, p->deadline());
+      if (!best || (late && !bestLate)) { best = p; bestLate = late; continue; }
+      if (late != bestLate) continue;
+      int32_t earlier = msSince(best->deadline(), p->deadline()); // > 0: p a l'échéance la plus proche
+      if (late ? earlier > 0
+               : (p->priority() > best->priority() || (p->priority() == best->priority() && earlier > 0)))
+        best = p;
+    }
+    return best;
+  }
+
+  FlushTarget *panels_[N] = {};
+  uint8_t count_ = 0;
+};
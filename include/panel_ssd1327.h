@@ -0,0 +1,78 @@
+// -----------------------------------------------------------------------------
+// SSD1327 128x128 en 16 niveaux (-D SMON_PANEL_SSD1327=1), même planificateur
+// que le SH1106 (panel.h). Le tampon fait 8 Ko (2 pixels par octet): un envoi
+// complet prend ~185 ms à 400 kHz, on n'envoie donc que la fenêtre modifiée de
+// chaque bande (commandes colonne 0x15 / ligne 0x75). Bandes de 4 lignes: 256
+// octets au plus, soit ~6 ms de bus, comparable à une page SH1106.
+// -----------------------------------------------------------------------------
+#pragma once
+#include <Adafruit_SSD1327.h>
+#include "panel.h"
+
+template <uint16_t W, uint16_t H>
+class BandedSSD1327 : public Adafruit_SSD1327, public FlushTarget {
+ public:
+  static const uint16_t kRowBytes = W / 2;
+  static const uint8_t kBandRows = 4;
+  static const uint16_t kBandBytes = kRowBytes * kBandRows;
+
+  BandedSSD1327(TwoWire *twi, int8_t rst, uint32_t hz, uint8_t priority, uint16_t latencyMs)
+      : Adafruit_SSD1327(W, H, twi, rst, hz), FlushTarget(H / kBandRows, priority, latencyMs) {}
+
+  bool begin(uint8_t addr) {
+    if (!Adafruit_SSD1327::begin(addr, true)) return false;
+    invalidate();
+    return true;
+  }
+
+ protected:
+  bool bandChanged(uint8_t b) const override {
+    return memcmp(buffer + b * kBandBytes, shown_ + b * kBandBytes, kBandBytes) != 0;
+  }
+
+  uint32_t sendBand(uint8_t b, bool full) override {
+    const uint8_t *src = buffer + b * kBandBytes;
+    uint8_t *dst = shown_ + b * kBandBytes;
+    // Fenêtre: colonnes d'octets modifiées sur la bande, lignes extrêmes modifiées
+    uint16_t lo = 0, hi = kRowBytes;
+    uint8_t r0 = 0, r1 = kBandRows;
+    if (!full) {
+      lo = kRowBytes; hi = 0; r0 = kBandRows; r1 = 0;
+      for (uint8_t r = 0; r < kBandRows; r++) {
+        const uint8_t *s = src + r * kRowBytes, *d = dst + r * kRowBytes;
+        uint16_t a = 0, z = kRowBytes;
+        while (a < z && s[a] == d[a]) a++;
+        if (a == z) continue;
+        while (s[z - 1] == d[z - 1]) z--;
+        if (a < lo) lo = a;
+        if (z > hi) hi = z;
+        if (r < r0) r0 = r;
+        r1 = (uint8_t)(r + 1);
+      }
+      if (lo >= hi) return 0;
+    }
+    const uint8_t y0 = (uint8_t)(b * kBandRows);
+    uint8_t cmd[] = {0x00, SSD1327_SETCOLUMN, (uint8_t)lo, (uint8_t)(hi - 1),
+                     SSD1327_SETROW, (uint8_t)(y0 + r0), (uint8_t)(y0 + r1 - 1)};
+    i2c_dev->setSpeed(i2c_preclk);
+    i2c_dev->write(cmd, sizeof(cmd));
+    uint32_t bytes = 1 + sizeof(cmd);
+    const uint8_t dc = 0x40;
+    const uint16_t maxData = (uint16_t)(i2c_dev->maxBufferSize() - 1);
+    for (uint8_t r = r0; r < r1; r++) {
+      const uint8_t *s = src + r * kRowBytes;
+      for (uint16_t c = lo; c < hi;) {
+        uint16_t n = (uint16_t)(hi - c) < maxData ? (uint16_t)(hi - c) : maxData;
+        i2c_dev->write(s + c, n, true, &dc, 1);
+        bytes += 2 + n;
+        c += n;
+      }
+      memcpy(dst + r * kRowBytes + lo, s + lo, hi - lo);
+    }
+    i2c_dev->setSpeed(i2c_postclk);
+    return i2cBusUs(bytes, i2c_preclk);
+  }
+
+ private:
+  uint8_t shown_[W * H / 2] = {};
+};
@@ -0,0 +1,182 @@
+// -----------------------------------------------------------------------------
+// Couche raster: primitives de remplissage écrites directement dans le
+// framebuffer de l'écran, spécialisées à la compilation par format de pixel et
+// géométrie. Jauges, cadres, visage et texte passent par ici (les glyphes de
+// font.h sont posés colonne par colonne par blit, sans drawPixel virtuel).
+//
+//   Mono1Page<W, H>  SH1106/SSD1306: 1 bit, pages de 8 lignes, bit 0 en haut
+//   Gray4<W, H>      SSD1327: 4 bits, lignes, 2 pixels par octet (x pair en
+//                    poids fort), comme le tampon d'Adafruit_SSD1327
+//
+// Une encre est un niveau 0..Fmt::kMax, ou kInvert. Les variantes "AA"
+// (bords fractionnaires, lignes de Wu) dégradent en tout-ou-rien sur 1 bit.
+// -----------------------------------------------------------------------------
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <stdlib.h>
+
+static const uint8_t kInvert = 0xFF;
+
+template <uint16_t W, uint16_t H>
+struct Mono1Page {
+  static const uint16_t kW = W, kH = H;
+  static const uint8_t kMax = 1;
+  static const uint32_t kBytes = (uint32_t)W * H / 8;
+
+  static uint8_t get(const uint8_t *buf, int x, int y) { return (buf[x + (y >> 3) * W] >> (y & 7)) & 1; }
+  static void put(uint8_t *b, uint8_t mask, uint8_t ink) {
+    if (ink == kInvert) *b ^= mask;
+    else if (ink) *b |= mask;
+    else *b &= (uint8_t)~mask;
+  }
+  static void pixel(uint8_t *buf, int x, int y, uint8_t ink) { put(&buf[x + (y >> 3) * W], (uint8_t)(1 << (y & 7)), ink); }
+
+  // Rectangle déjà découpé: une passe par page, masque vertical commun à toute la ligne d'octets
+  static void fill(uint8_t *buf, int x0, int y0, int x1, int y1, uint8_t ink) {
+    for (int p = y0 >> 3; p <= (y1 - 1) >> 3; p++) {
+      int a = p * 8 > y0 ? p * 8 : y0, b = p * 8 + 8 < y1 ? p * 8 + 8 : y1;
+      uint8_t mask = (uint8_t)((0xFF << (a & 7)) & (0xFF >> (8 - (((b - 1) & 7) + 1))));
+      uint8_t *row = buf + p * W;
+      if (mask == 0xFF && ink != kInvert) { memset(row + x0, ink ? 0xFF : 0x00, x1 - x0); continue; }
+      for (int x = x0; x < x1; x++) put(&row[x], mask, ink);
+    }
+  }
+
+  // Motif en colonnes déjà découpé: chaque colonne décalée tombe sur au plus deux pages
+  static void blit(uint8_t *buf, const uint8_t *cols, int w, int h, int x, int y, uint8_t ink) {
+    const uint8_t hmask = (uint8_t)(0xFF >> (8 - h));
+    const int p = y >> 3, s = y & 7;
+    for (int i = 0; i < w; i++) {
+      uint16_t m = (uint16_t)((cols[i] & hmask) << s);
+      if (m & 0xFF) put(&buf[x + i + p * W], (uint8_t)m, ink);
+      if (m >> 8) put(&buf[x + i + (p + 1) * W], (uint8_t)(m >> 8), ink);
+    }
+  }
+};
+
+template <uint16_t W, uint16_t H>
+struct Gray4 {
+  static const uint16_t kW = W, kH = H;
+  static const uint8_t kMax = 15;
+  static const uint32_t kBytes = (uint32_t)W * H / 2;
+
+  static uint8_t get(const uint8_t *buf, int x, int y) {
+    uint8_t b = buf[(x >> 1) + y * (W / 2)];
+    return (x & 1) ? (b & 0x0F) : (b >> 4);
+  }
+  static void pixel(uint8_t *buf, int x, int y, uint8_t ink) {
+    uint8_t &b = buf[(x >> 1) + y * (W / 2)];
+    const uint8_t shift = (x & 1) ? 0 : 4, mask = (uint8_t)(0x0F << shift);
+    if (ink == kInvert) b ^= mask;
+    else b = (uint8_t)((b & ~mask) | ((ink & 0x0F) << shift));
+  }
+
+  // Rectangle déjà découpé: demi-octets aux bords, memset au milieu de chaque ligne
+  static void fill(uint8_t *buf, int x0, int y0, int x1, int y1, uint8_t ink) {
+    const uint8_t both = ink == kInvert ? 0xFF : (uint8_t)((ink & 0x0F) * 0x11);
+    for (int y = y0; y < y1; y++) {
+      uint8_t *row = buf + y * (W / 2);
+      int x = x0, end = x1;
+      if (x & 1) pixel(buf, x++, y, ink);
+      if (end & 1 && end > x) pixel(buf, --end, y, ink);
+      if (end <= x) continue;
+      if (ink == kInvert) { for (int i = x >> 1; i < end >> 1; i++) row[i] ^= both; }
+      else memset(row + (x >> 1), both, (end - x) >> 1);
+    }
+  }
+
+  static void blit(uint8_t *buf, const uint8_t *cols, int w, int h, int x, int y, uint8_t ink) {
+    for (int i = 0; i < w; i++)
+      for (int j = 0; j < h; j++)
+        if (cols[i] & (1 << j)) pixel(buf, x + i, y + j, ink);
+  }
+};
+
+template <class Fmt>
+class Raster {
+ public:
+  static const uint8_t kInk = Fmt::kMax;
+  static const int16_t kW = Fmt::kW, kH = Fmt::kH;
+
+  void attach(uint8_t *buffer) { buf_ = buffer; }
+  uint8_t *buffer() const { return buf_; }
+  void clear() { memset(buf_, 0, Fmt::kBytes); }
+
+  void pixel(int x, int y, uint8_t ink) {
+    if ((unsigned)x < (unsigned)kW && (unsigned)y < (unsigned)kH) Fmt::pixel(buf_, x, y, ink);
+  }
+  void fillRect(int x, int y, int w, int h, uint8_t ink) {
+    int x1 = x + w, y1 = y + h;
+    if (x < 0) x = 0;
+    if (y < 0) y = 0;
+    if (x1 > kW) x1 = kW;
+    if (y1 > kH) y1 = kH;
+    if (x < x1 && y < y1) Fmt::fill(buf_, x, y, x1, y1, ink);
+  }
+  void hspan(int x, int y, int w, uint8_t ink) { fillRect(x, y, w, 1, ink); }
+  void vspan(int x, int y, int h, uint8_t ink) { fillRect(x, y, 1, h, ink); }
+  void rect(int x, int y, int w, int h, uint8_t ink) {
+    hspan(x, y, w, ink); hspan(x, y + h - 1, w, ink);
+    vspan(x, y + 1, h - 2, ink); vspan(x + w - 1, y + 1, h - 2, ink);
+  }
+
+  // Niveau fractionnaire 0..1 ajouté sans assombrir ce qui est déjà allumé
+  void blend(int x, int y, float cover) {
+    if ((unsigned)x >= (unsigned)kW || (unsigned)y >= (unsigned)kH || cover <= 0) return;
+    uint8_t lvl = cover >= 1 ? Fmt::kMax : (uint8_t)(cover * Fmt::kMax + 0.5f);
+    if (lvl > Fmt::get(buf_, x, y)) Fmt::pixel(buf_, x, y, lvl);
+  }
+
+  // Barre de largeur fractionnaire: colonnes pleines puis bord à la couverture restante
+  void fillRectAA(int x, int y, float w, int h) {
+    if (w <= 0) return;
+    int full = (int)w;
+    fillRect(x, y, full, h, Fmt::kMax);
+    float rest = w - full;
+    if (Fmt::kMax == 1) { if (rest >= 0.5f) vspan(x + full, y, h, 1); return; }
+    for (int j = 0; j < h; j++) blend(x + full, y + j, rest);
+  }
+
+  // Segment: Bresenham sur 1 bit, Xiaolin Wu (anticrénelé) en niveaux de gris
+  void line(int x0, int y0, int x1, int y1) {
+    if (Fmt::kMax == 1 || x0 == x1 || y0 == y1) { bresenham(x0, y0, x1, y1); return; }
+    bool steep = abs(y1 - y0) > abs(x1 - x0);
+    if (steep) { swap(x0, y0); swap(x1, y1); }
+    if (x0 > x1) { swap(x0, x1); swap(y0, y1); }
+    const float grad = (float)(y1 - y0) / (float)(x1 - x0);
+    float yf = (float)y0;
+    for (int x = x0; x <= x1; x++, yf += grad) {
+      int yi = (int)floorf(yf);
+      float f = yf - yi;
+      if (steep) { blend(yi, x, 1 - f); blend(yi + 1, x, f); }
+      else { blend(x, yi, 1 - f); blend(x, yi + 1, f); }
+    }
+  }
+
+  // Motif 1 bit en colonnes (octet = 8 pixels verticaux, bit 0 en haut), h <= 8
+  void blit(const uint8_t *cols, int w, int h, int x, int y, uint8_t ink) {
+    if (x >= 0 && y >= 0 && x + w <= kW && y + h <= kH) { Fmt::blit(buf_, cols, w, h, x, y, ink); return; }
+    for (int i = 0; i < w; i++)
+      for (int j = 0; j < h; j++)
+        if (cols[i] & (1 << j)) pixel(x + i, y + j, ink);
+  }
+
+ private:
+  static void swap(int &a, int &b) { int t = a; a = b; b = t; }
+  void bresenham(int x0, int y0, int x1, int y1) {
+    int dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+    int dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+    int err = dx + dy;
+    for (;;) {
+      pixel(x0, y0, Fmt::kMax);
+      if (x0 == x1 && y0 == y1) break;
+      int e2 = 2 * err;
+      if (e2 >= dy) { err += dy; x0 += sx; }
+      if (e2 <= dx) { err += dx; y0 += sy; }
+    }
+  }
+
+  uint8_t *buf_ = nullptr;
+};
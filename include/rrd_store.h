@@ -0,0 +1,382 @@
+// -----------------------------------------------------------------------------
+// Historique persistant en flash (LittleFS), à la manière d'une RRD: trois niveaux
+//   raw  un enregistrement par instantané de l'hôte (~1 s), dernière heure
+//   1m   min/moyenne/max par minute, ~2 jours
+//   15m  min/moyenne/max par quart d'heure, ~8 semaines
+// pour 4 métriques en entiers 16 bits (CPU %, RAM %, réseau KB/s, °C).
+//
+// Chaque niveau est un anneau de segments de 4 Ko (un bloc LittleFS) nommés
+// /rrd/<niveau>/<n° hex croissant>; ouvrir un segment efface le plus ancien.
+// Les enregistrements s'accumulent en RAM et ne partent que par page entière
+// de 256 o (page de programmation de la flash): ouverture en ajout, write, close.
+// LittleFS est copy-on-write: le close publie la page entière ou rien, une
+// coupure ne laisse pas d'enregistrement à moitié écrit. Chaque ajout recopie
+// la fin partielle du bloc dans un bloc neuf choisi par l'allocateur, qui fait
+// tourner les écritures sur toute la partition (usure dynamique): ~35 Ko
+// programmés par segment raw de 4 Ko, soit ~3 Mo/jour pour le niveau raw.
+// Un CRC16 par enregistrement écarte le reste (bit basculé); après une écriture
+// courte (partition pleine), le segment est clos et le suivant repart aligné.
+//
+// Au redémarrage, les pages encore en RAM sont perdues (16 s de raw, 8 min de
+// 1m, 2 h de 15m): begin() reconstruit 15m depuis 1m puis 1m depuis raw.
+// Lecture d'une plage: dichotomie sur le premier horodatage de chaque segment
+// (gardé en RAM), puis dans le segment; read() rend au plus max enregistrements
+// par appel, en une lecture de fichier.
+// -----------------------------------------------------------------------------
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <FS.h>
+
+#define RRD_METRICS 4
+#define RRD_PAGE 256                  // octets par écriture
+#define RRD_SEG 4096                  // octets par segment (un bloc)
+#define RRD_MIN_EPOCH 1600000000UL    // en deçà: pas encore d'heure de l'hôte
+#define RRD_M1_S 60
+#define RRD_M15_S 900
+
+enum RrdMetric : uint8_t { RRD_CPU, RRD_RAM, RRD_NET, RRD_TEMP };
+static const char *const kRrdMetricNames[RRD_METRICS] = {"cpu", "ram", "net", "temp"};
+static const float kRrdScale[RRD_METRICS] = {100, 100, 1, 100}; // stocké = valeur * échelle
+static const int16_t kRrdNone = INT16_MIN;                      // métrique absente
+
+static inline uint16_t rrdCrc16(const uint8_t *p, size_t n) { // CRC16-CCITT (0x1021, init 0xFFFF)
+  uint16_t crc = 0xFFFF;
+  while (n--) {
+    crc ^= (uint16_t)(*p++ << 8);
+    for (uint8_t b = 0; b < 8; b++) crc = crc & 0x8000 ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+  }
+  return crc;
+}
+
+static inline int16_t rrdEncode(uint8_t m, float v) {
+  if (isnan(v)) return kRrdNone;
+  float s = v * kRrdScale[m];
+  if (s > 32767) s = 32767;  // réseau > 32 Mo/s: saturé
+  if (s < -32767) s = -32767;
+  return (int16_t)lroundf(s);
+}
+static inline float rrdDecode(uint8_t m, int16_t v) { return v == kRrdNone ? NAN : v / kRrdScale[m]; }
+
+// Formats en flash (little-endian, tels quels), CRC sur tout sauf lui-même
+struct RrdRaw {
+  uint32_t t;                       // s, epoch
+  int16_t v[RRD_METRICS];
+  uint16_t rsv;
+  uint16_t crc;
+};
+struct RrdAgg {
+  uint32_t t;                       // début du créneau
+  uint16_t n;                       // échantillons bruts agrégés
+  int16_t mn[RRD_METRICS], avg[RRD_METRICS], mx[RRD_METRICS];
+  uint16_t crc;
+};
+static_assert(sizeof(RrdRaw) == 16 && sizeof(RrdAgg) == 32, "format flash");
+static_assert(RRD_SEG % RRD_PAGE == 0 && RRD_PAGE % sizeof(RrdAgg) == 0, "pages entières");
+
+template <class Rec> static inline uint16_t rrdCrcOf(const Rec &r) {
+  return rrdCrc16((const uint8_t *)&r, sizeof(Rec) - sizeof(r.crc));
+}
+
+// Créneau en cours d'agrégation, à partir d'échantillons bruts ou de créneaux plus fins
+struct RrdAcc {
+  uint32_t t = 0;                   // début du créneau, 0: vide
+  uint16_t n = 0;
+  int16_t mn[RRD_METRICS], mx[RRD_METRICS];
+  int32_t sum[RRD_METRICS];
+  uint16_t cnt[RRD_METRICS];
+
+  void reset(uint32_t start) {
+    t = start; n = 0;
+    for (uint8_t m = 0; m < RRD_METRICS; m++) { mn[m] = INT16_MAX; mx[m] = INT16_MIN; sum[m] = 0; cnt[m] = 0; }
+  }
+  void add(const RrdRaw &r) {
+    n++;
+    for (uint8_t m = 0; m < RRD_METRICS; m++) take(m, r.v[m], r.v[m], r.v[m], 1);
+  }
+  void add(const RrdAgg &a) { // moyenne pondérée par le nombre d'échantillons
+    n = (uint16_t)(n + a.n);
+    for (uint8_t m = 0; m < RRD_METRICS; m++) take(m, a.mn[m], a.avg[m], a.mx[m], a.n);
+  }
+  RrdAgg out() const {
+    RrdAgg a;
+    a.t = t; a.n = n;
+    for (uint8_t m = 0; m < RRD_METRICS; m++) {
+      a.mn[m] = cnt[m] ? mn[m] : kRrdNone;
+      a.mx[m] = cnt[m] ? mx[m] : kRrdNone;
+      a.avg[m] = cnt[m] ? (int16_t)(sum[m] / (int32_t)cnt[m]) : kRrdNone;
+    }
+    return a;
+  }
+
+ private:
+  void take(uint8_t m, int16_t lo, int16_t avg, int16_t hi, uint16_t w) {
+    if (avg == kRrdNone || w == 0) return;
+    if (lo < mn[m]) mn[m] = lo;
+    if (hi > mx[m]) mx[m] = hi;
+    sum[m] += (int32_t)avg * w;
+    cnt[m] = (uint16_t)(cnt[m] + w);
+  }
+};
+
+// Position de lecture: segment, enregistrement dans le segment
+struct RrdPos {
+  uint32_t seq = 0;
+  uint16_t idx = 0;
+  bool end = false;
+};
+
+template <class Rec, uint8_t SEGS>
+class RrdTier {
+ public:
+  static const uint16_t kPerSeg = RRD_SEG / sizeof(Rec);
+  static const uint16_t kPerPage = RRD_PAGE / sizeof(Rec);
+  static const uint8_t kSegs = SEGS;
+
+  // Inventaire du répertoire: anneau, premier horodatage de chaque segment,
+  // remplissage et dernier horodatage du segment courant
+  void begin(fs::FS &fs, const char *dir) {
+    fs_ = &fs; dir_ = dir;
+    fs.mkdir(dir);
+    uint32_t lo = UINT32_MAX, hi = 0, s;
+    File d = fs.open(dir);
+    for (File f = d.openNextFile(); f; f = d.openNextFile())
+      if (seqOf(f.name(), s)) { if (s < lo) lo = s; if (s > hi) hi = s; }
+    d.close();
+    seqFirst_ = 1; seqLast_ = 0; cur_ = kPerSeg; pageN_ = 0; lastT_ = 0; // vide: le premier ajout ouvre le segment 1
+    if (lo > hi) return;
+    seqLast_ = hi;
+    seqFirst_ = hi - lo >= SEGS ? hi - SEGS + 1 : lo;
+    if (lo < seqFirst_) { // coupure entre l'ouverture d'un segment et l'effacement du plus ancien
+      d = fs.open(dir);
+      for (File f = d.openNextFile(); f; f = d.openNextFile()) {
+        if (!seqOf(f.name(), s) || s >= seqFirst_) continue;
+        f.close();
+        fs.remove(path(s));
+      }
+      d.close();
+    }
+    for (s = seqFirst_; s != seqLast_ + 1; s++) {
+      File f = fs.open(path(s), FILE_READ);
+      Rec r;
+      segT_[s % SEGS] = f && recAt(f, s, 0, r) ? r.t : 0;
+      if (s != seqLast_) continue;
+      const size_t size = f ? f.size() : 0;
+      cur_ = (uint16_t)(size / sizeof(Rec) < kPerSeg ? size / sizeof(Rec) : kPerSeg);
+      rotate_ = size % sizeof(Rec) != 0 || size > RRD_SEG || cur_ % kPerPage != 0;
+      for (uint16_t i = cur_; i-- > 0 && !lastT_;) if (recAt(f, s, i, r)) lastT_ = r.t;
+    }
+    if (!lastT_ && seqLast_ != seqFirst_) { // segment courant vide: fin du précédent
+      File f = fs.open(path(seqLast_ - 1), FILE_READ);
+      Rec r;
+      for (uint16_t i = f ? recsIn(f) : 0; i-- > 0 && !lastT_;) if (recAt(f, seqLast_ - 1, i, r)) lastT_ = r.t;
+    }
+  }
+
+  // Ajoute un enregistrement (horodatages croissants); écrit la page quand elle est pleine
+  bool append(Rec r) {
+    r.crc = rrdCrcOf(r);
+    if (pageN_ == 0 && (cur_ >= kPerSeg || rotate_)) openSegment(r.t);
+    else if (cur_ == 0 && pageN_ == 0) segT_[seqLast_ % SEGS] = r.t;
+    memcpy(page_ + pageN_ * sizeof(Rec), &r, sizeof(Rec));
+    lastT_ = r.t;
+    return ++pageN_ < kPerPage || commit();
+  }
+
+  // Premier enregistrement d'horodatage >= from (ou le plus ancien)
+  RrdPos seek(uint32_t from) {
+    RrdPos p;
+    if (empty()) { p.end = true; return p; }
+    uint32_t lo = seqFirst_, hi = seqLast_;
+    while (lo < hi) {
+      const uint32_t mid = lo + (hi - lo + 1) / 2;
+      if (segT_[mid % SEGS] <= from) lo = mid; else hi = mid - 1;
+    }
+    File f = fs_->open(path(lo), FILE_READ);
+    uint16_t a = 0, b = lo == seqLast_ && pageN_ ? (uint16_t)(cur_ + pageN_) : (f ? recsIn(f) : 0);
+    while (a < b) {
+      const uint16_t m = (uint16_t)((a + b) / 2);
+      Rec r;
+      if (!recAt(f, lo, m, r) || r.t < from) a = (uint16_t)(m + 1); else b = m;
+    }
+    p.seq = lo;
+    p.idx = a;
+    return p;
+  }
+
+  // Jusqu'à max enregistrements valides d'horodatage <= to à partir de p (avancée);
+  // inclut la page encore en RAM. p.end: plus rien dans la plage pour l'instant.
+  uint16_t read(RrdPos &p, uint32_t to, Rec *out, uint16_t max) {
+    uint16_t n = 0;
+    while (n < max && !p.end) {
+      if (empty() || (int32_t)(p.seq - seqLast_) > 0) { p.end = true; break; }
+      if ((int32_t)(p.seq - seqFirst_) < 0) { p.seq = seqFirst_; p.idx = 0; } // effacé entre deux appels
+      File f = fs_->open(path(p.seq), FILE_READ);
+      const uint16_t inFile = f ? recsIn(f) : 0;
+      const bool live = p.seq == seqLast_ && pageN_;
+      const uint16_t total = live ? (uint16_t)(cur_ + pageN_) : inFile;
+      if (p.idx >= total) {
+        if (p.seq == seqLast_) p.end = true;
+        else { p.seq++; p.idx = 0; }
+        continue;
+      }
+      uint16_t k = (uint16_t)(total - p.idx < max - n ? total - p.idx : max - n), got = 0;
+      const uint16_t fileEnd = live ? cur_ : inFile;
+      if (p.idx < fileEnd) {
+        const uint16_t want = (uint16_t)(fileEnd - p.idx < k ? fileEnd - p.idx : k);
+        if (f.seek((uint32_t)p.idx * sizeof(Rec))) got = (uint16_t)(f.read((uint8_t *)(out + n), want * sizeof(Rec)) / sizeof(Rec));
+        if (got < want) k = got; // fichier plus court que prévu: la suite au prochain tour
+      }
+      for (; got < k; got++) memcpy(out + n + got, page_ + (p.idx + got - cur_) * sizeof(Rec), sizeof(Rec));
+      if (k == 0) { p.seq++; p.idx = 0; continue; }
+      p.idx = (uint16_t)(p.idx + k);
+      const uint16_t base = n;
+      for (uint16_t i = 0; i < k; i++) { // compacte sur place les enregistrements retenus
+        const Rec r = out[base + i];
+        if (r.crc != rrdCrcOf(r)) { crcBad++; continue; }
+        if (r.t > to) { p.end = true; break; }
+        out[n++] = r;
+      }
+    }
+    return n;
+  }
+
+  bool empty() const { return seqLast_ + 1 == seqFirst_; }
+  uint32_t lastT() const { return lastT_; }       // 0: vide
+  uint32_t firstT() const { return empty() ? 0 : segT_[seqFirst_ % SEGS]; }
+
+  uint32_t pageWrites = 0;                        // pages publiées
+  uint32_t errors = 0;                            // écritures échouées ou courtes (page perdue)
+  uint32_t crcBad = 0;                            // enregistrements écartés à la lecture
+
+ private:
+  void openSegment(uint32_t t) {
+    seqLast_++;
+    cur_ = 0;
+    rotate_ = false;
+    if (seqLast_ - seqFirst_ >= SEGS) fs_->remove(path(seqFirst_++));
+    segT_[seqLast_ % SEGS] = t;
+  }
+
+  bool commit() {
+    const size_t want = pageN_ * sizeof(Rec);
+    File f = fs_->open(path(seqLast_), FILE_APPEND);
+    const size_t w = f ? f.write(page_, want) : 0;
+    f.close(); // publication de la page (LittleFS: tout ou rien)
+    pageN_ = 0;
+    if (w != want) { errors++; rotate_ = true; return false; }
+    cur_ = (uint16_t)(cur_ + kPerPage);
+    pageWrites++;
+    return true;
+  }
+
+  uint16_t recsIn(File &f) const {
+    const size_t n = f.size() / sizeof(Rec);
+    return (uint16_t)(n < kPerSeg ? n : kPerSeg);
+  }
+
+  // Enregistrement idx du segment seq (fichier ouvert f, ou page en RAM), CRC vérifié
+  bool recAt(File &f, uint32_t seq, uint16_t idx, Rec &r) {
+    if (seq == seqLast_ && pageN_ && idx >= cur_) {
+      if (idx >= cur_ + pageN_) return false;
+      memcpy(&r, page_ + (idx - cur_) * sizeof(Rec), sizeof(Rec));
+    } else if (!f || !f.seek((uint32_t)idx * sizeof(Rec)) || f.read((uint8_t *)&r, sizeof(Rec)) != sizeof(Rec)) {
+      return false;
+    }
+    return r.crc == rrdCrcOf(r);
+  }
+
+  const char *path(uint32_t seq) {
+    snprintf(path_, sizeof(path_), "%s/%08lx", dir_, (unsigned long)seq);
+    return path_;
+  }
+  static bool seqOf(const char *name, uint32_t &seq) {
+    char *end;
+    if (strlen(name) != 8) return false;
+    seq = (uint32_t)strtoul(name, &end, 16);
+    return *end == 0;
+  }
+
+  fs::FS *fs_ = nullptr;
+  const char *dir_ = "";
+  char path_[24];
+  uint8_t page_[RRD_PAGE];
+  uint32_t segT_[SEGS] = {0};
+  uint32_t seqFirst_ = 1, seqLast_ = 0, lastT_ = 0;
+  uint16_t cur_ = kPerSeg;  // enregistrements publiés dans le segment courant
+  uint16_t pageN_ = 0;      // enregistrements en attente dans page_
+  bool rotate_ = false;     // segment courant clos (écriture courte, taille incohérente)
+};
+
+class RrdStore {
+ public:
+  // raw: 15 segments pleins (3840 s) + le courant; 1m: 23 x 128 min; 15m: 43 x 32 h
+  RrdTier<RrdRaw, 16> raw;
+  RrdTier<RrdAgg, 24> m1;
+  RrdTier<RrdAgg, 44> m15;
+
+  // Ouvre les niveaux et rejoue dans les agrégats ce que les pages perdues contenaient
+  bool begin(fs::FS &fs) {
+    if (!fs.mkdir("/rrd")) return false;
+    raw.begin(fs, "/rrd/raw");
+    m1.begin(fs, "/rrd/1m");
+    m15.begin(fs, "/rrd/15m");
+    {
+      RrdAgg buf[8];
+      RrdPos p = m1.seek(m15.empty() ? 0 : m15.lastT() + RRD_M15_S);
+      while (uint16_t n = m1.read(p, UINT32_MAX, buf, 8)) for (uint16_t i = 0; i < n; i++) fold15(buf[i]);
+    }
+    {
+      RrdRaw buf[16];
+      RrdPos p = raw.seek(m1.empty() ? 0 : m1.lastT() + RRD_M1_S);
+      while (uint16_t n = raw.read(p, UINT32_MAX, buf, 16)) for (uint16_t i = 0; i < n; i++) fold1(buf[i]);
+    }
+    ok_ = true;
+    return true;
+  }
+
+  // Instantané d'horodatage t (s); v[RRD_METRICS], NAN: absente
+  void add(uint32_t t, const float *v) {
+    if (!ok_) return;
+    if (t < RRD_MIN_EPOCH || t <= raw.lastT()) { dropped++; return; } // pas d'heure, doublon ou retour en arrière
+    RrdRaw r;
+    r.t = t;
+    for (uint8_t m = 0; m < RRD_METRICS; m++) r.v[m] = rrdEncode(m, v[m]);
+    r.rsv = 0;
+    raw.append(r);
+    fold1(r);
+  }
+
+  bool ok() const { return ok_; }
+  uint32_t pageWrites() const { return raw.pageWrites + m1.pageWrites + m15.pageWrites; }
+  uint32_t errors() const { return raw.errors + m1.errors + m15.errors; }
+  uint32_t dropped = 0;
+
+ private:
+  void fold1(const RrdRaw &r) {
+    const uint32_t b = r.t - r.t % RRD_M1_S;
+    if (acc1_.t != b) {
+      if (acc1_.t && acc1_.n) {
+        const RrdAgg a = acc1_.out();
+        if (a.t > m1.lastT()) { m1.append(a); fold15(a); }
+      }
+      acc1_.reset(b);
+    }
+    acc1_.add(r);
+  }
+  void fold15(const RrdAgg &a) {
+    const uint32_t b = a.t - a.t % RRD_M15_S;
+    if (acc15_.t != b) {
+      if (acc15_.t && acc15_.n) {
+        const RrdAgg q = acc15_.out();
+        if (q.t > m15.lastT()) m15.append(q);
+      }
+      acc15_.reset(b);
+    }
+    acc15_.add(a);
+  }
+
+  RrdAcc acc1_, acc15_;
+  bool ok_ = false;
+};
@@ -0,0 +1,47 @@
+// -----------------------------------------------------------------------------
+// File de lecture des échantillons rapides reçus par lots {"t":"b"}
+// Chaque échantillon a une échéance (nowMs) espacée de dt; la boucle de rendu
+// consomme ceux dont l'échéance est passée. Mémoire fixe, plus ancien écrasé.
+// -----------------------------------------------------------------------------
+#pragma once
+#include <stdint.h>
+
+struct TimedSample {
+  uint32_t due;       // nowMs() de lecture
+  uint8_t cpu;        // 0..100
+  uint8_t ram;        // 0..100, 0xFF = absent
+};
+
+template <uint8_t N>
+class SampleQueue {
+ public:
+  bool empty() const { return count_ == 0; }
+  uint8_t size() const { return count_; }
+  // Échéance du dernier échantillon en file (valide si !empty())
+  uint32_t lastDue() const { return buf_[(head_ + count_ - 1) % N].due; }
+
+  // Retourne false si la file était pleine (le plus ancien est perdu)
+  bool push(const TimedSample &s) {
+    bool room = count_ < N;
+    if (!room) { head_ = (head_ + 1) % N; count_--; }
+    buf_[(head_ + count_) % N] = s;
+    count_++;
+    return room;
+  }
+
+  // Prochain échantillon échu (comparaison sûre au débordement de l'horloge)
+  bool popDue(uint32_t now, TimedSample &out) {
+    if (!count_ || (int32_t)(now - buf_[head_].due) < 0) return false;
+    out = buf_[head_];
+    head_ = (head_ + 1) % N;
+    count_--;
+    return true;
+  }
+
+  void clear() { head_ = count_ = 0; }
+
+ private:
+  TimedSample buf_[N];
+  uint8_t head_ = 0;
+  uint8_t count_ = 0;
+};
@@ -0,0 +1,74 @@
+// -----------------------------------------------------------------------------
+// Instantanés en delta ({"t":"d"}): le bridge envoie une keyframe (tous les
+// champs, "k":1) à la connexion puis toutes les N secondes, et entre deux
+// seulement les champs qui ont changé, sous des clés numériques courtes:
+//   {"t":"d","s":<seq>,"k":1?,"0":23.4,"4":8234567,"14":[["en0",1.5,0.2]],...}
+// Un champ à null disparaît (valeur par défaut). Les tableaux vont en lignes
+// positionnelles ([id, free, size], [id, rx, tx], [id, cpu]).
+//
+// L'heure et le démarrage de l'hôte ne viennent qu'avec les keyframes: entre
+// deux, l'appareil fait avancer l'heure avec millis() et en déduit l'uptime.
+//
+// Un delta ne vaut que sur l'état de la ligne précédente: s doit la suivre,
+// sinon (ligne perdue, reset) il est ignoré et une keyframe est demandée
+// ({"t":"dk","s":<dernier s>}) jusqu'à ce qu'elle arrive.
+// Même découpage que host_frame.h: la séquence ici, la lecture dans main.cpp.
+// -----------------------------------------------------------------------------
+#pragma once
+#include <stdint.h>
+#include "time_source.h"
+
+// Clés des champs (tools/delta.py: FIELDS, même ordre). kdHost: réservé, le nom
+// d'hôte n'est plus envoyé (l'écran ne l'affiche pas)
+enum DeltaKey : uint8_t {
+  kdCpu, kdCpuMax, kdCpuP95, kdRam, kdRamUsed, kdRamMax,
+  kdTime, kdDiskFree, kdNetRx, kdNetTx, kdTemp, kdDesc, kdApp,
+  kdDisks, kdNics, kdProcs, kdExtras, kdHost, kdBoot,
+  kdCount
+};
+
+class DeltaSync {
+ public:
+  // Ligne s (keyframe ou non) applicable? false: delta sans base, keyframe demandée
+  bool accept(uint16_t seq, bool key) {
+    if (!key && !(synced_ && seq == (uint16_t)(last_ + 1))) {
+      if (synced_) gaps++;
+      synced_ = false;
+      return false;
+    }
+    if (key) { keyframes++; epochSet_ = false; boot_ = 0; keyAsked_ = false; }
+    synced_ = true;
+    last_ = seq;
+    deltas++;
+    return true;
+  }
+
+  // Demande de keyframe tant qu'on n'est pas synchronisé, au plus une par intervalle
+  bool takeKeyRequest(uint32_t now, uint16_t everyMs) {
+    if (synced_ || (keyAsked_ && msSince(now, keyAskedMs_) < (int32_t)everyMs)) return false;
+    keyAsked_ = true;
+    keyAskedMs_ = now;
+    return true;
+  }
+
+  // Heure de l'hôte (keyframe), puis extrapolée: false si inconnue
+  void setEpoch(uint32_t epoch, uint32_t now) { epoch_ = epoch; epochMs_ = now; epochSet_ = epoch != 0; }
+  bool epoch(uint32_t now, uint32_t &out) const {
+    if (!epochSet_) return false;
+    out = epoch_ + (uint32_t)msSince(now, epochMs_) / 1000;
+    return true;
+  }
+  // Démarrage de l'hôte (epoch s), 0 = inconnu
+  void setBoot(uint32_t boot) { boot_ = boot; }
+  uint32_t boot() const { return boot_; }
+
+  bool synced() const { return synced_; }
+  uint16_t last() const { return last_; }
+
+  uint32_t deltas = 0, keyframes = 0, gaps = 0;
+
+ private:
+  uint16_t last_ = 0;
+  uint32_t epoch_ = 0, epochMs_ = 0, boot_ = 0, keyAskedMs_ = 0;
+  bool synced_ = false, epochSet_ = false, keyAsked_ = false;
+};
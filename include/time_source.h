@@ -0,0 +1,28 @@
+// -----------------------------------------------------------------------------
+// Sources de temps et d'aléa du firmware
+// Tout le code passe par nowMs()/nowUs()/rnd(): par défaut millis()/micros()/
+// random(), remplacées par le harness de simulation natif (horloge virtuelle,
+// PRNG à graine fixe) pour rejouer des semaines d'uptime en quelques secondes.
+//
+// Les instants sont des uint32_t qui repassent par 0 tous les 49,7 jours: on ne
+// les compare jamais directement (now > deadline), seulement par différence
+// signée (reached(), msSince()).
+// -----------------------------------------------------------------------------
+#pragma once
+#include <stdint.h>
+
+struct TimeSource {
+  uint32_t (*ms)();
+  uint32_t (*us)();
+  long (*rand)(long range);  // [0, range)
+};
+extern TimeSource timeSource;
+
+static inline uint32_t nowMs() { return timeSource.ms(); }
+static inline uint32_t nowUs() { return timeSource.us(); }
+static inline long rnd(long range) { return range > 0 ? timeSource.rand(range) : 0; }
+
+// Temps écoulé depuis `then` (valide sur 24,8 jours de part et d'autre)
+static inline int32_t msSince(uint32_t now, uint32_t then) { return (int32_t)(now - then); }
+// L'échéance est-elle atteinte ?
+static inline bool reached(uint32_t now, uint32_t deadline) { return (int32_t)(now - deadline) >= 0; }
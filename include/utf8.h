@@ -0,0 +1,44 @@
+// -----------------------------------------------------------------------------
+// UTF-8: décodage et coupe sur frontière de caractère
+// Les chaînes du bridge (app, météo, ids, champs "x") sont en UTF-8; on ne les
+// décode qu'à leur arrivée (GlyphString, font.h), jamais au rendu.
+// -----------------------------------------------------------------------------
+#pragma once
+#include <stdint.h>
+
+static const uint32_t kUtf8Bad = 0xFFFD;  // séquence invalide ou tronquée
+
+// Longueur de la séquence annoncée par un octet de tête (0: octet de suite ou invalide)
+static inline uint8_t utf8SeqLen(uint8_t c) {
+  if (c < 0x80) return 1;
+  if (c < 0xC2) return 0;  // suite, ou tête surlongue (C0/C1)
+  if (c < 0xE0) return 2;
+  if (c < 0xF0) return 3;
+  if (c < 0xF5) return 4;
+  return 0;
+}
+
+// Point de code commençant à s[i] (len octets en tout); avance i d'au moins 1
+static inline uint32_t utf8Next(const char *s, uint16_t len, uint16_t &i) {
+  const uint8_t c = (uint8_t)s[i++];
+  const uint8_t n = utf8SeqLen(c);
+  if (n == 1) return c;
+  if (n == 0) return kUtf8Bad;
+  uint32_t cp = c & (0x7F >> n);
+  for (uint8_t k = 1; k < n; k++) {
+    if (i >= len || ((uint8_t)s[i] & 0xC0) != 0x80) return kUtf8Bad;  // i reste sur l'octet fautif
+    cp = (cp << 6) | ((uint8_t)s[i++] & 0x3F);
+  }
+  static const uint32_t kMin[5] = {0, 0, 0x80, 0x800, 0x10000};
+  if (cp < kMin[n] || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) return kUtf8Bad;
+  return cp;
+}
+
+// Plus grande longueur <= n qui ne coupe pas de séquence (s a au moins n octets)
+static inline uint16_t utf8Fit(const char *s, uint16_t n) {
+  uint16_t start = n;
+  while (start > 0 && ((uint8_t)s[start - 1] & 0xC0) == 0x80) start--;
+  if (start == 0) return n;  // que des octets de suite: rien à préserver
+  const uint8_t need = utf8SeqLen((uint8_t)s[start - 1]);
+  return (need > 1 && n - (start - 1) < need) ? (uint16_t)(start - 1) : n;
+}
@@ -0,0 +1,131 @@
+// -----------------------------------------------------------------------------
+// Agrégats glissants d'une métrique (somme, compte, min, max) sur W fenêtres
+// emboîtées, par exemple 1, 5 et 15 minutes. Les échantillons s'accumulent
+// dans un seau de durée fixe. À sa clôture, chaque fenêtre ajoute le seau
+// entrant et retire le sortant (somme/compte en O(1)); deux deques monotones
+// par fenêtre ne gardent que les seaux encore candidats au min/max (O(1)
+// amorti). Le seau en cours compte dans toutes les fenêtres: pas de retard.
+// Valeurs en centièmes entiers: les sommes courantes ne dérivent pas.
+// Mémoire fixe: B seaux de 16 octets + 2 * W deques de B indices.
+// -----------------------------------------------------------------------------
+#pragma once
+#include <stdint.h>
+#include <math.h>
+
+struct WindowAgg {
+  float sum = 0, min = NAN, max = NAN;
+  uint32_t count = 0;
+  bool empty() const { return count == 0; }
+  float mean() const { return count ? sum / count : NAN; }
+};
+
+template <uint16_t B, uint8_t W>
+class SlidingWindows {
+ public:
+  // spans[w]: longueur de la fenêtre w en seaux, seau en cours compris (1..B)
+  SlidingWindows(uint32_t bucketMs, const uint16_t (&spans)[W]) : bucketMs_(bucketMs) {
+    for (uint8_t w = 0; w < W; w++) span_[w] = spans[w] < 1 ? 1 : (spans[w] > B ? B : spans[w]);
+  }
+
+  void add(uint32_t now, float v) {
+    roll(now);
+    if (isnan(v)) return;
+    const float f = v * kScale;
+    const int32_t q = f >= 2e9f ? 2000000000 : f <= -2e9f ? -2000000000 : (int32_t)lroundf(f);
+    if (!cur_.n || q < cur_.mn) cur_.mn = q;
+    if (!cur_.n || q > cur_.mx) cur_.mx = q;
+    cur_.sum += q;
+    cur_.n++;
+  }
+
+  // Clôt les seaux écoulés (vides si aucun échantillon); à appeler aussi sans données
+  void roll(uint32_t now) {
+    if (!started_) { started_ = true; start_ = now; return; }
+    uint16_t guard = 0;
+    while ((uint32_t)(now - start_) >= bucketMs_ && guard++ <= B) {
+      close();
+      start_ += bucketMs_;
+    }
+    if (guard > B) start_ = now; // très long trou: tout est sorti des fenêtres
+  }
+
+  WindowAgg get(uint8_t w) const {
+    WindowAgg a;
+    int64_t sum = sum_[w] + cur_.sum;
+    a.count = cnt_[w] + cur_.n;
+    if (!a.count) return a;
+    a.sum = (float)sum / kScale;
+    int32_t mn = cur_.n ? cur_.mn : INT32_MAX, mx = cur_.n ? cur_.mx : INT32_MIN;
+    if (minQ_[w].size && ring_[minQ_[w].front()].mn < mn) mn = ring_[minQ_[w].front()].mn;
+    if (maxQ_[w].size && ring_[maxQ_[w].front()].mx > mx) mx = ring_[maxQ_[w].front()].mx;
+    a.min = (float)mn / kScale;
+    a.max = (float)mx / kScale;
+    return a;
+  }
+
+  uint16_t span(uint8_t w) const { return span_[w]; }
+  uint32_t bucketMs() const { return bucketMs_; }
+
+ private:
+  static const int32_t kScale = 100;
+
+  // Somme sur 64 bits: un seau de 10 s de réseau saturé (KB/s x 100) dépasse
+  // int32; compte sur 32 bits: plus de 65535 lignes par seau en rafale
+  struct Bucket {
+    int64_t sum = 0;
+    int32_t mn = 0, mx = 0;
+    uint32_t n = 0;
+  };
+
+  // Deque d'indices de seau dans ring_
+  struct Deque {
+    uint16_t q[B];
+    uint16_t head = 0, size = 0;
+    uint16_t front() const { return q[head]; }
+    uint16_t back() const { return q[(head + size - 1) % B]; }
+    void popFront() { head = (uint16_t)((head + 1) % B); size--; }
+    void popBack() { size--; }
+    void pushBack(uint16_t s) { q[(head + size++) % B] = s; }
+  };
+
+  // Âge (en seaux clos) d'un indice, 0 = le dernier clos; toujours < B
+  uint16_t age(uint16_t i) const { return (uint16_t)((last_ + B - i) % B); }
+
+  void close() {
+    last_ = (uint16_t)((last_ + 1) % B);
+    ring_[last_] = cur_;
+    const Bucket &b = ring_[last_];
+    if (closed_ < B) closed_++;
+    for (uint8_t w = 0; w < W; w++) {
+      const uint16_t len = (uint16_t)(span_[w] - 1); // seaux clos dans la fenêtre
+      if (!len) continue;
+      sum_[w] += b.sum; cnt_[w] += b.n;
+      if (closed_ > len) { // le seau d'âge len sort de la fenêtre
+        const Bucket &old = ring_[(last_ + B - len) % B];
+        sum_[w] -= old.sum; cnt_[w] -= old.n;
+      }
+      Deque &mn = minQ_[w], &mx = maxQ_[w];
+      if (b.n) {
+        while (mn.size && ring_[mn.back()].mn >= b.mn) mn.popBack();
+        mn.pushBack(last_);
+        while (mx.size && ring_[mx.back()].mx <= b.mx) mx.popBack();
+        mx.pushBack(last_);
+      }
+      while (mn.size && age(mn.front()) >= len) mn.popFront();
+      while (mx.size && age(mx.front()) >= len) mx.popFront();
+    }
+    cur_ = Bucket();
+  }
+
+  const uint32_t bucketMs_;
+  uint16_t span_[W];
+  Bucket ring_[B];
+  Bucket cur_;
+  Deque minQ_[W], maxQ_[W];
+  int64_t sum_[W] = {};
+  uint32_t cnt_[W] = {};
+  uint16_t last_ = B - 1;  // dernier seau clos
+  uint16_t closed_ = 0;    // seaux clos, plafonné à B
+  uint32_t start_ = 0;
+  bool started_ = false;
+};
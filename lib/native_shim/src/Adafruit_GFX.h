@@ -0,0 +1,85 @@
+// -----------------------------------------------------------------------------
+// Shim Adafruit_GFX (build native)
+// Primitives utilisées par le firmware, avec des coûts du même ordre que la
+// vraie lib (écriture pixel par pixel via drawPixel). Le texte dessine un motif
+// 5x7 dérivé du code caractère: pas lisible, mais même nombre de pixels testés.
+// -----------------------------------------------------------------------------
+#pragma once
+#include <Arduino.h>
+
+class Adafruit_GFX : public Print {
+ public:
+  Adafruit_GFX(int16_t w, int16_t h) : WIDTH(w), HEIGHT(h), _width(w), _height(h) {}
+  virtual ~Adafruit_GFX() {}
+
+  virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+
+  virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    for (int16_t i = 0; i < h; i++) drawPixel(x, y + i, color);
+  }
+  virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    for (int16_t i = 0; i < w; i++) drawPixel(x + i, y, color);
+  }
+  virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    for (int16_t i = x; i < x + w; i++) drawFastVLine(i, y, h, color);
+  }
+  virtual void fillScreen(uint16_t color) { fillRect(0, 0, _width, _height, color); }
+
+  void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+    int16_t dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+    int16_t dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+    int16_t err = dx + dy;
+    for (;;) {
+      drawPixel(x0, y0, color);
+      if (x0 == x1 && y0 == y1) break;
+      int16_t e2 = 2 * err;
+      if (e2 >= dy) { err += dy; x0 += sx; }
+      if (e2 <= dx) { err += dx; y0 += sy; }
+    }
+  }
+  void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    drawFastHLine(x, y, w, color);
+    drawFastHLine(x, y + h - 1, w, color);
+    drawFastVLine(x, y, h, color);
+    drawFastVLine(x + w - 1, y, h, color);
+  }
+
+  void setCursor(int16_t x, int16_t y) { cursor_x = x; cursor_y = y; }
+  int16_t getCursorX() const { return cursor_x; }
+  int16_t getCursorY() const { return cursor_y; }
+  void setTextSize(uint8_t s) { textsize = s ? s : 1; }
+  void setTextColor(uint16_t c) { textcolor = textbgcolor = c; }
+  void setTextColor(uint16_t c, uint16_t bg) { textcolor = c; textbgcolor = bg; }
+  void setTextWrap(bool w) { wrap = w; }
+  int16_t width() const { return _width; }
+  int16_t height() const { return _height; }
+
+  using Print::write;
+  size_t write(uint8_t c) override {
+    if (c == '\n') { cursor_x = 0; cursor_y += 8 * textsize; return 1; }
+    if (c == '\r') return 1;
+    drawChar(cursor_x, cursor_y, c);
+    cursor_x += 6 * textsize;
+    return 1;
+  }
+
+ protected:
+  void drawChar(int16_t x, int16_t y, uint8_t c) {
+    if (x >= _width || y >= _height || x + 6 * textsize < 0 || y + 8 * textsize < 0) return;
+    uint32_t bits = (uint32_t)c * 2654435761u;
+    for (int8_t i = 0; i < 5; i++) {
+      uint8_t line = (c == ' ') ? 0 : (uint8_t)((bits >> (i * 5)) & 0x7F);
+      for (int8_t j = 0; j < 8; j++, line >>= 1) {
+        if (line & 1) drawPixel(x + i, y + j, textcolor);
+        else if (textbgcolor != textcolor) drawPixel(x + i, y + j, textbgcolor);
+      }
+    }
+  }
+
+  const int16_t WIDTH, HEIGHT;
+  int16_t _width, _height;
+  int16_t cursor_x = 0, cursor_y = 0;
+  uint16_t textcolor = 0xFFFF, textbgcolor = 0xFFFF;
+  uint8_t textsize = 1;
+  bool wrap = true;
+};
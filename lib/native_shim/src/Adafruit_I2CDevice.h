@@ -0,0 +1,35 @@
+// -----------------------------------------------------------------------------
+// Shim Adafruit_I2CDevice (build native)
+// Pas de bus: chaque write() compte les octets transférés (adresse comprise)
+// et le temps qu'ils auraient pris à la vitesse courante, que le harness
+// --sim ajoute à son horloge virtuelle comme une écriture bloquante.
+// -----------------------------------------------------------------------------
+#pragma once
+#include <Arduino.h>
+#include <Wire.h>
+
+extern uint64_t nativeI2cNs;  // temps de bus cumulé, tous périphériques (native_main.cpp)
+
+class Adafruit_I2CDevice {
+ public:
+  Adafruit_I2CDevice(uint8_t addr, TwoWire *theWire = &Wire) : addr_(addr), wire_(theWire) {}
+  bool begin(bool addr_detect = true) { (void)addr_detect; return true; }
+  uint8_t address() const { return addr_; }
+  size_t maxBufferSize() { return 32; }
+  bool setSpeed(uint32_t hz) { wire_->setClock(hz); return true; }
+
+  bool write(const uint8_t *buffer, size_t len, bool stop = true,
+             const uint8_t *prefix_buffer = nullptr, size_t prefix_len = 0) {
+    (void)buffer; (void)stop; (void)prefix_buffer;
+    size_t n = 1 + prefix_len + len;
+    bytes += n;
+    nativeI2cNs += (uint64_t)n * 9 * 1000000000ULL / wire_->getClock();  // 8 bits + ACK
+    return true;
+  }
+
+  uint32_t bytes = 0;
+
+ private:
+  uint8_t addr_;
+  TwoWire *wire_;
+};
@@ -0,0 +1,87 @@
+// -----------------------------------------------------------------------------
+// Shim Adafruit_SH110X (build native)
+// Framebuffer 1 bit organisé en pages comme le SH1106; display() passe par un
+// Adafruit_I2CDevice factice qui comptabilise les octets et le temps de bus.
+// -----------------------------------------------------------------------------
+#pragma once
+#include <Adafruit_GFX.h>
+#include <Adafruit_I2CDevice.h>
+#include <Wire.h>
+
+#define SH110X_BLACK 0
+#define SH110X_WHITE 1
+#define SH110X_INVERSE 2
+#define SH110X_SETPAGEADDR 0xB0
+
+class Adafruit_SH110X : public Adafruit_GFX {
+ public:
+  Adafruit_SH110X(int16_t w, int16_t h) : Adafruit_GFX(w, h) {
+    buffer = (uint8_t *)calloc((size_t)w * ((h + 7) / 8), 1);
+  }
+  ~Adafruit_SH110X() override { free(buffer); delete i2c_dev; }
+
+  bool begin(uint8_t addr = 0x3C, bool reset = true) {
+    (void)reset;
+    delete i2c_dev;
+    i2c_dev = new Adafruit_I2CDevice(addr, &Wire);
+    return buffer != nullptr;
+  }
+  void clearDisplay() { memset(buffer, 0, (size_t)WIDTH * ((HEIGHT + 7) / 8)); }
+  void invertDisplay(bool i) { inverted_ = i; command(i ? 0xA7 : 0xA6); }
+  void setContrast(uint8_t c) { command(0x81); command(c); }
+  uint8_t *getBuffer() { return buffer; }
+  bool getPixel(int16_t x, int16_t y) const {
+    if (x < 0 || y < 0 || x >= WIDTH || y >= HEIGHT) return false;
+    return buffer[x + (y / 8) * WIDTH] & (1 << (y & 7));
+  }
+
+  // Comme la vraie lib: toutes les pages, par paquets de maxBufferSize()
+  void display() {
+    if (!i2c_dev) return;
+    i2c_dev->setSpeed(i2c_preclk);
+    const uint8_t dc = 0x40;
+    const size_t maxData = i2c_dev->maxBufferSize() - 1;
+    for (int p = 0; p < (HEIGHT + 7) / 8; p++) {
+      uint8_t cmd[] = {0x00, (uint8_t)(SH110X_SETPAGEADDR + p), (uint8_t)(0x10 + (_page_start_offset >> 4)),
+                       (uint8_t)(_page_start_offset & 0xF)};
+      i2c_dev->write(cmd, 4);
+      for (int c = 0; c < WIDTH; c += (int)maxData) {
+        size_t n = WIDTH - c < (int)maxData ? (size_t)(WIDTH - c) : maxData;
+        i2c_dev->write(buffer + p * WIDTH + c, n, true, &dc, 1);
+      }
+    }
+    i2c_dev->setSpeed(i2c_postclk);
+  }
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+    if (x < 0 || y < 0 || x >= WIDTH || y >= HEIGHT) return;
+    uint8_t &b = buffer[x + (y / 8) * WIDTH];
+    uint8_t m = (uint8_t)(1 << (y & 7));
+    switch (color) {
+      case SH110X_WHITE: b |= m; break;
+      case SH110X_BLACK: b &= (uint8_t)~m; break;
+      case SH110X_INVERSE: b ^= m; break;
+    }
+  }
+
+  // Mêmes membres protégés que Adafruit_GrayOLED / Adafruit_SH110X
+ protected:
+  void command(uint8_t c) { if (i2c_dev) { uint8_t b[] = {0x00, c}; i2c_dev->write(b, 2); } }
+
+  uint8_t *buffer = nullptr;
+  Adafruit_I2CDevice *i2c_dev = nullptr;
+  uint32_t i2c_preclk = 400000, i2c_postclk = 100000;
+  uint8_t _page_start_offset = 0;
+  bool inverted_ = false;
+};
+
+class Adafruit_SH1106G : public Adafruit_SH110X {
+ public:
+  Adafruit_SH1106G(uint16_t w, uint16_t h, TwoWire *twi = &Wire, int8_t rst_pin = -1,
+                   uint32_t clkDuring = 400000, uint32_t clkAfter = 100000)
+      : Adafruit_SH110X((int16_t)w, (int16_t)h) {
+    (void)twi; (void)rst_pin;
+    i2c_preclk = clkDuring; i2c_postclk = clkAfter;
+    _page_start_offset = 2; // 132 colonnes de RAM, 128 visibles
+  }
+};
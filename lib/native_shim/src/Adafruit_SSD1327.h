@@ -0,0 +1,62 @@
+// -----------------------------------------------------------------------------
+// Shim Adafruit_SSD1327 (build native)
+// Tampon 4 bits, 2 pixels par octet (x pair en poids fort) comme la vraie lib;
+// display() envoie tout via l'Adafruit_I2CDevice factice (octets et temps de bus).
+// -----------------------------------------------------------------------------
+#pragma once
+#include <Adafruit_GFX.h>
+#include <Adafruit_I2CDevice.h>
+#include <Wire.h>
+
+#define SSD1327_BLACK 0x0
+#define SSD1327_WHITE 0xF
+#define SSD1327_I2C_ADDRESS 0x3D
+#define SSD1327_SETCOLUMN 0x15
+#define SSD1327_SETROW 0x75
+
+class Adafruit_SSD1327 : public Adafruit_GFX {
+ public:
+  Adafruit_SSD1327(uint16_t w, uint16_t h, TwoWire *twi = &Wire, int8_t rst_pin = -1,
+                   uint32_t preclk = 400000, uint32_t postclk = 100000)
+      : Adafruit_GFX((int16_t)w, (int16_t)h), i2c_preclk(preclk), i2c_postclk(postclk) {
+    (void)twi; (void)rst_pin;
+    buffer = (uint8_t *)calloc((size_t)w * h / 2, 1);
+  }
+  ~Adafruit_SSD1327() override { free(buffer); delete i2c_dev; }
+
+  bool begin(uint8_t addr = SSD1327_I2C_ADDRESS, bool reset = true) {
+    (void)reset;
+    delete i2c_dev;
+    i2c_dev = new Adafruit_I2CDevice(addr, &Wire);
+    return buffer != nullptr;
+  }
+  void clearDisplay() { memset(buffer, 0, (size_t)WIDTH * HEIGHT / 2); }
+  uint8_t *getBuffer() { return buffer; }
+  void invertDisplay(bool i) { oled_command(i ? 0xA7 : 0xA4); }
+
+  void display() {
+    if (!i2c_dev) return;
+    i2c_dev->setSpeed(i2c_preclk);
+    uint8_t cmd[] = {0x00, SSD1327_SETROW, 0, (uint8_t)(HEIGHT - 1), SSD1327_SETCOLUMN, 0, (uint8_t)(WIDTH / 2 - 1)};
+    i2c_dev->write(cmd, sizeof(cmd));
+    const uint8_t dc = 0x40;
+    const size_t maxData = i2c_dev->maxBufferSize() - 1, total = (size_t)WIDTH * HEIGHT / 2;
+    for (size_t c = 0; c < total; c += maxData)
+      i2c_dev->write(buffer + c, total - c < maxData ? total - c : maxData, true, &dc, 1);
+    i2c_dev->setSpeed(i2c_postclk);
+  }
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+    if (x < 0 || y < 0 || x >= WIDTH || y >= HEIGHT) return;
+    uint8_t &b = buffer[x / 2 + y * (WIDTH / 2)];
+    if (x % 2 == 0) b = (uint8_t)((b & 0x0F) | ((color & 0xF) << 4));
+    else b = (uint8_t)((b & 0xF0) | (color & 0xF));
+  }
+
+  // Mêmes membres protégés que Adafruit_GrayOLED
+ protected:
+  void oled_command(uint8_t c) { if (i2c_dev) { uint8_t b[] = {0x00, c}; i2c_dev->write(b, 2); } }
+  uint8_t *buffer = nullptr;
+  Adafruit_I2CDevice *i2c_dev = nullptr;
+  uint32_t i2c_preclk, i2c_postclk;
+};
@@ -0,0 +1,170 @@
+// -----------------------------------------------------------------------------
+// Shim Arduino pour la build native (env:native)
+// Juste ce dont src/main.cpp a besoin: String, Serial (sur un pseudo-terminal),
+// millis/micros, random, min/max. Pas de prétention à la compatibilité totale.
+// -----------------------------------------------------------------------------
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <ctype.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <type_traits>
+
+// -----------------------------------------------------------------------------
+// Helpers numériques (versions template des macros Arduino)
+// -----------------------------------------------------------------------------
+template <class A, class B>
+static inline typename std::common_type<A, B>::type min(A a, B b) { return (b < a) ? b : a; }
+template <class A, class B>
+static inline typename std::common_type<A, B>::type max(A a, B b) { return (a < b) ? b : a; }
+template <class T, class L, class H>
+static inline T constrain(T v, L lo, H hi) { return v < lo ? (T)lo : (v > hi ? (T)hi : v); }
+
+// -----------------------------------------------------------------------------
+// String: enveloppe std::string avec l'API Arduino utilisée par le firmware
+// -----------------------------------------------------------------------------
+class String {
+ public:
+  String() {}
+  String(const char *s) : s_(s ? s : "") {}
+  String(const std::string &s) : s_(s) {}
+  explicit String(char c) : s_(1, c) {}
+  String(int v) : s_(std::to_string(v)) {}
+  String(unsigned int v) : s_(std::to_string(v)) {}
+  String(long v) : s_(std::to_string(v)) {}
+  String(unsigned long v) : s_(std::to_string(v)) {}
+  String(long long v) : s_(std::to_string(v)) {}
+  String(unsigned long long v) : s_(std::to_string(v)) {}
+  String(float v, unsigned char decimals = 2) { fromDouble(v, decimals); }
+  String(double v, unsigned char decimals = 2) { fromDouble(v, decimals); }
+
+  unsigned int length() const { return (unsigned int)s_.size(); }
+  const char *c_str() const { return s_.c_str(); }
+  bool reserve(unsigned int n) { s_.reserve(n); return true; }
+  char operator[](unsigned int i) const { return i < s_.size() ? s_[i] : 0; }
+  char charAt(unsigned int i) const { return (*this)[i]; }
+
+  String substring(unsigned int from) const { return substring(from, length()); }
+  String substring(unsigned int from, unsigned int to) const {
+    if (from > to) { unsigned int t = from; from = to; to = t; }
+    if (from >= s_.size()) return String();
+    if (to > s_.size()) to = (unsigned int)s_.size();
+    return String(s_.substr(from, to - from));
+  }
+  void trim() {
+    size_t b = 0, e = s_.size();
+    while (b < e && isspace((unsigned char)s_[b])) b++;
+    while (e > b && isspace((unsigned char)s_[e - 1])) e--;
+    s_ = s_.substr(b, e - b);
+  }
+  void toUpperCase() { for (char &c : s_) c = (char)toupper((unsigned char)c); }
+  int indexOf(char c) const { size_t p = s_.find(c); return p == std::string::npos ? -1 : (int)p; }
+  bool startsWith(const String &p) const { return s_.compare(0, p.s_.size(), p.s_) == 0; }
+
+  bool concat(const String &o) { s_ += o.s_; return true; }
+  bool concat(const char *o) { if (o) s_ += o; return true; }
+  bool concat(char c) { s_ += c; return true; }
+
+  String &operator+=(const String &o) { s_ += o.s_; return *this; }
+  String &operator+=(const char *o) { if (o) s_ += o; return *this; }
+  String &operator+=(char c) { s_ += c; return *this; }
+  String &operator+=(int v) { s_ += std::to_string(v); return *this; }
+  String &operator+=(unsigned int v) { s_ += std::to_string(v); return *this; }
+  String &operator+=(long v) { s_ += std::to_string(v); return *this; }
+  String &operator+=(unsigned long v) { s_ += std::to_string(v); return *this; }
+
+  friend String operator+(const String &a, const String &b) { return String(a.s_ + b.s_); }
+  friend String operator+(const String &a, const char *b) { return String(a.s_ + (b ? b : "")); }
+  friend String operator+(const char *a, const String &b) { return String(std::string(a ? a : "") + b.s_); }
+  bool operator==(const String &o) const { return s_ == o.s_; }
+  bool operator!=(const String &o) const { return s_ != o.s_; }
+  bool operator==(const char *o) const { return s_ == (o ? o : ""); }
+
+ private:
+  void fromDouble(double v, unsigned char decimals) {
+    char buf[48];
+    snprintf(buf, sizeof(buf), "%.*f", (int)decimals, v);
+    s_ = buf;
+  }
+  std::string s_;
+};
+
+// -----------------------------------------------------------------------------
+// Print minimal (Serial et l'écran en dérivent)
+// -----------------------------------------------------------------------------
+class Print {
+ public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buf, size_t n) {
+    size_t k = 0; while (n--) k += write(*buf++); return k;
+  }
+  size_t print(const char *s) { return s ? write((const uint8_t *)s, strlen(s)) : 0; }
+  size_t print(const String &s) { return write((const uint8_t *)s.c_str(), s.length()); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int v) { return print(String(v)); }
+  size_t print(unsigned int v) { return print(String(v)); }
+  size_t print(long v) { return print(String(v)); }
+  size_t print(unsigned long v) { return print(String(v)); }
+  size_t print(double v, int d = 2) { return print(String(v, (unsigned char)d)); }
+  size_t println() { return write((uint8_t)'\n'); }
+  template <class T> size_t println(const T &v) { size_t n = print(v); return n + println(); }
+};
+
+// -----------------------------------------------------------------------------
+// Serial: extrémité maître d'un pseudo-terminal (voir native_main.cpp)
+// -----------------------------------------------------------------------------
+class NativeSerial : public Print {
+ public:
+  void begin(unsigned long) {}
+  void setRxBufferSize(size_t n) { rxCap_ = n; }
+  int available();
+  int read();
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t *buf, size_t n) override;
+  void flush() {}
+  operator bool() const { return fd_ >= 0; }
+
+  // Côté build native uniquement
+  void attach(int fd) { fd_ = fd; }
+  int fd() const { return fd_; }
+  size_t buffered() const { return tail_ - head_; }
+  // Harness de simulation: pousse des octets comme s'ils venaient de l'hôte
+  bool inject(const char *s, size_t n);
+
+ private:
+  void pump();
+  int fd_ = -1;
+  // Comme l'USB CDC: au-delà de rxCap_ octets en attente, le reste reste
+  // côté noyau et l'hôte finit par bloquer (contre-pression, pas de perte).
+  size_t rxCap_ = 256;
+  uint8_t rx_[16384];
+  size_t head_ = 0, tail_ = 0;
+};
+
+extern NativeSerial Serial;
+
+// -----------------------------------------------------------------------------
+// Temps, hasard, divers
+// -----------------------------------------------------------------------------
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void yield();
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+int analogRead(uint8_t pin);
+
+// Mesures mémoire pour la télémétrie native (heap malloc et RSS du process)
+uint32_t nativeHeapUsed();
+uint32_t nativeRssKB();
+
+// Points d'entrée du sketch
+void setup();
+void loop();
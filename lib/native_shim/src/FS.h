@@ -0,0 +1,105 @@
+// -----------------------------------------------------------------------------
+// Shim FS (build native): fs::FS / fs::File de l'Arduino ESP32 sur des fichiers
+// de l'hôte, sous le répertoire nativeFsRoot (program --fs DIR, sinon un
+// répertoire temporaire neuf à chaque lancement). Juste l'API du firmware:
+// ouverture r/w/a, lecture, écriture, seek, taille, listage d'un répertoire.
+// -----------------------------------------------------------------------------
+#pragma once
+#include <Arduino.h>
+#include <dirent.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <memory>
+#include <string>
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+extern char nativeFsRoot[256];  // native_main.cpp
+
+namespace fs {
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+class File {
+ public:
+  File() {}
+  File(const std::string &host, const std::string &name, FILE *f, DIR *d)
+      : h_(std::make_shared<Handle>()) {
+    h_->host = host; h_->name = name; h_->f = f; h_->d = d;
+  }
+
+  explicit operator bool() const { return h_ && (h_->f || h_->d); }
+  size_t write(const uint8_t *buf, size_t n) { return h_ && h_->f ? fwrite(buf, 1, n, h_->f) : 0; }
+  size_t read(uint8_t *buf, size_t n) { return h_ && h_->f ? fread(buf, 1, n, h_->f) : 0; }
+  bool seek(uint32_t pos, SeekMode mode = SeekSet) {
+    return h_ && h_->f && fseek(h_->f, (long)pos, mode == SeekSet ? SEEK_SET : mode == SeekCur ? SEEK_CUR : SEEK_END) == 0;
+  }
+  size_t position() const { return h_ && h_->f ? (size_t)ftell(h_->f) : 0; }
+  size_t size() const {
+    if (!h_ || !h_->f) return 0;
+    fflush(h_->f);
+    struct stat st;
+    return fstat(fileno(h_->f), &st) == 0 ? (size_t)st.st_size : 0;
+  }
+  void flush() { if (h_ && h_->f) fflush(h_->f); }
+  void close() { if (h_) h_->close(); }
+  bool isDirectory() const { return h_ && h_->d; }
+  const char *name() const { return h_ ? h_->name.c_str() : ""; }
+
+  // Entrée suivante d'un répertoire (fichiers et sous-répertoires), File vide à la fin
+  File openNextFile() {
+    if (!h_ || !h_->d) return File();
+    while (struct dirent *e = readdir(h_->d)) {
+      if (!strcmp(e->d_name, ".") || !strcmp(e->d_name, "..")) continue;
+      std::string host = h_->host + "/" + e->d_name;
+      struct stat st;
+      if (stat(host.c_str(), &st) != 0) continue;
+      if (S_ISDIR(st.st_mode)) return File(host, e->d_name, nullptr, opendir(host.c_str()));
+      return File(host, e->d_name, fopen(host.c_str(), "rb"), nullptr);
+    }
+    return File();
+  }
+
+ private:
+  struct Handle {
+    std::string host, name;
+    FILE *f = nullptr;
+    DIR *d = nullptr;
+    void close() {
+      if (f) fclose(f);
+      if (d) closedir(d);
+      f = nullptr; d = nullptr;
+    }
+    ~Handle() { close(); }
+  };
+  std::shared_ptr<Handle> h_;
+};
+
+class FS {
+ public:
+  File open(const char *path, const char *mode = FILE_READ) {
+    std::string host = hostPath(path);
+    struct stat st;
+    if (!strcmp(mode, FILE_READ) && stat(host.c_str(), &st) == 0 && S_ISDIR(st.st_mode))
+      return File(host, baseName(path), nullptr, opendir(host.c_str()));
+    const char *m = !strcmp(mode, FILE_WRITE) ? "w+b" : !strcmp(mode, FILE_APPEND) ? "ab" : "rb";
+    FILE *f = fopen(host.c_str(), m);
+    return f ? File(host, baseName(path), f, nullptr) : File();
+  }
+  bool exists(const char *path) { struct stat st; return stat(hostPath(path).c_str(), &st) == 0; }
+  bool mkdir(const char *path) { return ::mkdir(hostPath(path).c_str(), 0755) == 0 || errno == EEXIST; }
+  bool remove(const char *path) { return ::remove(hostPath(path).c_str()) == 0; }
+
+ protected:
+  static std::string hostPath(const char *path) { return std::string(nativeFsRoot) + (path[0] == '/' ? "" : "/") + path; }
+  static std::string baseName(const char *path) {
+    const char *s = strrchr(path, '/');
+    return s ? s + 1 : path;
+  }
+};
+
+}  // namespace fs
+
+using fs::File;
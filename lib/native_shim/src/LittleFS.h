@@ -0,0 +1,19 @@
+// -----------------------------------------------------------------------------
+// Shim LittleFS (build native): le système de fichiers est un répertoire de
+// l'hôte (voir FS.h). Pas de blocs ni d'usure à simuler: seule l'API compte.
+// -----------------------------------------------------------------------------
+#pragma once
+#include <FS.h>
+
+namespace fs {
+class LittleFSFS : public FS {
+ public:
+  bool begin(bool formatOnFail = false) {
+    (void)formatOnFail;
+    return mkdir("/");
+  }
+  void end() {}
+};
+}  // namespace fs
+
+extern fs::LittleFSFS LittleFS;  // native_main.cpp
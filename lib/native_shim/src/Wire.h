@@ -0,0 +1,16 @@
+// Shim Wire (build native): le bus I2C n'existe pas, tout est sans effet.
+#pragma once
+#include <Arduino.h>
+
+class TwoWire {
+ public:
+  bool begin() { return true; }
+  bool begin(int, int) { return true; }
+  void setClock(uint32_t hz) { clock_ = hz; }
+  uint32_t getClock() const { return clock_; }
+
+ private:
+  uint32_t clock_ = 100000;
+};
+
+extern TwoWire Wire;
@@ -0,0 +1,205 @@
+// -----------------------------------------------------------------------------
+// Point d'entrée de la build native
+// Ouvre un pseudo-terminal, annonce son chemin sur stdout ("PTY /dev/pts/N"),
+// puis exécute setup()/loop() comme sur la carte. Le "Serial" du firmware est
+// l'extrémité maître; l'hôte (host_bridge.py --soak) ouvre l'esclave comme un
+// port série ordinaire.
+//
+//   program [--pty-link CHEMIN]   crée aussi un lien symbolique vers l'esclave
+//   program --sim [...]           horloge virtuelle, pas de pty (native_sim.cpp)
+//   program [--fs DOSSIER] [...]  LittleFS dans ce dossier, conservé d'un lancement
+//                                 à l'autre (sinon dossier temporaire effacé en sortie)
+// -----------------------------------------------------------------------------
+#include <Arduino.h>
+#include <Wire.h>
+#include <LittleFS.h>
+#include "sim_probe.h"
+
+#include <chrono>
+#include <random>
+#include <errno.h>
+#include <fcntl.h>
+#include <ftw.h>
+#include <malloc.h>
+#include <poll.h>
+#include <signal.h>
+#include <termios.h>
+#include <unistd.h>
+
+NativeSerial Serial;
+TwoWire Wire;
+uint64_t nativeI2cNs = 0;
+fs::LittleFSFS LittleFS;
+char nativeFsRoot[256] = "";
+
+// -----------------------------------------------------------------------------
+// Serial sur pty
+// -----------------------------------------------------------------------------
+void NativeSerial::pump() {
+  if (fd_ < 0) return;
+  if (head_ == tail_) head_ = tail_ = 0;
+  size_t cap = rxCap_ < sizeof(rx_) ? rxCap_ : sizeof(rx_);
+  if (tail_ - head_ >= cap) return;
+  if (tail_ + (cap - (tail_ - head_)) > sizeof(rx_)) {
+    memmove(rx_, rx_ + head_, tail_ - head_);
+    tail_ -= head_; head_ = 0;
+  }
+  ssize_t n = ::read(fd_, rx_ + tail_, cap - (tail_ - head_));
+  if (n > 0) tail_ += (size_t)n;
+}
+
+bool NativeSerial::inject(const char *s, size_t n) {
+  if (tail_ - head_ + n > sizeof(rx_)) return false;
+  if (tail_ + n > sizeof(rx_)) {
+    memmove(rx_, rx_ + head_, tail_ - head_);
+    tail_ -= head_; head_ = 0;
+  }
+  memcpy(rx_ + tail_, s, n);
+  tail_ += n;
+  return true;
+}
+
+int NativeSerial::available() {
+  if (head_ == tail_) pump();
+  return (int)(tail_ - head_);
+}
+
+int NativeSerial::read() {
+  if (head_ == tail_) pump();
+  if (head_ == tail_) return -1;
+  return rx_[head_++];
+}
+
+size_t NativeSerial::write(const uint8_t *buf, size_t n) {
+  if (fd_ < 0) return 0;
+  size_t done = 0;
+  while (done < n) {
+    ssize_t k = ::write(fd_, buf + done, n - done);
+    if (k > 0) { done += (size_t)k; continue; }
+    // Personne ne lit côté esclave: on jette plutôt que de bloquer la boucle,
+    // comme l'USB CDC quand l'hôte n'a pas ouvert le port.
+    if (k < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EIO)) break;
+    if (k < 0 && errno == EINTR) continue;
+    break;
+  }
+  return done;
+}
+
+// -----------------------------------------------------------------------------
+// Temps, hasard, mémoire
+// -----------------------------------------------------------------------------
+static const auto kBoot = std::chrono::steady_clock::now();
+static std::minstd_rand gRng(1);
+
+unsigned long millis() {
+  return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - kBoot).count();
+}
+unsigned long micros() {
+  return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - kBoot).count();
+}
+void delay(unsigned long ms) { usleep((useconds_t)ms * 1000); }
+void yield() {}
+long random(long howbig) { return howbig <= 0 ? 0 : (long)(gRng() % (unsigned long)howbig); }
+long random(long howsmall, long howbig) { return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall); }
+void randomSeed(unsigned long seed) { gRng.seed(seed ? seed : 1); }
+int analogRead(uint8_t) { return (int)(gRng() & 0x3FF); }
+
+uint32_t nativeHeapUsed() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+  struct mallinfo2 mi = mallinfo2();
+  return (uint32_t)mi.uordblks;
+#else
+  struct mallinfo mi = mallinfo();
+  return (uint32_t)mi.uordblks;
+#endif
+}
+
+uint32_t nativeRssKB() {
+  FILE *f = fopen("/proc/self/statm", "r");
+  if (!f) return 0;
+  unsigned long size = 0, rss = 0;
+  int n = fscanf(f, "%lu %lu", &size, &rss);
+  fclose(f);
+  return n == 2 ? (uint32_t)(rss * (unsigned long)sysconf(_SC_PAGESIZE) / 1024) : 0;
+}
+
+// -----------------------------------------------------------------------------
+// Système de fichiers: un dossier de l'hôte (FS.h)
+// -----------------------------------------------------------------------------
+static int rmEntry(const char *path, const struct stat *, int, struct FTW *) { return ::remove(path); }
+static void rmTempFs() { nftw(nativeFsRoot, rmEntry, 16, FTW_DEPTH | FTW_PHYS); }
+
+static bool fsRootInit(const char *dir) {
+  if (dir) {
+    snprintf(nativeFsRoot, sizeof(nativeFsRoot), "%s", dir);
+    if (::mkdir(dir, 0755) != 0 && errno != EEXIST) { perror(dir); return false; }
+    return true;
+  }
+  snprintf(nativeFsRoot, sizeof(nativeFsRoot), "/tmp/smon_fs.XXXXXX");
+  if (!mkdtemp(nativeFsRoot)) { perror("mkdtemp"); return false; }
+  atexit(rmTempFs);
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+// main
+// -----------------------------------------------------------------------------
+static volatile sig_atomic_t gStop = 0;
+static void onSignal(int) { gStop = 1; }
+
+int main(int argc, char **argv) {
+  const char *link = nullptr, *fsDir = nullptr;
+  bool sim = false;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--sim")) sim = true;
+    if (!strcmp(argv[i], "--pty-link") && i + 1 < argc) link = argv[++i];
+    else if (!strcmp(argv[i], "--fs") && i + 1 < argc) fsDir = argv[++i];
+  }
+  if (!fsRootInit(fsDir)) return 1;
+  if (sim) return simMain(argc, argv);
+
+  int master = posix_openpt(O_RDWR | O_NOCTTY);
+  if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+    perror("posix_openpt");
+    return 1;
+  }
+  const char *slaveName = ptsname(master);
+  // On garde l'esclave ouvert: le maître ne voit pas d'EIO quand l'hôte
+  // ferme/rouvre le port, exactement comme un câble qui reste branché.
+  int slave = open(slaveName, O_RDWR | O_NOCTTY);
+  if (slave < 0) { perror("open pts"); return 1; }
+  struct termios tio;
+  tcgetattr(slave, &tio);
+  cfmakeraw(&tio);
+  tcsetattr(slave, TCSANOW, &tio);
+  fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+  Serial.attach(master);
+
+  if (link) {
+    unlink(link);
+    if (symlink(slaveName, link) != 0) perror("symlink");
+  }
+  printf("PTY %s\n", slaveName);
+  fflush(stdout);
+
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+  signal(SIGPIPE, SIG_IGN);
+
+  setup();
+  while (!gStop) {
+    loop();
+    // Évite de tourner à vide à 100% CPU: attend au plus 1 ms des données.
+    if (Serial.buffered() == 0) {
+      struct pollfd p = {master, POLLIN, 0};
+      poll(&p, 1, 1);
+    }
+  }
+
+  if (link) unlink(link);
+  close(slave);
+  close(master);
+  return 0;
+}
@@ -0,0 +1,348 @@
+// -----------------------------------------------------------------------------
+// Simulation accélérée de la build native (program --sim)
+// Remplace timeSource (include/time_source.h) par une horloge virtuelle et un
+// PRNG à graine fixe, nourrit Serial d'un flux d'entrée scripté et déroule des
+// semaines d'uptime en quelques secondes, sans pty:
+// - entre deux fenêtres, pas grossier (--sim-step ms): une frame par pas;
+// - toutes les --sim-every s, une fenêtre dense de --sim-window s au pas de
+//   1 ms où l'on mesure l'intervalle entre frames, la cadence des clignements
+//   et le délai d'affichage de chaque écran.
+// Le temps de bus I2C compté par le shim avance l'horloge comme une écriture
+// bloquante sur la carte.
+// Par défaut l'horloge démarre une heure avant le passage de millis() par 0 et
+// la première fenêtre est centrée dessus. Même graine = même exécution.
+// Code de sortie 1 si une vérification échoue.
+//
+//   program --sim [--sim-days J] [--sim-seed N] [--sim-start MS] [--sim-step MS]
+//                 [--sim-every S] [--sim-window S] [--sim-heap-kb K] [--sim-verbose]
+//                 [--sim-script FICHIER [--sim-period MS]] [--fs DOSSIER]
+//   program --sim --sim-bench-json N [--sim-script FICHIER]
+//
+// Le script est un fichier de lignes JSON (instantanés et trames typées) rejoué
+// en boucle, une ligne toutes les --sim-period ms. Sans script, un générateur
+// interne envoie chaque seconde un instantané horodaté (noms d'app de longueur
+// aléatoire, rafales réseau) et un lot {"t":"b"} de 20 échantillons, avec une
+// coupure de 30 s toutes les 6 h.
+// -----------------------------------------------------------------------------
+#include <Arduino.h>
+#include <Adafruit_I2CDevice.h>
+#include <time_source.h>
+#include <build_profile.h>
+#include "sim_probe.h"
+
+#include <chrono>
+#include <math.h>
+#include <random>
+#include <string>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Horloge virtuelle
+// -----------------------------------------------------------------------------
+static uint32_t gStartMs = 0;
+static uint64_t gElapsedUs = 0;
+static std::minstd_rand gSimRng(1);
+
+static uint32_t simMs() { return gStartMs + (uint32_t)(gElapsedUs / 1000); }
+static uint32_t simUs() { return (uint32_t)((uint64_t)gStartMs * 1000 + gElapsedUs); }
+static long simRand(long range) { return (long)(gSimRng() % (unsigned long)range); }
+
+// -----------------------------------------------------------------------------
+// Flux d'entrée
+// -----------------------------------------------------------------------------
+#define GEN_BATCH_N 20
+#define GEN_BATCH_DT 50
+#define GEN_GAP_EVERY_MS (6ULL * 3600 * 1000)
+#define GEN_GAP_MS 30000
+#define GEN_EPOCH 1767225600UL // heure de l'hôte au départ (1er janvier 2026)
+
+struct Input {
+  std::vector<std::string> script;
+  size_t next = 0;
+  uint32_t periodMs = 1000;
+  std::mt19937 rng;
+  uint32_t hostT0 = 0;
+  float netMaxOffered = 0;
+  char line[768];
+
+  // Ligne(s) dues à l'instant t (ms virtuelles depuis le départ), poussées dans Serial
+  void feed(uint64_t t) {
+    if (!script.empty()) {
+      const std::string &s = script[next++ % script.size()];
+      push(s.c_str(), s.size());
+      return;
+    }
+    if (t % GEN_GAP_EVERY_MS >= GEN_GAP_EVERY_MS - GEN_GAP_MS) { hostT0 += periodMs; return; }
+    push(line, snapshot(t));
+
+    // Lot rapide contigu au précédent (t0 hôte enchaîné comme BatchFramer)
+    int n = snprintf(line, sizeof(line), "{\"t\":\"b\",\"t0\":%lu,\"dt\":%d,\"cpu\":\"",
+                     (unsigned long)hostT0, GEN_BATCH_DT);
+    for (int k = 0; k < GEN_BATCH_N; k++) n += snprintf(line + n, sizeof(line) - n, "%02x", (unsigned)(rng() % 101));
+    n += snprintf(line + n, sizeof(line) - n, "\"}\n");
+    push(line, (size_t)n);
+    hostT0 += GEN_BATCH_N * GEN_BATCH_DT;
+  }
+
+  // Instantané généré pour l'instant t, écrit dans line; retourne sa longueur
+  size_t snapshot(uint64_t t) {
+    std::uniform_real_distribution<float> u(0.0f, 1.0f);
+    float cpu = 35 + 30 * sinf((float)(t % 3600000) / 3600000.0f * 6.2832f) + 20 * u(rng);
+    long ramTot = 16384 * 1024L, ramUsed = (long)(ramTot * (0.4f + 0.3f * u(rng)));
+    float rx = u(rng) < 0.05f ? 20000 * u(rng) : 200 * u(rng), tx = 50 * u(rng);
+    if (rx + tx > netMaxOffered) netMaxOffered = rx + tx;
+    char app[32];
+    int len = 1 + (int)(rng() % (sizeof(app) - 2));
+    for (int i = 0; i < len; i++) app[i] = (char)('a' + rng() % 26);
+    app[len] = 0;
+    int n = snprintf(line, sizeof(line),
+                     "{\"cpu\":%.1f,\"ram\":%ld,\"ram_used\":%ld,\"cpu_max\":%.1f,\"app\":\"%s\","
+                     "\"host\":\"sim\",\"uptime\":%lu,\"time\":%lu,\"net\":{\"rx\":%.1f,\"tx\":%.1f},"
+                     "\"disks\":[{\"id\":\"/\",\"free\":51200,\"size\":256000}],"
+                     "\"nics\":[{\"id\":\"en0\",\"rx\":%.1f,\"tx\":%.1f}]}\n",
+                     cpu, ramTot, ramUsed, cpu + 5, app, (unsigned long)(t / 1000),
+                     (unsigned long)(GEN_EPOCH + t / 1000), rx, tx, rx, tx);
+    return (size_t)n;
+  }
+
+  void push(const char *s, size_t n) {
+    Serial.inject(s, n);
+    if (n && s[n - 1] != '\n') Serial.inject("\n", 1);
+  }
+};
+
+static bool loadScript(const char *path, std::vector<std::string> &out) {
+  FILE *f = fopen(path, "r");
+  if (!f) { perror(path); return false; }
+  char buf[4096];
+  while (fgets(buf, sizeof(buf), f)) {
+    std::string s(buf);
+    while (!s.empty() && (s.back() == '\n' || s.back() == '\r')) s.pop_back();
+    if (!s.empty() && s[0] != '#') out.push_back(s);
+  }
+  fclose(f);
+  if (out.empty()) fprintf(stderr, "%s: aucune ligne\n", path);
+  return !out.empty();
+}
+
+// -----------------------------------------------------------------------------
+// Mesures d'une fenêtre dense
+// -----------------------------------------------------------------------------
+struct Window {
+  uint32_t frames = 0, blinks = 0, maxIntervalMs = 0, minIntervalMs = UINT32_MAX;
+  uint64_t lastFrameT = 0;
+  bool haveFrame = false, lastBlink = false;
+  uint32_t lastFrames = 0;
+  uint64_t lagFrom = 0;       // délais mesurés après la mise en régime (pas grossier -> 1 ms)
+  uint16_t lagMs[2] = {0, 0};
+
+  void start(const SimProbe &p, uint64_t t) {
+    *this = Window();
+    lastFrames = p.frames; lastBlink = p.blink;
+    lagFrom = t + 1000;
+  }
+  void sample(const SimProbe &p, uint64_t t) {
+    for (int i = 0; i < 2; i++) if (t >= lagFrom && p.lagMs[i] > lagMs[i]) lagMs[i] = p.lagMs[i];
+    if (p.frames != lastFrames) {
+      lastFrames = p.frames;
+      frames++;
+      if (haveFrame) {
+        uint32_t d = (uint32_t)(t - lastFrameT);
+        if (d > maxIntervalMs) maxIntervalMs = d;
+        if (d < minIntervalMs) minIntervalMs = d;
+      }
+      haveFrame = true;
+      lastFrameT = t;
+    }
+    if (p.blink && !lastBlink) blinks++;
+    lastBlink = p.blink;
+  }
+};
+
+static int gFailures = 0;
+static void check(bool ok, const char *what, uint64_t t, const char *fmt, double a, double b) {
+  if (ok) return;
+  gFailures++;
+  char detail[96];
+  snprintf(detail, sizeof(detail), fmt, a, b);
+  printf("[sim] FAIL %s at %.2f h (millis %lu): %s\n", what, t / 3600000.0,
+         (unsigned long)(gStartMs + (uint32_t)t), detail);
+}
+
+// -----------------------------------------------------------------------------
+// Banc JSON (--sim-bench-json N): chemin rapide contre ArduinoJson
+// Les lignes (script, sinon jusqu'à 1000 instantanés du générateur) sont d'abord lues une
+// fois par chaque chemin: même résultat exigé dès que le chemin rapide accepte.
+// Puis N lectures par chemin, chronométrées.
+// -----------------------------------------------------------------------------
+static int benchJson(Input &in, uint32_t n) {
+  std::vector<std::string> lines = in.script;
+  for (uint32_t i = 0; lines.size() < n && lines.size() < 1000 && in.script.empty(); i++) {
+    size_t len = in.snapshot((uint64_t)i * 1000);
+    while (len && in.line[len - 1] == '\n') len--;
+    lines.push_back(std::string(in.line, len));
+  }
+  static char fast[2048], generic[2048];
+  uint32_t accepted = 0, fallback = 0;
+  for (const std::string &l : lines) {
+    const bool f = simParseLine(l.c_str(), (uint16_t)l.size(), false, fast, sizeof(fast));
+    const bool g = simParseLine(l.c_str(), (uint16_t)l.size(), true, generic, sizeof(generic));
+    if (!f) { fallback++; continue; }
+    accepted++;
+    if (!g || strcmp(fast, generic)) {
+      gFailures++;
+      printf("[bench] FAIL %s\n  fast    %s\n  generic %s\n", l.c_str(), fast, g ? generic : "(refusée)");
+    }
+  }
+  double ns[2];
+  for (int generic = 0; generic < 2; generic++) {
+    const auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < n; i++) {
+      const std::string &l = lines[i % lines.size()];
+      simParseLine(l.c_str(), (uint16_t)l.size(), generic, nullptr, 0);
+    }
+    ns[generic] = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / n;
+  }
+  printf("[bench] %u line(s), %u fast, %u fallback, %d mismatch(es)\n", (unsigned)lines.size(),
+         (unsigned)accepted, (unsigned)fallback, gFailures);
+  printf("[bench] fast %.0f ns/line (%.0f lines/s), ArduinoJson %.0f ns/line (%.0f lines/s), x%.1f\n", ns[0],
+         1e9 / ns[0], ns[1], 1e9 / ns[1], ns[1] / ns[0]);
+  return gFailures ? 1 : 0;
+}
+
+// -----------------------------------------------------------------------------
+// Entrée
+// -----------------------------------------------------------------------------
+int simMain(int argc, char **argv) {
+  double days = 7;
+  bool verbose = false;
+  unsigned long seed = 1;
+  uint32_t stepMs = 500, everyS = 3600, windowS = 60, heapKB = 16;
+  gStartMs = 0xFFFFFFFFUL - 3600000UL + 1;
+  uint32_t benchN = 0;
+  const char *scriptPath = nullptr;
+  Input in;
+  for (int i = 1; i < argc; i++) {
+    const char *a = argv[i];
+    const char *v = i + 1 < argc ? argv[i + 1] : nullptr;
+    if (!strcmp(a, "--sim")) continue;
+    if (!strcmp(a, "--sim-verbose")) { verbose = true; continue; }
+    if (!v) { fprintf(stderr, "%s: valeur manquante\n", a); return 2; }
+    if (!strcmp(a, "--sim-days")) days = atof(v);
+    else if (!strcmp(a, "--sim-seed")) seed = strtoul(v, nullptr, 0);
+    else if (!strcmp(a, "--sim-start")) gStartMs = (uint32_t)strtoul(v, nullptr, 0);
+    else if (!strcmp(a, "--sim-step")) stepMs = (uint32_t)atoi(v);
+    else if (!strcmp(a, "--sim-every")) everyS = (uint32_t)atoi(v);
+    else if (!strcmp(a, "--sim-window")) windowS = (uint32_t)atoi(v);
+    else if (!strcmp(a, "--sim-heap-kb")) heapKB = (uint32_t)atoi(v);
+    else if (!strcmp(a, "--sim-script")) scriptPath = v;
+    else if (!strcmp(a, "--sim-period")) in.periodMs = (uint32_t)atoi(v);
+    else if (!strcmp(a, "--sim-bench-json")) benchN = (uint32_t)atoi(v);
+    else if (!strcmp(a, "--fs")) {} // LittleFS, lu par main()
+    else { fprintf(stderr, "option inconnue: %s\n", a); return 2; }
+    i++;
+  }
+  if (stepMs == 0 || in.periodMs == 0 || windowS == 0 || everyS <= windowS) {
+    fprintf(stderr, "--sim-step/--sim-period/--sim-window > 0 et --sim-every > --sim-window\n");
+    return 2;
+  }
+  if (scriptPath && !loadScript(scriptPath, in.script)) return 2;
+  if (benchN) {
+    in.rng.seed((uint32_t)seed);
+    return benchJson(in, benchN);
+  }
+
+  gSimRng.seed(seed);
+  in.rng.seed((uint32_t)seed);
+  in.hostT0 = (uint32_t)seed * 7919u;
+  timeSource = { simMs, simUs, simRand };
+
+  const uint64_t endMs = (uint64_t)(days * 86400000.0);
+  const uint64_t everyMs = (uint64_t)everyS * 1000, windowMs = (uint64_t)windowS * 1000;
+  // Fenêtres centrées sur k * every (la première sur le passage par 0 par défaut)
+  uint64_t winStart = everyMs - windowMs / 2;
+  bool inWindow = false;
+  uint64_t nextInput = 0;
+  uint32_t windows = 0, heapBase = 0, heapPeak = 0;
+  Window w;
+  SimProbe p = {};
+
+  const uint32_t frameMs = Profile::frameMs;
+  // Une frame peut attendre la fin d'une tranche de flush (au plus une page de plus)
+  const uint32_t pageUs = (uint32_t)(143ULL * 9000000ULL / Profile::i2cHz);
+  const uint32_t jitterMs = (Profile::flushSliceUs + pageUs) / 1000 + 1;
+  const double expFrames = (double)windowMs / frameMs;
+  // Clignement toutes les 2000 + (now % 3000) ms, plus une frame de quantification
+  const double minBlinks = (double)windowMs / (5000 + 2 * frameMs) - 1;
+  const double maxBlinks = (double)windowMs / 2000 + 1;
+
+  const auto wall0 = std::chrono::steady_clock::now();
+  printf("[sim] profile %s, %.1f days from millis %lu, seed %lu%s\n", Profile::name(), days,
+         (unsigned long)gStartMs, seed, scriptPath ? ", scripted input" : "");
+  setup();
+
+  uint64_t t = 0, busNs = nativeI2cNs;
+  uint32_t steps = 0;
+  while (t < endMs) {
+    while (nextInput <= t) { in.feed(nextInput); nextInput += in.periodMs; }
+    loop();
+    simProbe(p);
+    // Écritures I2C bloquantes: leur durée passe sur l'horloge virtuelle
+    uint64_t busUs = (nativeI2cNs - busNs) / 1000;
+    busNs += busUs * 1000;
+    gElapsedUs += busUs;
+
+    if (!inWindow && t >= winStart) { inWindow = true; w.start(p, t); }
+    if (inWindow) {
+      w.sample(p, t);
+      if (t + 1 >= winStart + windowMs) {
+        inWindow = false;
+        windows++;
+        uint32_t heap = nativeHeapUsed();
+        if (heap > heapPeak) heapPeak = heap;
+        if (windows == 1) heapBase = heap; // après échauffement
+        check(fabs(w.frames - expFrames) <= expFrames * 0.05, "frame count", t, "%.0f frames, expected %.0f",
+              w.frames, expFrames);
+        check(w.maxIntervalMs <= frameMs + jitterMs && w.minIntervalMs + jitterMs >= frameMs, "frame interval", t,
+              "max %.0f ms, min %.0f ms", w.maxIntervalMs, w.minIntervalMs);
+        check(w.lagMs[0] <= p.lagBudgetMs[0], "main panel lag", t, "%.0f ms, budget %.0f ms", w.lagMs[0],
+              p.lagBudgetMs[0]);
+        check(w.lagMs[1] <= p.lagBudgetMs[1], "history panel lag", t, "%.0f ms, budget %.0f ms", w.lagMs[1],
+              p.lagBudgetMs[1]);
+        check(w.blinks >= minBlinks && w.blinks <= maxBlinks, "blink cadence", t, "%.0f blinks, min %.0f",
+              w.blinks, minBlinks);
+        check(heap <= heapBase + heapKB * 1024, "heap growth", t, "%.0f B over %.0f B", heap - (double)heapBase,
+              heapKB * 1024.0);
+        check(isfinite(p.netMaxKBs) && p.netMaxKBs >= 1 &&
+                  (!in.script.empty() || p.netMaxKBs <= in.netMaxOffered + 1),
+              "net scale", t, "%.1f KB/s, offered max %.1f", p.netMaxKBs, in.netMaxOffered);
+        check(in.script.size() || p.liveQueued <= 2 * GEN_BATCH_N, "live backlog", t, "%.0f queued, max %.0f",
+              p.liveQueued, 2 * GEN_BATCH_N);
+        const uint32_t a = gStartMs + (uint32_t)winStart;
+        // Une ligne par jour, plus la fenêtre du passage par 0 (toutes avec --sim-verbose)
+        if (verbose || windows % 24 == 1 || (uint32_t)(a + windowMs) < a)
+          printf("[sim] %6.2f h  %u fr  interval %u..%u ms  lag %u/%u ms  %u blinks  heap %u B\n",
+                 t / 3600000.0, (unsigned)w.frames, (unsigned)w.minIntervalMs, (unsigned)w.maxIntervalMs,
+                 (unsigned)w.lagMs[0], (unsigned)w.lagMs[1], (unsigned)w.blinks, (unsigned)heap);
+        winStart += everyMs;
+      }
+      gElapsedUs += 1000;
+    } else {
+      gElapsedUs += (uint64_t)stepMs * 1000;
+      if (gElapsedUs > winStart * 1000) gElapsedUs = winStart * 1000;
+      if ((++steps & 1023) == 0) {
+        uint32_t heap = nativeHeapUsed();
+        if (heap > heapPeak) heapPeak = heap;
+      }
+    }
+    t = gElapsedUs / 1000;
+  }
+
+  double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall0).count();
+  check(heapPeak <= heapBase + heapKB * 1024, "heap high-water", t, "%.0f B over %.0f B",
+        heapPeak - (double)heapBase, heapKB * 1024.0);
+  printf("[sim] %.1f days in %.1f s, %u windows, %lu frames, I2C busy %.1f%%, heap %u B (peak +%d B), "
+         "%d failure(s)\n", t / 86400000.0, wall, (unsigned)windows, (unsigned long)p.frames,
+         nativeI2cNs / 1e4 / (double)(t ? t : 1), (unsigned)heapBase, (int)(heapPeak - heapBase), gFailures);
+  return gFailures ? 1 : 0;
+}
@@ -0,0 +1,23 @@
+// -----------------------------------------------------------------------------
+// Sonde du harness de simulation (build native, program --sim)
+// Le firmware expose ici l'état que le harness vérifie à chaque pas; rien de
+// ceci n'existe sur la carte.
+// -----------------------------------------------------------------------------
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+struct SimProbe {
+  uint32_t frames;     // display() effectués
+  bool blink;          // clignement en cours
+  bool sleeping;       // tamagochi endormi
+  float netMaxKBs;     // auto-échelle réseau
+  uint8_t liveQueued;  // échantillons rapides en attente
+  uint16_t lagMs[2];   // pire délai commit -> écran à jour depuis la sonde précédente (écran principal, historique)
+  uint16_t lagBudgetMs[2];  // délai visé par écran (latence donnée au planificateur)
+};
+
+void simProbe(SimProbe &p);  // défini dans src/main.cpp
+// Une ligne d'instantané ou de delta lue seule, chemin rapide ou ArduinoJson (src/main.cpp)
+bool simParseLine(const char *line, uint16_t len, bool generic, char *digest, size_t cap);
+int simMain(int argc, char **argv);  // native_sim.cpp
@@ -6,6 +6,25 @@
 #include <Adafruit_GFX.h>
 #include <Adafruit_SH110X.h>
 #include <ArduinoJson.h>
+#include <LittleFS.h>
+#include "build_profile.h"
+#include "time_source.h"
+#include "history.h"
+#include "window_stats.h"
+#include "alert_rules.h"
+#include "sample_queue.h"
+#include "fixed_containers.h"
+#include "panel.h"
+#include "raster.h"
+#include "font.h"
+#include "host_frame.h"
+#include "page_roll.h"
+#include "rrd_store.h"
+#include "json_scan.h"
+#include "snap_delta.h"
+#if SMON_PANEL_SSD1327
+#include "panel_ssd1327.h"
+#endif
 #if defined(ARDUINO_ARCH_ESP32)
 #include <esp_system.h>
 #endif
@@ -18,30 +37,104 @@
 #define OLED_RESET -1
 #define I2C_ADDRESS 0x3C  // Adresse 7-bit (0x78 >> 1)
 
-// Ecran SH1106 1.3"
-Adafruit_SH1106G display = Adafruit_SH1106G(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
+// Ecran principal (jauges, tamagochi, ticker): SH1106 1.3" 1 bit, ou avec
+// -D SMON_PANEL_SSD1327=1 un SSD1327 128x128 16 niveaux (même mise en page en
+// haut, historique en bas). Si -D SMON_PANEL2_ADDR=0x3D, un SH1106 de plus sur
+// le même bus pour l'historique. Les frames ne sont pas envoyées d'un bloc:
+// flusher pousse les bandes modifiées par tranches entre deux loop().
+typedef PagedSH1106<SCREEN_WIDTH, SCREEN_HEIGHT> MonoPanel;
+typedef Raster<Mono1Page<SCREEN_WIDTH, SCREEN_HEIGHT> > MonoSurface;
+#if SMON_PANEL_SSD1327
+#define PANEL_HEIGHT 128
+// 4 bits par pixel à 400 kHz: le ticker et le décalage de l'historique
+// dépassent une frame de bus, l'écran a donc deux frames pour se mettre à jour
+#define PANEL_LATENCY_MS (2 * Profile::frameMs)
+typedef BandedSSD1327<SCREEN_WIDTH, PANEL_HEIGHT> Panel;
+typedef Raster<Gray4<SCREEN_WIDTH, PANEL_HEIGHT> > Surface;
+#else
+#define PANEL_HEIGHT SCREEN_HEIGHT
+#define PANEL_LATENCY_MS Profile::frameMs
+typedef MonoPanel Panel;
+typedef MonoSurface Surface;
+#endif
+Panel display(&Wire, OLED_RESET, Profile::i2cHz, 2, PANEL_LATENCY_MS);
+static Surface gfx;          // spans, cadres, barres et visage, directement dans le tampon de display
+#define INK Surface::kInk    // blanc: 1 sur SH1106, 15 sur SSD1327
+#define PAPER 0
+#ifdef SMON_PANEL2_ADDR
+MonoPanel histPanel(&Wire, OLED_RESET, Profile::i2cHz, 1, Profile::histFrameMs);
+static MonoSurface histGfx;
+static bool histOk = false;
+#endif
+static FlushScheduler<2> flusher;
+
+// Frames rendues par l'hôte (include/host_frame.h), SH1106 seulement: le
+// SSD1327 garde le rendu local. Sans frame depuis HOSTFB_TIMEOUT_MS, retour au rendu local.
+#define HOSTFB_TIMEOUT_MS 1500
+#define HOSTFB_KEY_RETRY_MS 250 // délai minimal entre deux demandes de keyframe
+#if SMON_PANEL_SSD1327
+static constexpr bool kHostFrames = false;
+#else
+static constexpr bool kHostFrames = Profile::hostFrames;
+#endif
+static HostFrameSink hostFb(HOSTFB_TIMEOUT_MS);
+
+// Instantanés en delta (include/snap_delta.h), proposés dans le hello
+#define DELTA_KEY_RETRY_MS 1000 // délai minimal entre deux demandes de keyframe
+static constexpr bool kDeltaIngest = Profile::deltaIngest;
+static DeltaSync deltaSync;
+
+// Pages de l'écran principal (vue d'ensemble, historique, processus, réseau),
+// choisies par {"cmd":"page"} ou tour à tour; on passe de l'une à l'autre en
+// faisant défiler la ligne de départ du SH1106 (include/page_roll.h). Le SSD1327
+// garde une seule page (l'historique est déjà sous la vue d'ensemble).
+#define PAGE_ROLL_MS 600
+#if SMON_PANEL_SSD1327
+static constexpr bool kUiPages = false;
+#else
+static constexpr bool kUiPages = Profile::uiPages;
+#endif
+static PageRoll<SCREEN_WIDTH, SCREEN_HEIGHT> pageRoll(PAGE_ROLL_MS);
+
+// Temps et aléa (include/time_source.h): matériel par défaut, remplaçables en simulation
+static uint32_t hwMs() { return (uint32_t)millis(); }
+static uint32_t hwUs() { return (uint32_t)micros(); }
+static long hwRand(long range) { return random(range); }
+TimeSource timeSource = { hwMs, hwUs, hwRand };
 
 // -----------------------------------------------------------------------------
 // Helpers d'affichage
 // -----------------------------------------------------------------------------
-static int textWidth(const String &s, uint8_t size = 1) {
-  return s.length() * 6 * size; // 5px glyph + 1px espacement
+// Police proportionnelle (include/font.h); largeurs des chaînes de chaque frame en cache
+static WidthCache<8> widthCache;
+
+static int textWidth(const String &s) {
+  return widthCache.measure(s.c_str(), s.length());
+}
+
+template <class Surf>
+static int drawText(Surf &surf, int x, int y, const String &s, uint8_t ink = Surf::kInk) {
+  return fontDraw(surf, x, y, s.c_str(), s.length(), ink);
 }
 
-static void printRightAligned(int xRight, int y, const String &s) {
-  int w = textWidth(s, 1);
-  display.setCursor(xRight - w, y);
-  display.print(s);
+template <class Surf>
+static void printRightAligned(Surf &surf, int xRight, int y, const String &s) {
+  drawText(surf, xRight - textWidth(s), y, s);
 }
 
 // Formatage rapide de valeurs
 static String fmtPercent(int v) { return String(v) + "%"; }
 static String fmtTempC(int t) { return String(t) + "C"; }
-static String fmtDisk(long kb) {
-  if (kb < 0) return String("--");
-  long mb = kb / 1024;
-  if (mb > 9999) return String((int)(mb / 1024)) + "GB";
-  return String((int)mb) + "MB";
+static String fmtDiskMB(uint32_t mb) {
+  if (mb > 9999) return String((unsigned long)(mb / 1024)) + "GB";
+  return String((unsigned long)mb) + "MB";
+}
+static String fmtValue(float v) {
+  if (isnan(v)) return String("--");
+  float a = fabsf(v);
+  if (a >= 100000) return String((long)(v / 1000)) + "k";
+  if (a >= 100 || v == (long)v) return String((long)v);
+  return String(v, 1);
 }
 static String fmtUptime(long seconds) {
   if (seconds < 0) return String("--");
@@ -49,164 +142,1293 @@ static String fmtUptime(long seconds) {
   String s; if (d > 0) { s += d; s += "d "; } s += h; s += "h"; s += m; s += "m"; return s;
 }
 
-// Tronquer une chaîne pour tenir dans une largeur en pixels
-static String clipToWidth(const String &s, int pxWidth) {
-  int maxChars = pxWidth / 6; if (maxChars < 0) maxChars = 0;
-  if ((int)s.length() <= maxChars) return s;
-  return s.substring(0, maxChars);
-}
-
 // -----------------------------------------------------------------------------
 // Style rétro Windows: panneaux en relief et barres compactes
 // -----------------------------------------------------------------------------
 static void drawSunkenPanel(int x, int y, int w, int h) {
   // Double bordure pour simuler un relief enfoncé (style Win95 monocrome)
-  display.drawRect(x, y, w, h, SH110X_WHITE);
-  if (w > 2 && h > 2) display.drawRect(x + 1, y + 1, w - 2, h - 2, SH110X_WHITE);
+  gfx.rect(x, y, w, h, INK);
+  if (w > 2 && h > 2) gfx.rect(x + 1, y + 1, w - 2, h - 2, INK);
 }
 
 static void drawProgressBar95(int x, int y, int w, int h, float ratio) {
   if (ratio < 0) ratio = 0; if (ratio > 1) ratio = 1;
   drawSunkenPanel(x, y, w, h);
   int iw = w - 4; int ih = h - 4; if (iw < 1 || ih < 1) return;
-  int fw = (int)(iw * ratio + 0.5f);
-  if (fw > 0) display.fillRect(x + 2, y + 2, fw, ih, SH110X_WHITE);
+  gfx.fillRectAA(x + 2, y + 2, iw * ratio, ih);
 }
 
 // -----------------------------------------------------------------------------
 // Etat des données et UI (séparés pour lisibilité)
 // -----------------------------------------------------------------------------
+// Entrées des tableaux du payload ("disks", "nics"), identifiées par un id court
+#define ID_LEN 8
+#define DISKS_MAX 4
+#define NICS_MAX 4
+#define PROCS_MAX 4
+#define PROC_NAME_LEN 15
+struct DiskEntry {
+  FixedString<ID_LEN> id;   // point de montage abrégé ("/", "home", "C:")
+  uint32_t freeMB = 0;
+  uint32_t sizeMB = 0;
+};
+struct NicEntry {
+  FixedString<ID_LEN> id;   // nom d'interface
+  float rx = NAN, tx = NAN; // KB/s
+};
+struct ProcEntry {
+  FixedString<PROC_NAME_LEN> id; // nom du processus
+  float cpu = 0;                 // % d'un cœur
+};
+
 struct DataState {
-  float cpu = -1;           // 0..100
-  long ram = -1;            // KB
-  long ram_used = -1;       // KB
+  // Types de largeur fixe, regroupés par taille (pas de bourrage); voir tools/size_report.py
+  float cpu = -1;           // 0..100 (moyenne sur l'intervalle d'envoi)
+  float cpuMax = -1;        // pic de l'intervalle
+  float cpuP95 = -1;        // p95 de l'intervalle
   float tempC = NAN;        // °C
-  String weatherDesc = "";
-  String host = "";
-  long epoch = 0;           // s
-  long uptime = -1;         // s
-  long diskFreeKB = -1;     // KB
   float net_rx = NAN;       // KB/s
   float net_tx = NAN;       // KB/s
+  int32_t ram = -1;         // KB
+  int32_t ram_used = -1;    // KB
+  int32_t ramMax = -1;      // KB, pic de l'intervalle
+  int32_t uptime = -1;      // s
+  int32_t diskFreeMB = -1;  // MB (reçu en KB: un int32 en KB déborde à 2 To)
+  uint32_t epoch = 0;       // s
+  FixedString<31> weatherDesc;
+  StaticVector<DiskEntry, DISKS_MAX> disks;
+  StaticVector<NicEntry, NICS_MAX> nics;
+  StaticVector<ProcEntry, PROCS_MAX> procs; // processus les plus actifs (page "procs")
 };
 
+// Troncatures cumulées: entrées au-delà de la capacité, ids raccourcis
+struct TruncCounters {
+  uint32_t disks = 0;
+  uint32_t nics = 0;
+  uint32_t procs = 0;
+  uint32_t ids = 0;
+};
+static TruncCounters truncs;
+
+// Champs additionnels de l'ingest du bridge ("x": {"nom": valeur}), affichés dans le ticker
+#define EXTRA_MAX 8
+// Glyphes du ticker (tous champs au maximum: ~300); au-delà la fin est coupée
+#define TICKER_GLYPHS 320
+struct ExtraField {
+  char name[16];
+  float value;
+};
+static ExtraField extras[EXTRA_MAX];
+static uint8_t extraCount = 0;
+
 struct UIState {
-  bool hasData = false;
   // cibles
-  float tgtCpu = 0, tgtRamRatio = 0, tgtNetRatio = 0;
+  float tgtCpu = 0, tgtRamRatio = 0, tgtRxRatio = 0, tgtTxRatio = 0;
   // courants (animés)
-  float curCpu = 0, curRamRatio = 0, curNetRatio = 0;
-  float netMaxKBs = 1; // auto-échelle pour net
-
-  // ticker bas
-  String tickerText = "";
-  int tickerX = SCREEN_WIDTH;
-  int tickerW = 1;
-  int gaugesBottomY = 0; // position Y après les jauges
-
-  // Animation Tamagochi
-  bool tamaBlink = false;
-  unsigned long tamaBlinkUntil = 0;
-  unsigned long tamaNextBlink = 0;
+  float curCpu = 0, curRamRatio = 0, curRxRatio = 0, curTxRatio = 0;
+  float netMaxKBs = 1;       // auto-échelle réseau commune à RX et TX (Ko/s)
+  uint32_t netScaleMs = 0;   // dernier pas de décroissance de l'échelle
+  uint32_t pageUntil = 0;
+  // Marqueurs de pic (peak-hold): maintenus puis décroissent vers la valeur courante
+  float cpuPeak = 0, ramPeakRatio = 0;
+  uint32_t cpuPeakUntil = 0, ramPeakUntil = 0;
+
+  // Échéances des animations Tamagochi
+  uint32_t tamaBlinkUntil = 0;
+  uint32_t tamaNextBlink = 0;
+  uint32_t tamaMouthMs = 0;
+  uint32_t tamaWinkUntil = 0;
+  uint32_t tamaSweatUntil = 0;
+  uint32_t lowLoadSince = 0;
+  uint32_t sleepMs = 0;
+
+  // ticker bas (déjà décodé en glyphes)
+  GlyphString<TICKER_GLYPHS> ticker;
+  int16_t tickerX = SCREEN_WIDTH;
+  int16_t tickerW = 1;
+  int16_t gaugesBottomY = 0; // position Y après les jauges
+
   uint8_t tamaMouthPhase = 0; // 0..3
-  unsigned long tamaMouthMs = 0;
-  // Animations mignonnes
-  bool tamaWink = false;            // clin d'œil
-  unsigned long tamaWinkUntil = 0;
-  bool tamaSweat = false;           // goutte de sueur
-  unsigned long tamaSweatUntil = 0;
-  int8_t headBob = 0;               // petit mouvement vertical
-  // Sommeil
-  bool tamaSleeping = false;
-  unsigned long lowLoadSince = 0;
   uint8_t sleepStep = 0;
-  unsigned long sleepMs = 0;
+  int8_t headBob = 0;         // petit mouvement vertical
+
+  // Drapeaux: un bit chacun
+  bool hasData : 1;
+  bool netLog : 1;        // échelle logarithmique ({"cmd":"net","scale":"log"})
+  bool netPage : 1;       // colonne gauche: page RX/TX au lieu de CPU/RAM
+  bool tamaBlink : 1;
+  bool tamaWink : 1;      // clin d'œil
+  bool tamaSweat : 1;     // goutte de sueur
+  bool tamaSleeping : 1;  // sommeil
+  bool lowLoad : 1;
+
+  UIState() : hasData(false), netLog(false), netPage(false), tamaBlink(false), tamaWink(false),
+              tamaSweat(false), tamaSleeping(false), lowLoad(false) {}
 };
 
+// Peak-hold des jauges: durée de maintien puis vitesse de retombée (fraction de la barre par seconde)
+#define PEAK_HOLD_MS 1500
+#define PEAK_DECAY_PER_S 0.25f
+
 static DataState data;
 static UIState ui;
-static String appName = ""; // Ajout de la variable globale appName
+static GlyphString<48> appTitle; // nom de l'app au premier plan (header), décodé à la réception
+
+// Pages de l'écran principal: {"cmd":"page","p":"net"} en montre une, "cycle" les fait tourner
+enum UiPage : uint8_t { PAGE_OVERVIEW, PAGE_HISTORY, PAGE_PROCS, PAGE_NET, PAGE_COUNT };
+static const char *const kPageNames[PAGE_COUNT] = {"overview", "history", "procs", "net"};
+struct PageNav {
+  uint32_t cycleMs = 0;   // rotation, 0 = arrêtée
+  uint32_t nextMs = 0;    // échéance de la page suivante
+  uint32_t switches = 0;  // transitions effectuées
+  uint8_t shown = PAGE_OVERVIEW;
+  uint8_t want = PAGE_OVERVIEW;
+};
+static PageNav pages;
+
+// Historique: 120 créneaux d'une minute (2 h), rempli par le backlog hôte à la reconnexion
+#define HIST_SLOTS Profile::histSlots
+#define HIST_SLOT_MS 60000UL
+#define FW_PROTO 1
+static SlotHistory<HIST_SLOTS, HIST_SLOT_MS> history;
+
+// Historique en flash (include/rrd_store.h): chaque instantané horodaté ("time")
+// y entre; au premier, les créneaux vides de history sont repris du niveau 1m
+// (ce qui a précédé le reset), puis le backlog du bridge complète.
+static RrdStore rrd;
+static bool rrdSeeded = false;
+static_assert(HIST_SLOT_MS == RRD_M1_S * 1000UL, "créneaux de history = niveau 1m");
+
+static uint8_t rrdPct(int16_t v) {
+  if (v == kRrdNone) return HistSlot::kEmpty;
+  const long p = lroundf(rrdDecode(RRD_CPU, v));
+  return (uint8_t)(p < 0 ? 0 : p > 100 ? 100 : p);
+}
+
+static void rrdSeedHistory(uint32_t epoch) {
+  RrdAgg buf[8];
+  RrdPos p = rrd.m1.seek(epoch - (uint32_t)(HIST_SLOTS + 1) * RRD_M1_S);
+  while (uint16_t n = rrd.m1.read(p, epoch, buf, 8)) {
+    for (uint16_t i = 0; i < n; i++) {
+      const RrdAgg &a = buf[i];
+      if (a.t + RRD_M1_S > epoch || a.avg[RRD_CPU] == kRrdNone) continue; // créneau pas encore clos
+      const uint32_t age = (epoch - a.t - RRD_M1_S) / RRD_M1_S;
+      if (age >= HIST_SLOTS || !history.at((uint16_t)age).empty()) continue;
+      history.set((uint16_t)age, rrdPct(a.avg[RRD_CPU]), rrdPct(a.mx[RRD_CPU]), rrdPct(a.avg[RRD_RAM]));
+    }
+  }
+}
+
+static void rrdSample(uint32_t epoch, float ramPct) {
+  if (!rrd.ok()) return;
+  if (!rrdSeeded) { rrdSeeded = true; rrdSeedHistory(epoch); }
+  const float net = (isnan(data.net_rx) || isnan(data.net_tx)) ? NAN : max(0.0f, data.net_rx + data.net_tx);
+  const float v[RRD_METRICS] = {data.cpu >= 0 ? data.cpu : NAN, ramPct >= 0 ? ramPct : NAN, net, data.tempC};
+  rrd.add(epoch, v);
+}
+
+// {"cmd":"dump","tier":"raw|1m|15m","from":s,"to":s}: enregistrements tels qu'en
+// flash, en hex, une page (256 o) par ligne et une ligne par passage de loop():
+//   {"t":"rrd","k":"1m","rec":32,"from":..,"to":..,"m":[...],"scale":[...]}
+//   {"t":"rrd","k":"1m","r":"hex"} ...
+//   {"t":"rrd","k":"1m","end":1,"n":N}
+static const char *const kRrdTierNames[3] = {"raw", "1m", "15m"};
+struct RrdDump {
+  RrdPos pos;
+  uint32_t to = 0, n = 0;
+  uint8_t tier = 0;
+  bool on = false;
+};
+static RrdDump dump;
+
+static void rrdDumpStart(JsonDocument &doc) {
+  const char *k = doc["tier"] | "1m";
+  uint8_t tier = 0;
+  while (tier < 3 && strcmp(k, kRrdTierNames[tier])) tier++;
+  if (tier == 3) { Serial.print("Niveau inconnu: "); Serial.println(k); return; }
+  if (!rrd.ok()) { Serial.println("{\"t\":\"rrd\",\"err\":\"fs\"}"); return; }
+  const uint32_t from = doc["from"] | 0UL;
+  dump.to = doc["to"] | 0xFFFFFFFFUL;
+  dump.pos = tier == 0 ? rrd.raw.seek(from) : tier == 1 ? rrd.m1.seek(from) : rrd.m15.seek(from);
+  dump.tier = tier;
+  dump.n = 0;
+  dump.on = true;
+  char buf[160];
+  snprintf(buf, sizeof(buf), "{\"t\":\"rrd\",\"k\":\"%s\",\"rec\":%u,\"from\":%lu,\"to\":%lu,"
+           "\"m\":[\"%s\",\"%s\",\"%s\",\"%s\"],\"scale\":[%d,%d,%d,%d]}",
+           k, (unsigned)(tier == 0 ? sizeof(RrdRaw) : sizeof(RrdAgg)), (unsigned long)from, (unsigned long)dump.to,
+           kRrdMetricNames[0], kRrdMetricNames[1], kRrdMetricNames[2], kRrdMetricNames[3],
+           (int)kRrdScale[0], (int)kRrdScale[1], (int)kRrdScale[2], (int)kRrdScale[3]);
+  Serial.println(buf);
+}
+
+template <class Rec, uint8_t S>
+static uint16_t rrdDumpRead(RrdTier<Rec, S> &tier, uint8_t *out) {
+  return (uint16_t)(tier.read(dump.pos, dump.to, (Rec *)out, RRD_PAGE / sizeof(Rec)) * sizeof(Rec));
+}
+
+static void rrdDumpStep() {
+  static const char kHex[] = "0123456789abcdef";
+  alignas(4) uint8_t page[RRD_PAGE];
+  const uint16_t bytes = dump.tier == 0 ? rrdDumpRead(rrd.raw, page)
+                       : dump.tier == 1 ? rrdDumpRead(rrd.m1, page) : rrdDumpRead(rrd.m15, page);
+  const char *k = kRrdTierNames[dump.tier];
+  char buf[2 * RRD_PAGE + 40];
+  if (bytes) {
+    int at = snprintf(buf, sizeof(buf), "{\"t\":\"rrd\",\"k\":\"%s\",\"r\":\"", k);
+    for (uint16_t i = 0; i < bytes; i++) { buf[at++] = kHex[page[i] >> 4]; buf[at++] = kHex[page[i] & 15]; }
+    memcpy(buf + at, "\"}", 3);
+    Serial.println(buf);
+    dump.n += bytes / (dump.tier == 0 ? sizeof(RrdRaw) : sizeof(RrdAgg));
+  }
+  if (!dump.pos.end) return;
+  snprintf(buf, sizeof(buf), "{\"t\":\"rrd\",\"k\":\"%s\",\"end\":1,\"n\":%lu}", k, (unsigned long)dump.n);
+  Serial.println(buf);
+  dump.on = false;
+}
+
+// Agrégats glissants 1/5/15 min (seaux de 10 s), mis à jour à chaque instantané:
+// moyennes/min/max lus en O(1) par le ticker, l'humeur, le header et la télémétrie
+#define AGG_BUCKET_MS 10000UL
+#define AGG_1M 0
+#define AGG_5M 1
+#define AGG_15M 2
+#define AGG_TREND_PCT 10.0f // écart de moyennes CPU signalé dans le header
+static const uint16_t kAggSpans[3] = {6, 30, 90};
+typedef SlidingWindows<90, 3> MetricWindows;
+static MetricWindows aggCpu(AGG_BUCKET_MS, kAggSpans);  // %
+static MetricWindows aggRam(AGG_BUCKET_MS, kAggSpans);  // % utilisée
+static MetricWindows aggNet(AGG_BUCKET_MS, kAggSpans);  // KB/s rx+tx
+static MetricWindows aggTemp(AGG_BUCKET_MS, kAggSpans); // °C
+
+static void aggRoll(uint32_t now) {
+  aggCpu.roll(now); aggRam.roll(now); aggNet.roll(now); aggTemp.roll(now);
+}
+
+// Alertes (include/alert_rules.h): règles de l'hôte évaluées à chaque échantillon
+#define ALERT_FLASH_MS 2000   // durée du clignotement inversé au déclenchement
+#define ALERT_FLASH_HALF 250  // demi-période du clignotement
+static AlertEngine<Profile::alertRules> alerts;
+static uint32_t alertFlashUntil = 0;
+static bool alertInverted = false;
+
+static String alertLabel(const AlertRule &r) {
+  static const char *const kUnit[kAlertMetrics] = {"%", "%", "MB", "KB/s", "C", "MB"};
+  String s = kAlertMetricNames[r.metric];
+  s.toUpperCase();
+  s += r.below ? "<" : ">";
+  if (r.metric == kAlertRamFree || r.metric == kAlertDiskFree) s += fmtDiskMB((uint32_t)r.threshold);
+  else { s += fmtValue(r.threshold); s += kUnit[r.metric]; }
+  if (r.holdMs) { s += " "; s += (unsigned long)(r.holdMs / 1000); s += "s"; }
+  return s;
+}
+
+// Compte rendu à l'hôte: déclenchement (durée tenue, retard de détection) ou retombée
+static void alertReport(uint32_t changed, float v, uint32_t now) {
+  for (; changed; changed &= changed - 1) {
+    const uint8_t i = (uint8_t)__builtin_ctz(changed);
+    const AlertRule &r = alerts.rule(i);
+    char buf[128];
+    if (r.active) {
+      snprintf(buf, sizeof(buf), "{\"t\":\"alert\",\"r\":%u,\"on\":1,\"m\":\"%s\",\"v\":%.2f,\"ms\":%lu,\"held\":%lu,\"lat\":%u}",
+               (unsigned)i, kAlertMetricNames[r.metric], v, (unsigned long)now,
+               (unsigned long)msSince(now, r.since), (unsigned)r.latencyMs);
+      if (r.fx & ALERT_FX_FLASH) alertFlashUntil = now + ALERT_FLASH_MS;
+    } else {
+      snprintf(buf, sizeof(buf), "{\"t\":\"alert\",\"r\":%u,\"on\":0,\"m\":\"%s\",\"ms\":%lu}",
+               (unsigned)i, kAlertMetricNames[r.metric], (unsigned long)now);
+    }
+    Serial.println(buf);
+  }
+}
+
+static void alertSample(uint8_t m, float v, uint32_t now) {
+  if (uint32_t changed = alerts.sample(m, v, now)) alertReport(changed, v, now);
+}
+
+// Écran inversé en clignotant après un déclenchement "flash" (commande, pas de pages à renvoyer)
+static void alertFlash(uint32_t now) {
+  const bool on = !reached(now, alertFlashUntil) && ((alertFlashUntil - now) / ALERT_FLASH_HALF) % 2 == 1;
+  if (on == alertInverted) return;
+  alertInverted = on;
+  display.invertDisplay(on);
+#ifdef SMON_PANEL2_ADDR
+  if (histOk) histPanel.invertDisplay(on);
+#endif
+}
+
+// Échantillons rapides {"t":"b"}: rejoués à leur cadence d'origine, avec un lot de retard
+#define LIVE_QUEUE Profile::liveQueue
+#define LIVE_HOLD_MS 1500 // après le dernier lot, l'instantané reprend la main sur les jauges
+static SampleQueue<LIVE_QUEUE> liveQueue;
+static uint32_t liveNextT0 = 0;      // t0 attendu d'un lot contigu au précédent
+static uint32_t liveUntil = 0;
+static bool liveOn = false;          // liveUntil n'est valable que tant qu'il est à venir
+static bool liveActive() {
+  if (liveOn && reached(nowMs(), liveUntil)) liveOn = false;
+  return liveOn;
+}
+
+// Poignée de main: le bridge y répond par le backlog de son journal
+static void sendHello() {
+  char buf[128];
+  snprintf(buf, sizeof(buf), "{\"t\":\"hello\",\"fw\":%d,\"hist\":%u,\"slot\":%lu,\"profile\":\"%s\"%s%s}",
+           FW_PROTO, (unsigned)HIST_SLOTS, (unsigned long)HIST_SLOT_MS, Profile::name(),
+           kHostFrames ? ",\"fb\":[128,64]" : "", // "fb": accepte les frames de l'hôte
+           kDeltaIngest ? ",\"d\":1" : "");       // "d": accepte les instantanés en delta
+  Serial.println(buf);
+}
+
+static int hexByte(const char *p) {
+  const int hi = hexNibble(p[0]), lo = hi < 0 ? -1 : hexNibble(p[1]);
+  return lo < 0 ? -1 : (hi << 4) | lo;
+}
+
+// {"t":"hist","slot":ms,"i":premier,"n":total,"cpu":"hex","cpux":"hex","ram":"hex"}
+// Créneaux du plus ancien au plus récent; le dernier (i+k == n-1) vient de se clore.
+static void applyHistoryBacklog(JsonDocument &doc) {
+  if ((unsigned long)(doc["slot"] | 0UL) != HIST_SLOT_MS) return; // autre granularité: ignoré
+  int first = doc["i"] | 0, total = doc["n"] | 0;
+  const char *cpu = doc["cpu"] | "", *cpux = doc["cpux"] | "", *ram = doc["ram"] | "";
+  size_t len = strlen(cpu);
+  if (strlen(cpux) != len || strlen(ram) != len) return;
+  for (size_t k = 0; k * 2 + 1 < len; k++) {
+    int age = total - 1 - (first + (int)k);
+    int c = hexByte(cpu + 2 * k), cx = hexByte(cpux + 2 * k), r = hexByte(ram + 2 * k);
+    if (age < 0 || age >= HIST_SLOTS || c < 0 || cx < 0 || r < 0) continue;
+    history.set((uint16_t)age, (uint8_t)c, (uint8_t)cx, (uint8_t)r);
+  }
+}
+
+// -----------------------------------------------------------------------------
+// Instrumentation: compteurs d'ingestion et histogrammes de temps de frame.
+// Émis sur Serial en ligne JSON {"t":"stat",...} quand l'hôte l'active avec
+// {"cmd":"telemetry","ms":1000}. Les compteurs sont cumulés (l'hôte calcule
+// les deltas), les histogrammes repartent de zéro à chaque émission.
+// -----------------------------------------------------------------------------
+#if SMON_INSTRUMENT
+// Histogramme log-linéaire: 4 classes par octave à partir de 64 µs (~0.5 s max)
+struct FrameHist {
+  static const uint8_t kBuckets = 52;
+  uint16_t n[kBuckets] = {0};
+  uint16_t count = 0;
+  uint32_t maxUs = 0;
+
+  static uint8_t bucketOf(uint32_t us) {
+    if (us < 64) return 0;
+    uint8_t oct = (uint8_t)(31 - __builtin_clz(us) - 6);
+    uint8_t b = (uint8_t)(1 + oct * 4 + ((us >> (oct + 4)) & 3));
+    return b < kBuckets ? b : kBuckets - 1;
+  }
+  static uint32_t upperOf(uint8_t b) {
+    if (b == 0) return 64;
+    b--; uint8_t oct = b / 4, sub = b % 4;
+    return (64u << oct) + ((uint32_t)(sub + 1) << (oct + 4));
+  }
+  void add(uint32_t us) {
+    if (count == 0xFFFF) return;
+    n[bucketOf(us)]++; count++;
+    if (us > maxUs) maxUs = us;
+  }
+  uint32_t percentile(uint8_t pct) const {
+    if (count == 0) return 0;
+    uint32_t rank = ((uint32_t)count * pct + 99) / 100, acc = 0;
+    for (uint8_t b = 0; b < kBuckets; b++) { acc += n[b]; if (acc >= rank) return min(upperOf(b), maxUs); }
+    return maxUs;
+  }
+  void reset() { memset(n, 0, sizeof(n)); count = 0; maxUs = 0; }
+};
+
+struct Telemetry {
+  uint32_t linesOk = 0;       // lignes JSON appliquées
+  uint32_t linesBad = 0;      // erreurs de parse
+  uint32_t linesFast = 0;     // instantanés lus par le chemin rapide (sans ArduinoJson)
+  uint32_t linesSkipped = 0;  // instantanés remplacés par un plus récent avant d'être lus
+  uint32_t linesOverflow = 0; // lignes tronquées (> longueur max)
+  uint32_t liveSamples = 0;   // échantillons reçus par lots
+  uint32_t liveDropped = 0;   // perdus (file pleine)
+  uint32_t frames = 0;
+  FrameHist renderUs;         // coût du rendu (clear -> commit(), hors bus I2C)
+  FrameHist intervalUs;       // intervalle entre deux frames
+  uint32_t lastFrameUs = 0;
+  uint16_t periodMs = 0;      // 0 = émission désactivée
+  uint32_t lastEmitMs = 0;
+};
+static Telemetry tele;
+
+static uint32_t heapUsedBytes() {
+#if defined(ARDUINO_ARCH_ESP32)
+  return ESP.getHeapSize() - ESP.getFreeHeap();
+#elif defined(SMON_NATIVE)
+  return nativeHeapUsed();
+#else
+  return 0;
+#endif
+}
+
+// Fenêtres 1/5/15 min: [moyenne, min, max, n] par métrique, null si vide
+static int appendWindows(char *buf, size_t cap, int at, const char *key, const MetricWindows &m) {
+  if (at >= (int)cap) return at;
+  at += snprintf(buf + at, cap - at, ",\"%s\":[", key);
+  for (uint8_t w = 0; w < 3 && at < (int)cap; w++) {
+    const WindowAgg a = m.get(w);
+    if (a.empty()) at += snprintf(buf + at, cap - at, "%snull", w ? "," : "");
+    else at += snprintf(buf + at, cap - at, "%s[%.1f,%.1f,%.1f,%lu]", w ? "," : "",
+                        a.mean(), a.min, a.max, (unsigned long)a.count);
+  }
+  return at < (int)cap ? at + snprintf(buf + at, cap - at, "]") : at;
+}
+
+static void emitAggregates() {
+  char buf[640];
+  int at = snprintf(buf, sizeof(buf), "{\"t\":\"agg\",\"w\":[%lu,%lu,%lu]",
+                    (unsigned long)(kAggSpans[0] * AGG_BUCKET_MS / 1000),
+                    (unsigned long)(kAggSpans[1] * AGG_BUCKET_MS / 1000),
+                    (unsigned long)(kAggSpans[2] * AGG_BUCKET_MS / 1000));
+  at = appendWindows(buf, sizeof(buf), at, "cpu", aggCpu);
+  at = appendWindows(buf, sizeof(buf), at, "ram", aggRam);
+  at = appendWindows(buf, sizeof(buf), at, "net", aggNet);
+  at = appendWindows(buf, sizeof(buf), at, "temp", aggTemp);
+  if (at >= (int)sizeof(buf) - 1) return; // ligne tronquée: pas de JSON invalide
+  strcat(buf, "}");
+  Serial.println(buf);
+}
+
+static void emitTelemetry(uint32_t now) {
+  if (tele.periodMs == 0 || now - tele.lastEmitMs < tele.periodMs) return;
+  tele.lastEmitMs = now;
+#if defined(ARDUINO_ARCH_ESP32)
+  const char *auxKey = "heapPeak"; unsigned long aux = ESP.getHeapSize() - ESP.getMinFreeHeap();
+#elif defined(SMON_NATIVE)
+  const char *auxKey = "rss"; unsigned long aux = nativeRssKB(); // KB
+#else
+  const char *auxKey = "aux"; unsigned long aux = 0;
+#endif
+  uint32_t pagesWritten = display.pagesWritten, pagesSkipped = display.pagesSkipped;
+#ifdef SMON_PANEL2_ADDR
+  pagesWritten += histPanel.pagesWritten; pagesSkipped += histPanel.pagesSkipped;
+#endif
+  char buf[704];
+  snprintf(buf, sizeof(buf),
+           "{\"t\":\"stat\",\"ms\":%lu,\"ok\":%lu,\"jf\":%lu,\"sk\":%lu,\"bad\":%lu,\"ovf\":%lu,\"fr\":%lu,"
+           "\"r50\":%lu,\"r95\":%lu,\"r99\":%lu,\"i50\":%lu,\"i95\":%lu,\"i99\":%lu,\"imax\":%lu,"
+           "\"ls\":%lu,\"ld\":%lu,\"trd\":%lu,\"trn\":%lu,\"trp\":%lu,\"tri\":%lu,\"pw\":%lu,\"ps\":%lu,\"pg\":%lu,"
+           "\"fbf\":%lu,\"fbg\":%lu,\"fbb\":%lu,\"fbt\":%lu,\"dl\":%lu,\"dg\":%lu,\"rw\":%lu,\"re\":%lu,\"heap\":%lu,\"%s\":%lu}",
+           (unsigned long)now, (unsigned long)tele.linesOk, (unsigned long)tele.linesFast,
+           (unsigned long)tele.linesSkipped, (unsigned long)tele.linesBad,
+           (unsigned long)tele.linesOverflow, (unsigned long)tele.frames,
+           (unsigned long)tele.renderUs.percentile(50), (unsigned long)tele.renderUs.percentile(95),
+           (unsigned long)tele.renderUs.percentile(99),
+           (unsigned long)tele.intervalUs.percentile(50), (unsigned long)tele.intervalUs.percentile(95),
+           (unsigned long)tele.intervalUs.percentile(99), (unsigned long)tele.intervalUs.maxUs,
+           (unsigned long)tele.liveSamples, (unsigned long)tele.liveDropped,
+           (unsigned long)truncs.disks, (unsigned long)truncs.nics, (unsigned long)truncs.procs,
+           (unsigned long)truncs.ids, (unsigned long)pagesWritten, (unsigned long)pagesSkipped,
+           (unsigned long)pages.switches,
+           (unsigned long)hostFb.frames, (unsigned long)hostFb.gaps, (unsigned long)hostFb.bad,
+           (unsigned long)hostFb.fallbacks, (unsigned long)deltaSync.deltas, (unsigned long)deltaSync.gaps,
+           (unsigned long)rrd.pageWrites(), (unsigned long)rrd.errors(),
+           (unsigned long)heapUsedBytes(), auxKey, aux);
+  Serial.println(buf);
+  emitAggregates();
+  tele.renderUs.reset();
+  tele.intervalUs.reset();
+}
+#define TELE_COUNT(field) (tele.field++)
+#else
+#define TELE_COUNT(field) ((void)0)
+#endif
+
+// -----------------------------------------------------------------------------
+// Commandes de l'hôte: {"cmd":"..."} (ne touchent pas aux données affichées)
+// -----------------------------------------------------------------------------
+static void handleCommand(JsonDocument &doc) {
+  const char *cmd = doc["cmd"] | "";
+  if (!strcmp(cmd, "hello")) { sendHello(); return; }
+  if (!strcmp(cmd, "net")) {
+    ui.netLog = !strcmp(doc["scale"] | "", "log");
+    return;
+  }
+  if (kUiPages && !strcmp(cmd, "page")) {
+    // "p": page à montrer ("next": la suivante), "cycle": rotation en secondes (0: arrêt)
+    if (doc.containsKey("cycle")) {
+      const float c = doc["cycle"] | 0.0f;
+      pages.cycleMs = c > 0 ? (uint32_t)(c * 1000) : 0;
+    }
+    const char *p = doc["p"] | "";
+    if (!strcmp(p, "next")) pages.want = (uint8_t)((pages.want + 1) % PAGE_COUNT);
+    else if (*p) {
+      uint8_t i = 0;
+      while (i < PAGE_COUNT && strcmp(p, kPageNames[i])) i++;
+      if (i == PAGE_COUNT) { Serial.print("Page inconnue: "); Serial.println(p); return; }
+      pages.want = i;
+    }
+    pages.nextMs = nowMs() + pages.cycleMs;
+    return;
+  }
+  if (Profile::flashHistory && !strcmp(cmd, "dump")) { rrdDumpStart(doc); return; }
+  if (!strcmp(cmd, "rules")) {
+    // [["cpu", ">", 90, 30000, fx], ...]: remplace toute la table
+    alertReport(alerts.release(), NAN, nowMs());
+    alerts.clear();
+    uint8_t bad = 0;
+    for (JsonArrayConst r : doc["r"].as<JsonArrayConst>()) {
+      const int8_t m = alertMetricByName(r[0] | "");
+      const char *op = r[1] | "";
+      if (m < 0 || (strcmp(op, ">") && strcmp(op, "<")) ||
+          !alerts.add((uint8_t)m, op[0] == '<', r[2] | NAN, r[3] | 0UL, r[4] | ALERT_FX_BANNER)) bad++;
+    }
+    char buf[48];
+    snprintf(buf, sizeof(buf), "{\"t\":\"rules\",\"n\":%u,\"bad\":%u}", (unsigned)alerts.size(), (unsigned)bad);
+    Serial.println(buf);
+    return;
+  }
+#if SMON_INSTRUMENT
+  if (!strcmp(cmd, "telemetry")) {
+    tele.periodMs = doc["ms"] | 1000;
+    tele.lastEmitMs = 0;
+    return;
+  }
+#endif
+  Serial.print("Commande inconnue: "); Serial.println(cmd);
+}
+
+// {"t":"b","t0":ms hôte,"dt":ms,"cpu":"hex","ram":"hex"}: n échantillons espacés de dt
+// Un lot contigu au précédent (t0 attendu) est enchaîné à la suite de la file,
+// sinon (premier lot, trou, retard accumulé) la lecture repart de maintenant.
+static bool applySampleBatch(JsonDocument &doc) {
+  uint32_t t0 = doc["t0"] | 0UL;
+  uint16_t dt = doc["dt"] | 0;
+  const char *cpu = doc["cpu"] | "", *ram = doc["ram"] | "";
+  size_t n = strlen(cpu) / 2;
+  if (dt == 0 || n == 0) return false;
+  bool withRam = strlen(ram) == n * 2;
+
+  uint32_t now = nowMs(), due = now;
+  if (t0 == liveNextT0 && !liveQueue.empty()) {
+    int32_t ahead = msSince(liveQueue.lastDue() + dt, now);
+    if (ahead > 0 && ahead <= 2 * (int32_t)(n * dt)) due = liveQueue.lastDue() + dt;
+  }
+  for (size_t k = 0; k < n; k++) {
+    int c = hexByte(cpu + 2 * k);
+    if (c < 0 || c > 100) continue; // "ff": échantillon manquant
+    int r = withRam ? hexByte(ram + 2 * k) : -1;
+    TimedSample sm = { due + (uint32_t)(k * dt), (uint8_t)c, (uint8_t)(r >= 0 && r <= 100 ? r : 0xFF) };
+    if (!liveQueue.push(sm)) TELE_COUNT(liveDropped);
+  }
+#if SMON_INSTRUMENT
+  tele.liveSamples += n;
+#endif
+  liveNextT0 = t0 + (uint32_t)(n * dt);
+  liveUntil = due + (uint32_t)(n * dt) + LIVE_HOLD_MS;
+  liveOn = true;
+  return true;
+}
+
+// Trames typées de l'hôte: {"t":"..."} (historique, lots, ...); true = donnée à afficher
+// {"t":"fb","s":seq,"k":1,"e":1,"p":[[page,"hex"],...]}: pages PackBits écrites
+// telles quelles dans le framebuffer; l'écran suit au commit de la dernière ligne
+static void applyHostFrame(JsonDocument &doc) {
+  const uint32_t now = nowMs();
+  if (hostFb.open((uint16_t)(doc["s"] | 0UL), doc["k"] | 0)) {
+    uint8_t *fb = gfx.buffer();
+    for (JsonArrayConst pg : doc["p"].as<JsonArrayConst>()) {
+      const uint8_t p = pg[0] | 0xFF;
+      const bool ok = p < SCREEN_HEIGHT / 8 && unpackHexPackBits(pg[1] | "", fb + p * SCREEN_WIDTH, SCREEN_WIDTH);
+      hostFb.page(ok);
+      if (!ok) break;
+    }
+    if ((doc["e"] | 0) && hostFb.close(now)) display.commit(now);
+  }
+  if (hostFb.takeKeyRequest(now, HOSTFB_KEY_RETRY_MS)) {
+    char buf[40];
+    snprintf(buf, sizeof(buf), "{\"t\":\"fbk\",\"s\":%u,\"key\":1}", (unsigned)hostFb.last());
+    Serial.println(buf);
+  }
+}
+
+static bool applyDelta(JsonDocument &doc);
+
+static bool handleFrame(const char *type, JsonDocument &doc) {
+  if (!strcmp(type, "b")) return applySampleBatch(doc);
+  if (kDeltaIngest && !strcmp(type, "d")) return applyDelta(doc);
+  if (kHostFrames && !strcmp(type, "fb")) { applyHostFrame(doc); return false; }
+  if (!strcmp(type, "hist")) { applyHistoryBacklog(doc); return false; }
+  Serial.print("Trame inconnue: "); Serial.println(type);
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+// Schéma des tableaux: une fonction de lecture par type d'entrée; readArray
+// remplit le StaticVector et compte ce qui ne tient pas.
+// -----------------------------------------------------------------------------
+static bool readId(JsonObjectConst o, FixedString<ID_LEN> &id) {
+  if (!id.assign(o["id"] | "")) truncs.ids++;
+  return !id.empty();
+}
+static bool parseDisk(JsonObjectConst o, DiskEntry &d) {
+  d.freeMB = o["free"] | 0UL;
+  d.sizeMB = o["size"] | 0UL;
+  return readId(o, d.id);
+}
+static bool parseNic(JsonObjectConst o, NicEntry &n) {
+  n.rx = o["rx"] | NAN;
+  n.tx = o["tx"] | NAN;
+  return readId(o, n.id);
+}
+static bool parseProc(JsonObjectConst o, ProcEntry &p) {
+  p.cpu = o["cpu"] | 0.0f;
+  if (!p.id.assign(o["id"] | "")) truncs.ids++;
+  return !p.id.empty();
+}
+// Lignes positionnelles des deltas: [id, free, size], [id, rx, tx], [id, cpu]
+template <uint8_t N>
+static bool rowId(JsonArrayConst r, FixedString<N> &id) {
+  if (!id.assign(r[0] | "")) truncs.ids++;
+  return !id.empty();
+}
+static bool diskRow(JsonArrayConst r, DiskEntry &d) {
+  d.freeMB = r[1] | 0UL;
+  d.sizeMB = r[2] | 0UL;
+  return rowId(r, d.id);
+}
+static bool nicRow(JsonArrayConst r, NicEntry &n) {
+  n.rx = r[1] | NAN;
+  n.tx = r[2] | NAN;
+  return rowId(r, n.id);
+}
+static bool procRow(JsonArrayConst r, ProcEntry &p) {
+  p.cpu = r[1] | 0.0f;
+  return rowId(r, p.id);
+}
+// E: JsonObjectConst (instantané) ou JsonArrayConst (ligne de delta)
+template <typename T, uint8_t N, typename E>
+static void readArray(JsonArrayConst arr, StaticVector<T, N> &out, uint32_t &truncated,
+                      bool (*parse)(E, T &)) {
+  out.clear();
+  for (JsonVariantConst v : arr) {
+    T *e = out.emplace();
+    if (!e) { truncated++; continue; }
+    if (!parse(v.as<E>(), *e)) out.pop(); // sans id: ignorée
+  }
+}
 
 // -----------------------------------------------------------------------------
 // Lecture JSON (une ligne) -> met à jour Data + UI
 // -----------------------------------------------------------------------------
-static bool updateFromJsonLine(const String &line) {
-  StaticJsonDocument<1024> doc;
-  DeserializationError err = deserializeJson(doc, line);
-  if (err) {
-    Serial.print("Erreur JSON: "); Serial.println(err.f_str());
-    return false;
+// Document réutilisé d'une ligne à l'autre (hors pile): snapshot + tableaux + "x"
+#define JSON_DOC_BYTES Profile::jsonDocBytes
+
+// Nom de l'app (header): espaces retirés aux bouts, "SMON" si vide
+static void setAppTitle(const char *s, uint16_t len) {
+  while (len && isspace((unsigned char)*s)) { s++; len--; }
+  while (len && isspace((unsigned char)s[len - 1])) len--;
+  if (len) appTitle.assign(s, len);
+  else appTitle.assign("SMON");
+}
+
+// Champs additionnels "x" (remplacent les précédents)
+static void readExtras(JsonObjectConst x) {
+  extraCount = 0;
+  for (JsonPairConst kv : x) {
+    if (extraCount >= EXTRA_MAX) break;
+    ExtraField &e = extras[extraCount++];
+    strncpy(e.name, kv.key().c_str(), sizeof(e.name) - 1);
+    e.name[sizeof(e.name) - 1] = 0;
+    e.name[utf8Fit(e.name, strlen(e.name))] = 0; // pas de caractère coupé en deux
+    e.value = kv.value() | NAN;
   }
+}
 
+// Chemin générique (ArduinoJson): champs lus dans le document; true si "time" y est
+static bool readSnapshotDoc(JsonDocument &doc) {
   // Récupérer valeurs (avec défauts sûrs)
   data.cpu = doc["cpu"] | data.cpu;
   data.ram = doc["ram"] | data.ram;
   data.ram_used = doc["ram_used"] | data.ram_used;
+  // Pics de l'intervalle: absents d'un ancien bridge -> valeur instantanée
+  data.cpuMax = doc["cpu_max"] | data.cpu;
+  data.cpuP95 = doc["cpu_p95"] | data.cpu;
+  data.ramMax = doc["ram_max"] | data.ram_used;
   data.tempC = doc["weather"]["temp"] | data.tempC;
-  data.host = String((const char*)(doc["host"] | data.host.c_str()));
+  if (doc["weather"].containsKey("desc")) data.weatherDesc.assign(doc["weather"]["desc"] | "");
   data.epoch = doc["time"] | data.epoch;
   data.uptime = doc["uptime"] | data.uptime;
-  data.diskFreeKB = doc["disk_free"] | data.diskFreeKB;
+  if (doc.containsKey("disk_free")) {
+    const float kb = doc["disk_free"] | -1.0f;
+    data.diskFreeMB = kb < 0 ? -1 : (int32_t)(kb / 1024);
+  }
   data.net_rx = doc["net"]["rx"] | data.net_rx;
   data.net_tx = doc["net"]["tx"] | data.net_tx;
+  if (doc.containsKey("disks")) readArray(doc["disks"].as<JsonArrayConst>(), data.disks, truncs.disks, parseDisk);
+  if (doc.containsKey("nics")) readArray(doc["nics"].as<JsonArrayConst>(), data.nics, truncs.nics, parseNic);
+  if (doc.containsKey("procs")) readArray(doc["procs"].as<JsonArrayConst>(), data.procs, truncs.procs, parseProc);
+  readExtras(doc["x"].as<JsonObjectConst>()); // absent: plus aucune source côté bridge
   if (doc.containsKey("app")) {
-    String newApp = doc["app"].as<String>(); // copie sûre de la chaîne
-    newApp.trim();
-    appName = newApp; // utilisé dans le header uniquement
+    const char *app = doc["app"] | "";
+    setAppTitle(app, (uint16_t)strlen(app));
   }
+  return doc.containsKey("time");
+}
+
+static bool applySnapshot(bool hasTime);
+
+// État d'une keyframe avant ses champs, et valeur d'un champ de delta à null
+static const DataState kDataNone;
 
-  // Mettre à jour cibles et auto-échelle réseau
-  if (data.cpu >= 0) ui.tgtCpu = data.cpu;
-  if (data.ram > 0 && data.ram_used >= 0) ui.tgtRamRatio = (float)data.ram_used / (float)data.ram;
-  if (!isnan(data.net_rx) && !isnan(data.net_tx)) {
-    float total = max(0.0f, data.net_rx + data.net_tx);
-    if (total > ui.netMaxKBs) ui.netMaxKBs = total; // up rapide
-    ui.tgtNetRatio = ui.netMaxKBs > 0 ? total / ui.netMaxKBs : 0;
-    ui.netMaxKBs *= 0.996f; if (ui.netMaxKBs < 1) ui.netMaxKBs = 1; // decay lent
+// Ligne de delta s applicable? Sinon keyframe demandée à l'hôte (au plus une par délai)
+static bool deltaAccept(uint16_t seq, bool key, uint32_t now) {
+  if (deltaSync.accept(seq, key)) return true;
+  if (deltaSync.takeKeyRequest(now, DELTA_KEY_RETRY_MS)) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "{\"t\":\"dk\",\"s\":%u}", (unsigned)deltaSync.last());
+    Serial.println(buf);
+  }
+  return false;
+}
+
+// Delta fusionné dans data: heure et uptime tenus ici entre deux keyframes
+static bool deltaPublish(uint32_t now) {
+  const bool hasTime = deltaSync.epoch(now, data.epoch);
+  data.uptime = hasTime && deltaSync.boot() && data.epoch >= deltaSync.boot() ? (int32_t)(data.epoch - deltaSync.boot()) : -1;
+  TELE_COUNT(linesOk);
+  return applySnapshot(hasTime);
+}
+
+// {"t":"d","s":seq,"k":1?,"<DeltaKey>":valeur,...} fusionné dans data (include/snap_delta.h).
+// Keyframe: l'état repart de zéro, seuls ses champs existent.
+// Chemin générique: le chemin rapide (scanDelta) lit d'abord la ligne.
+static bool readDeltaDoc(JsonDocument &doc, uint32_t now) {
+  const bool key = doc["k"] | 0;
+  if (!deltaAccept((uint16_t)(doc["s"] | 0UL), key, now)) return false;
+  const DataState &none = kDataNone;
+  if (key) {
+    data = none;
+    extraCount = 0;
+    appTitle.assign("SMON");
+  }
+  for (JsonPairConst kv : doc.as<JsonObjectConst>()) {
+    const char *k = kv.key().c_str();
+    if (!isdigit((unsigned char)*k)) continue; // t, s, k
+    const JsonVariantConst v = kv.value();
+    const bool clear = v.isNull();
+    switch (atoi(k)) {
+      case kdCpu: data.cpu = clear ? none.cpu : v | data.cpu; break;
+      case kdCpuMax: data.cpuMax = clear ? none.cpuMax : v | data.cpuMax; break;
+      case kdCpuP95: data.cpuP95 = clear ? none.cpuP95 : v | data.cpuP95; break;
+      case kdRam: data.ram = clear ? none.ram : v | data.ram; break;
+      case kdRamUsed: data.ram_used = clear ? none.ram_used : v | data.ram_used; break;
+      case kdRamMax: data.ramMax = clear ? none.ramMax : v | data.ramMax; break;
+      case kdTime: deltaSync.setEpoch(v | 0UL, now); break;
+      case kdDiskFree: {
+        const float kb = v | -1.0f;
+        data.diskFreeMB = kb < 0 ? -1 : (int32_t)(kb / 1024);
+        break;
+      }
+      case kdNetRx: data.net_rx = clear ? none.net_rx : v | data.net_rx; break;
+      case kdNetTx: data.net_tx = clear ? none.net_tx : v | data.net_tx; break;
+      case kdTemp: data.tempC = clear ? none.tempC : v | data.tempC; break;
+      case kdDesc: data.weatherDesc.assign(v | ""); break;
+      case kdApp: {
+        const char *app = v | "";
+        setAppTitle(app, (uint16_t)strlen(app));
+        break;
+      }
+      case kdDisks: readArray(v.as<JsonArrayConst>(), data.disks, truncs.disks, diskRow); break;
+      case kdNics: readArray(v.as<JsonArrayConst>(), data.nics, truncs.nics, nicRow); break;
+      case kdProcs: readArray(v.as<JsonArrayConst>(), data.procs, truncs.procs, procRow); break;
+      case kdExtras: readExtras(v.as<JsonObjectConst>()); break;
+      case kdBoot: deltaSync.setBoot(v | 0UL); break;
+      default: break; // kdHost (réservé) et clés à venir
+    }
+  }
+  return true;
+}
+
+static bool applyDelta(JsonDocument &doc) {
+  const uint32_t now = nowMs();
+  return readDeltaDoc(doc, now) && deltaPublish(now);
+}
+
+// -----------------------------------------------------------------------------
+// Chemin rapide des instantanés (include/json_scan.h): une passe sur la ligne,
+// sans document. Le schéma est une table par contexte (clé, lecture du champ);
+// chaque table devient un switch sur le hachage de la clé, vérifié parfait à la
+// compilation. Lecture dans une copie de l'état, publiée seulement si toute la
+// ligne est conforme: sinon (commande, trame typée, syntaxe, format inattendu)
+// rien n'a bougé et la ligne repasse par ArduinoJson. Mêmes valeurs par défaut
+// que readSnapshotDoc(); clés inconnues ignorées.
+// -----------------------------------------------------------------------------
+static constexpr bool kJsonFastPath = Profile::jsonFastPath;
+
+struct SnapStage {
+  DataState d;
+  TruncCounters tr;
+  ExtraField x[EXTRA_MAX];
+  uint8_t xCount;
+  JsonStr<200> app;         // 48 glyphes au plus de 4 octets UTF-8
+  bool appSet, cpuMax, cpuP95, ramMax, time;
+  // Delta: séquence, keyframe, champs tenus par deltaSync ou remplacés en bloc
+  uint32_t seq, epoch, boot;
+  int32_t key;
+  bool xSet, epochSet, bootSet;
+};
+static SnapStage stage;
+
+#define SNAP_CASE(key, read) case JKEY(key): if (k.is(key)) return read; break;
+#define SNAP_INDEX_CASE(i, read) case i: return read;
+
+// Chaîne courte présente: remplace la précédente ("" si autre type); coupe comptée
+template <uint8_t N>
+static bool snapStr(JsonScan &sc, FixedString<N> &dst, uint32_t *cut) {
+  JsonStr<40> s;
+  if (sc.peek() != '"') { dst.assign(""); return sc.skip(); }
+  if (!sc.str(s)) return false;
+  if (!dst.assign(s.s) && cut) (*cut)++;
+  return true;
+}
+
+// Entrées des tableaux: comme parseDisk/parseNic/parseProc
+#define SNAP_DISK_FIELDS(X)     \
+  X("id", snapStr(sc, e.id, &stage.tr.ids))     \
+  X("free", sc.u32(e.freeMB))   \
+  X("size", sc.u32(e.sizeMB))
+#define SNAP_NIC_FIELDS(X)      \
+  X("id", snapStr(sc, e.id, &stage.tr.ids))     \
+  X("rx", sc.f32(e.rx))         \
+  X("tx", sc.f32(e.tx))
+#define SNAP_PROC_FIELDS(X)         \
+  X("id", snapStr(sc, e.id, &stage.tr.ids))     \
+  X("cpu", sc.f32(e.cpu))
+
+static bool snapDisk(JsonScan &sc, DiskEntry &e) {
+  return sc.object([&](JsonStr<24> &k) -> bool { switch (k.slot()) { SNAP_DISK_FIELDS(SNAP_CASE) } return sc.skip(); });
+}
+static bool snapNic(JsonScan &sc, NicEntry &e) {
+  return sc.object([&](JsonStr<24> &k) -> bool { switch (k.slot()) { SNAP_NIC_FIELDS(SNAP_CASE) } return sc.skip(); });
+}
+static bool snapProc(JsonScan &sc, ProcEntry &e) {
+  return sc.object([&](JsonStr<24> &k) -> bool { switch (k.slot()) { SNAP_PROC_FIELDS(SNAP_CASE) } return sc.skip(); });
+}
+
+// Lignes positionnelles des deltas: comme diskRow/nicRow/procRow
+#define SNAP_DISK_ROW(X)                        \
+  X(0, snapStr(sc, e.id, &stage.tr.ids))        \
+  X(1, sc.u32(e.freeMB))                        \
+  X(2, sc.u32(e.sizeMB))
+#define SNAP_NIC_ROW(X)                         \
+  X(0, snapStr(sc, e.id, &stage.tr.ids))        \
+  X(1, sc.f32(e.rx))                            \
+  X(2, sc.f32(e.tx))
+#define SNAP_PROC_ROW(X)                        \
+  X(0, snapStr(sc, e.id, &stage.tr.ids))        \
+  X(1, sc.f32(e.cpu))
+
+static bool snapDiskRow(JsonScan &sc, DiskEntry &e) {
+  uint16_t i = 0;
+  return sc.array([&]() -> bool { switch (i++) { SNAP_DISK_ROW(SNAP_INDEX_CASE) } return sc.skip(); });
+}
+static bool snapNicRow(JsonScan &sc, NicEntry &e) {
+  uint16_t i = 0;
+  return sc.array([&]() -> bool { switch (i++) { SNAP_NIC_ROW(SNAP_INDEX_CASE) } return sc.skip(); });
+}
+static bool snapProcRow(JsonScan &sc, ProcEntry &e) {
+  uint16_t i = 0;
+  return sc.array([&]() -> bool { switch (i++) { SNAP_PROC_ROW(SNAP_INDEX_CASE) } return sc.skip(); });
+}
+
+// Tableau présent: remplace le précédent; surplus compté, entrées sans id ou
+// d'un autre type que open ('{' objet, '[' ligne de delta) ignorées
+template <typename T, uint8_t N>
+static bool snapArray(JsonScan &sc, StaticVector<T, N> &out, uint32_t &truncated, bool (*parse)(JsonScan &, T &),
+                      char open = '{') {
+  out.clear();
+  if (sc.peek() != '[') return sc.skip();
+  return sc.array([&]() -> bool {
+    if (out.full()) { truncated++; return sc.skip(); }
+    if (sc.peek() != open) return sc.skip();
+    T *e = out.emplace();
+    if (!parse(sc, *e)) return false;
+    if (e->id.empty()) out.pop();
+    return true;
+  });
+}
+
+static bool snapDiskFree(JsonScan &sc, DataState &d) {
+  float kb = -1;
+  if (!sc.f32(kb)) return false;
+  d.diskFreeMB = kb < 0 ? -1 : (int32_t)(kb / 1024);
+  return true;
+}
+#define SNAP_WEATHER_FIELDS(X)          \
+  X("temp", sc.f32(d.tempC))            \
+  X("desc", snapStr(sc, d.weatherDesc, nullptr))
+#define SNAP_NET_FIELDS(X)              \
+  X("rx", sc.f32(d.net_rx))             \
+  X("tx", sc.f32(d.net_tx))
+static bool snapWeather(JsonScan &sc, DataState &d) {
+  if (sc.peek() != '{') return sc.skip();
+  return sc.object([&](JsonStr<24> &k) -> bool { switch (k.slot()) { SNAP_WEATHER_FIELDS(SNAP_CASE) } return sc.skip(); });
+}
+static bool snapNet(JsonScan &sc, DataState &d) {
+  if (sc.peek() != '{') return sc.skip();
+  return sc.object([&](JsonStr<24> &k) -> bool { switch (k.slot()) { SNAP_NET_FIELDS(SNAP_CASE) } return sc.skip(); });
+}
+
+// "x": {"nom": valeur}, EXTRA_MAX premiers gardés
+static bool snapExtras(JsonScan &sc) {
+  if (sc.peek() != '{') return sc.skip();
+  return sc.object([&](JsonStr<24> &k) -> bool {
+    if (stage.xCount >= EXTRA_MAX) return sc.skip();
+    ExtraField &e = stage.x[stage.xCount++];
+    const uint16_t n = k.len < sizeof(e.name) - 1 ? k.len : sizeof(e.name) - 1;
+    memcpy(e.name, k.s, n);
+    e.name[utf8Fit(e.name, n)] = 0;
+    e.value = NAN;
+    return sc.f32(e.value);
+  });
+}
+static bool snapApp(JsonScan &sc) {
+  stage.appSet = true;
+  stage.app.len = 0;
+  return sc.peek() == '"' ? sc.str(stage.app) : sc.skip();
+}
+
+// Racine: "cmd" et "t" ne sont pas des instantanés -> ArduinoJson
+#define SNAP_ROOT_FIELDS(X)                           \
+  X("cpu", sc.f32(d.cpu))                             \
+  X("cpu_max", sc.f32(d.cpuMax, &stage.cpuMax))       \
+  X("cpu_p95", sc.f32(d.cpuP95, &stage.cpuP95))       \
+  X("ram", sc.i32(d.ram))                             \
+  X("ram_used", sc.i32(d.ram_used))                   \
+  X("ram_max", sc.i32(d.ramMax, &stage.ramMax))       \
+  X("time", (stage.time = true, sc.u32(d.epoch)))     \
+  X("uptime", sc.i32(d.uptime))                       \
+  X("disk_free", snapDiskFree(sc, d))                 \
+  X("weather", snapWeather(sc, d))                    \
+  X("net", snapNet(sc, d))                            \
+  X("disks", snapArray(sc, d.disks, stage.tr.disks, snapDisk)) \
+  X("nics", snapArray(sc, d.nics, stage.tr.nics, snapNic))     \
+  X("procs", snapArray(sc, d.procs, stage.tr.procs, snapProc)) \
+  X("x", snapExtras(sc))                              \
+  X("app", snapApp(sc))                               \
+  X("cmd", false)                                     \
+  X("t", false)
+
+// true: instantané lu et publié dans data (+ extras, appTitle, truncs)
+static bool scanSnapshot(const char *line, uint16_t len) {
+  JsonScan sc(line, len);
+  DataState &d = stage.d;
+  d = data;
+  stage.tr = truncs;
+  stage.xCount = 0;
+  stage.appSet = stage.cpuMax = stage.cpuP95 = stage.ramMax = stage.time = false;
+  const bool ok = sc.object([&](JsonStr<24> &k) -> bool { switch (k.slot()) { SNAP_ROOT_FIELDS(SNAP_CASE) } return sc.skip(); });
+  if (!ok || !sc.done()) return false;
+  if (!stage.cpuMax) d.cpuMax = d.cpu;
+  if (!stage.cpuP95) d.cpuP95 = d.cpu;
+  if (!stage.ramMax) d.ramMax = d.ram_used;
+  data = d;
+  truncs = stage.tr;
+  memcpy(extras, stage.x, stage.xCount * sizeof(ExtraField));
+  extraCount = stage.xCount;
+  if (stage.appSet) setAppTitle(stage.app.s, stage.app.len);
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+// Deltas ({"t":"d"}) sur le même chemin: la clé numérique est lue en chiffres et
+// aiguillée sur DeltaKey, les champs vont dans la copie de l'état (repartie de
+// zéro pour une keyframe), publiée seulement si la ligne est conforme et suit
+// la séquence. "k" doit précéder le premier champ (le bridge écrit t, s, k en
+// tête), sinon la ligne repasse par applyDelta(). Mêmes valeurs que celle-ci:
+// null remet la valeur par défaut d'un champ.
+// -----------------------------------------------------------------------------
+static bool deltaF32(JsonScan &sc, float &dst, float none) {
+  if (sc.peek() != 'n') return sc.f32(dst);
+  dst = none;
+  return sc.skip();
+}
+static bool deltaI32(JsonScan &sc, int32_t &dst, int32_t none) {
+  if (sc.peek() != 'n') return sc.i32(dst);
+  dst = none;
+  return sc.skip();
+}
+
+#define SNAP_DELTA_FIELDS(X)                                          \
+  X(kdCpu, deltaF32(sc, d.cpu, kDataNone.cpu))                         \
+  X(kdCpuMax, deltaF32(sc, d.cpuMax, kDataNone.cpuMax))                \
+  X(kdCpuP95, deltaF32(sc, d.cpuP95, kDataNone.cpuP95))                \
+  X(kdRam, deltaI32(sc, d.ram, kDataNone.ram))                         \
+  X(kdRamUsed, deltaI32(sc, d.ram_used, kDataNone.ram_used))           \
+  X(kdRamMax, deltaI32(sc, d.ramMax, kDataNone.ramMax))                \
+  X(kdTime, (stage.epochSet = true, sc.u32(stage.epoch)))             \
+  X(kdDiskFree, snapDiskFree(sc, d))                                   \
+  X(kdNetRx, deltaF32(sc, d.net_rx, kDataNone.net_rx))                 \
+  X(kdNetTx, deltaF32(sc, d.net_tx, kDataNone.net_tx))                 \
+  X(kdTemp, deltaF32(sc, d.tempC, kDataNone.tempC))                    \
+  X(kdDesc, snapStr(sc, d.weatherDesc, nullptr))                       \
+  X(kdApp, snapApp(sc))                                                \
+  X(kdDisks, snapArray(sc, d.disks, stage.tr.disks, snapDiskRow, '[')) \
+  X(kdNics, snapArray(sc, d.nics, stage.tr.nics, snapNicRow, '['))     \
+  X(kdProcs, snapArray(sc, d.procs, stage.tr.procs, snapProcRow, '[')) \
+  X(kdExtras, (stage.xSet = true, snapExtras(sc)))                     \
+  X(kdBoot, (stage.bootSet = true, sc.u32(stage.boot)))
+
+// Clé de champ: entier décimal, -1 sinon (t, s, k et clés étrangères)
+static int16_t deltaField(const JsonStr<24> &k) {
+  if (!k.whole || k.len == 0 || k.len > 3) return -1;
+  int16_t f = 0;
+  for (uint16_t i = 0; i < k.len; i++) {
+    if (!isdigit((unsigned char)k.s[i])) return -1;
+    f = (int16_t)(f * 10 + (k.s[i] - '0'));
+  }
+  return f;
+}
+
+// État de départ du delta dans la copie: l'actuel, ou rien pour une keyframe
+static void deltaBase() {
+  const bool key = stage.key != 0;
+  stage.d = key ? kDataNone : data;
+  stage.xSet = stage.appSet = key;
+}
+
+// true: ligne de delta lue dans stage (rien de publié: voir commitDelta)
+static bool scanDelta(const char *line, uint16_t len) {
+  JsonScan sc(line, len);
+  DataState &d = stage.d;
+  bool typed = false, based = false;
+  stage.tr = truncs;
+  stage.xCount = 0;
+  stage.app.len = 0;
+  stage.seq = stage.epoch = stage.boot = 0;
+  stage.key = 0;
+  stage.epochSet = stage.bootSet = false;
+  const bool ok = sc.object([&](JsonStr<24> &k) -> bool {
+    if (k.is("t")) {
+      JsonStr<8> t;
+      return sc.str(t) && (typed = t.is("d"));
+    }
+    if (k.is("s")) return sc.u32(stage.seq);
+    if (k.is("k")) return !based && sc.i32(stage.key);
+    const int16_t f = deltaField(k);
+    if (f < 0) return sc.skip();
+    if (!based) { deltaBase(); based = true; }
+    switch (f) { SNAP_DELTA_FIELDS(SNAP_INDEX_CASE) }
+    return sc.skip(); // kdHost (réservé) et clés à venir
+  });
+  if (!ok || !sc.done() || !typed) return false;
+  if (!based) deltaBase();
+  return true;
+}
+
+// Delta lu par scanDelta(): fusionné dans data s'il suit la séquence
+static bool commitDelta(uint32_t now) {
+  if (!deltaAccept((uint16_t)stage.seq, stage.key != 0, now)) return false;
+  data = stage.d;
+  truncs = stage.tr;
+  if (stage.xSet) {
+    memcpy(extras, stage.x, stage.xCount * sizeof(ExtraField));
+    extraCount = stage.xCount;
+  }
+  if (stage.appSet) setAppTitle(stage.app.s, stage.app.len);
+  if (stage.epochSet) deltaSync.setEpoch(stage.epoch, now);
+  if (stage.bootSet) deltaSync.setBoot(stage.boot);
+  TELE_COUNT(linesFast);
+  return true;
+}
+
+// File série en retard (loop()): les instantanés en attente derrière un plus
+// récent sont sautés sans être lus
+static constexpr bool kNewestWins = Profile::newestWins;
+
+// Instantané (objet sans "cmd" ni "t" au premier niveau)? Clés seules, valeurs
+// sautées: de quoi savoir si une ligne plus récente la rend inutile
+static bool isSnapshotLine(const char *line, uint16_t len) {
+  JsonScan sc(line, len);
+  return sc.object([&](JsonStr<24> &k) -> bool { return !k.is("cmd") && !k.is("t") && sc.skip(); }) && sc.done();
+}
+
+static bool updateFromJsonLine(const String &line) {
+  if (kJsonFastPath && scanSnapshot(line.c_str(), (uint16_t)line.length())) {
+    TELE_COUNT(linesOk);
+    TELE_COUNT(linesFast);
+    return applySnapshot(stage.time);
+  }
+  if (kJsonFastPath && kDeltaIngest && scanDelta(line.c_str(), (uint16_t)line.length())) {
+    const uint32_t now = nowMs();
+    return commitDelta(now) && deltaPublish(now);
+  }
+  static StaticJsonDocument<JSON_DOC_BYTES> doc;
+  DeserializationError err = deserializeJson(doc, line);
+  if (err) {
+    TELE_COUNT(linesBad);
+    Serial.print("Erreur JSON: "); Serial.println(err.f_str());
+    return false;
+  }
+  if (doc.containsKey("cmd")) {
+    handleCommand(doc);
+    return false; // pas une donnée: ne réveille pas l'UI
+  }
+  if (doc.containsKey("t")) return handleFrame(doc["t"] | "", doc);
+  TELE_COUNT(linesOk);
+  return applySnapshot(readSnapshotDoc(doc));
+}
+
+// Instantané lu (data à jour): cibles, historiques, agrégats, alertes, ticker
+static bool applySnapshot(bool hasTime) {
+  // Mettre à jour cibles et auto-échelle réseau (jauges CPU/RAM: les lots rapides priment)
+  bool live = liveActive();
+  if (data.cpu >= 0 && !live) ui.tgtCpu = data.cpu;
+  if (data.ram > 0 && data.ram_used >= 0 && !live) ui.tgtRamRatio = (float)data.ram_used / (float)data.ram;
+  uint32_t now = nowMs();
+  const float ramPct = (data.ram > 0 && data.ram_used >= 0) ? 100.0f * data.ram_used / data.ram : -1.0f;
+  history.add(now, data.cpu, ramPct);
+  if (Profile::flashHistory && hasTime) rrdSample(data.epoch, ramPct);
+  aggCpu.add(now, data.cpu >= 0 ? data.cpu : NAN);
+  aggRam.add(now, ramPct >= 0 ? ramPct : NAN);
+  aggNet.add(now, (isnan(data.net_rx) || isnan(data.net_tx)) ? NAN : max(0.0f, data.net_rx + data.net_tx));
+  aggTemp.add(now, data.tempC);
+  if (!live) alertSample(kAlertCpu, data.cpu >= 0 ? data.cpu : NAN, now);
+  if (!live) alertSample(kAlertRam, ramPct >= 0 ? ramPct : NAN, now);
+  if (data.ram > 0 && data.ram_used >= 0) alertSample(kAlertRamFree, (data.ram - data.ram_used) / 1024.0f, now);
+  if (!isnan(data.net_rx) && !isnan(data.net_tx)) alertSample(kAlertNet, max(0.0f, data.net_rx + data.net_tx), now);
+  alertSample(kAlertTemp, data.tempC, now);
+  if (!data.disks.empty()) {
+    uint32_t mn = UINT32_MAX;
+    for (const DiskEntry &d : data.disks) if (d.freeMB < mn) mn = d.freeMB;
+    alertSample(kAlertDiskFree, (float)mn, now);
+  } else if (data.diskFreeMB >= 0) alertSample(kAlertDiskFree, (float)data.diskFreeMB, now);
+  if (data.cpuMax >= ui.cpuPeak) { ui.cpuPeak = data.cpuMax; ui.cpuPeakUntil = now + PEAK_HOLD_MS; }
+  if (data.ram > 0 && data.ramMax >= 0) {
+    float r = (float)data.ramMax / (float)data.ram;
+    if (r >= ui.ramPeakRatio) { ui.ramPeakRatio = r; ui.ramPeakUntil = now + PEAK_HOLD_MS; }
   }
 
   // Ticker
   String t;
   if (!isnan(data.tempC)) { t += " "; t += (int)data.tempC; t += "C"; }
+  if (data.weatherDesc.length()) { t += " "; t += data.weatherDesc.c_str(); }
   if (data.cpu >= 0) { t += "  CPU "; t += (int)data.cpu; t += "%"; }
   if (data.ram > 0 && data.ram_used >= 0) { long freeMB = (data.ram - data.ram_used)/1024; t += "  RAM "; t += (int)freeMB; t += "MB"; }
-  if (data.diskFreeKB >= 0) { t += "  DISK "; t += fmtDisk(data.diskFreeKB); }
+  {
+    const WindowAgg c5 = aggCpu.get(AGG_5M), r15 = aggRam.get(AGG_15M);
+    if (!c5.empty()) { t += "  5m CPU "; t += (int)(c5.mean() + 0.5f); t += "% max "; t += (int)c5.max; t += "%"; }
+    if (!r15.empty()) { t += "  15m RAM max "; t += (int)r15.max; t += "%"; }
+  }
+  if (!data.disks.empty()) {
+    t += "  DISK";
+    for (const DiskEntry &d : data.disks) { t += " "; t += d.id.c_str(); t += " "; t += fmtDiskMB(d.freeMB); }
+  } else if (data.diskFreeMB >= 0) { t += "  DISK "; t += fmtDiskMB((uint32_t)data.diskFreeMB); }
   if (data.uptime >= 0) { t += "  UPT "; t += fmtUptime(data.uptime); }
+  for (const NicEntry &n : data.nics) {
+    if (isnan(n.rx) || isnan(n.tx)) continue;
+    t += "  "; t += n.id.c_str(); t += " "; t += fmtValue(n.rx); t += "/"; t += fmtValue(n.tx);
+  }
+  for (uint8_t i = 0; i < extraCount; i++) { t += "  "; t += extras[i].name; t += " "; t += fmtValue(extras[i].value); }
   if (t.length() == 0) t = " Smart Monitor";
-  ui.tickerText = t + "   ";
-  ui.tickerW = textWidth(ui.tickerText, 1); if (ui.tickerW < 1) ui.tickerW = 1;
+  t += "   ";
+  ui.ticker.assign(t.c_str(), t.length()); // UTF-8 décodé ici, pas à chaque frame
+  ui.tickerW = ui.ticker.width(); if (ui.tickerW < 1) ui.tickerW = 1;
   if (ui.tickerX > SCREEN_WIDTH) ui.tickerX = SCREEN_WIDTH;
 
   ui.hasData = true;
   return true;
 }
 
+// -----------------------------------------------------------------------------
+// Réseau: échelle automatique et page RX/TX (Profile::netView, sinon rien ne tourne)
+// L'échelle suit le pic de RX ou TX instantanément puis redescend avec une
+// constante de temps en temps réel, quelle que soit la cadence du bridge.
+// En échelle logarithmique, 1 Ko/s et le pic encadrent la barre.
+// -----------------------------------------------------------------------------
+#define NET_SCALE_TAU_S 300.0f  // 1/e en 5 min (l'ancien 0.996 par ligne à 2 s)
+#define NET_SCALE_MIN_KBS 1.0f
+#define GAUGE_PAGE_MS 8000      // CPU/RAM
+#define NET_PAGE_MS 4000        // RX/TX
+
+static bool netKnown() { return !isnan(data.net_rx) && !isnan(data.net_tx); }
+
+static float netRatio(float kbs) {
+  if (!(kbs > 0)) return 0;
+  float r = ui.netLog ? log1pf(kbs) / log1pf(ui.netMaxKBs) : kbs / ui.netMaxKBs;
+  return r > 1 ? 1 : r;
+}
+
+// Une fois par frame: décroissance de l'échelle, cibles, lissage et page affichée
+static void netStep(uint32_t now) {
+  const float dt = msSince(now, ui.netScaleMs) / 1000.0f;
+  ui.netScaleMs = now;
+  if (dt > 0) ui.netMaxKBs *= expf(-dt / NET_SCALE_TAU_S);
+  if (netKnown()) {
+    const float peak = max(data.net_rx, data.net_tx);
+    if (peak > ui.netMaxKBs) ui.netMaxKBs = peak; // montée immédiate
+  }
+  if (ui.netMaxKBs < NET_SCALE_MIN_KBS) ui.netMaxKBs = NET_SCALE_MIN_KBS;
+  ui.tgtRxRatio = netKnown() ? netRatio(data.net_rx) : 0;
+  ui.tgtTxRatio = netKnown() ? netRatio(data.net_tx) : 0;
+  ui.curRxRatio += (ui.tgtRxRatio - ui.curRxRatio) * Profile::ease;
+  ui.curTxRatio += (ui.tgtTxRatio - ui.curTxRatio) * Profile::ease;
+
+  if (reached(now, ui.pageUntil)) {
+    ui.netPage = !ui.netPage && netKnown();
+    ui.pageUntil = now + (ui.netPage ? NET_PAGE_MS : GAUGE_PAGE_MS);
+  }
+}
+
+static String fmtRate(float kbs) {
+  if (kbs < 1000) return String((long)(kbs + 0.5f)) + "K";
+  if (kbs < 10240) return String(kbs / 1024, 1) + "M";
+  return String((long)(kbs / 1024 + 0.5f)) + "M";
+}
+
 // -----------------------------------------------------------------------------
 // Rendu: Header / Jauges / Infos / Ticker
 // -----------------------------------------------------------------------------
 static void drawHeader() {
   const int H = 10; // plus compact
-  display.fillRect(0, 0, SCREEN_WIDTH, H, SH110X_WHITE);
-  display.setTextColor(SH110X_BLACK, SH110X_WHITE);
-  display.setTextSize(1);
+  gfx.fillRect(0, 0, SCREEN_WIDTH, H, INK);
 
   // Temp à gauche
-  display.setCursor(2, 2);
   String tempStr = isnan(data.tempC) ? String("--C") : fmtTempC((int)data.tempC);
-  display.print(tempStr);
+  // Tendance CPU: moyenne 1 min nettement au-dessus/au-dessous de celle sur 15 min
+  const WindowAgg c1 = aggCpu.get(AGG_1M), c15 = aggCpu.get(AGG_15M);
+  if (!c1.empty() && c15.count > c1.count) {
+    float d = c1.mean() - c15.mean();
+    if (d > AGG_TREND_PCT) tempStr += '^';
+    else if (d < -AGG_TREND_PCT) tempStr += 'v';
+  }
+  drawText(gfx, 2, 2, tempStr, PAPER);
 
-  // Titre = nom de l'app (ou fallback)
-  String title = appName.length() ? appName : String("SMON");
+  // Titre = nom de l'app (ou fallback), coupé à la largeur réelle
   // Espace dispo à droite de la température
-  int tempW = textWidth(tempStr, 1);
+  int tempW = textWidth(tempStr);
   int xAvail = 2 + tempW + 4; // petite marge
   int availW = SCREEN_WIDTH - xAvail - 2; if (availW < 0) availW = 0;
-  String clipped = clipToWidth(title, availW);
-  int tw = textWidth(clipped, 1);
-  int tx = xAvail + (availW - tw) / 2; if (tx < xAvail) tx = xAvail;
-  display.setCursor(tx, 2);
-  display.print(clipped);
-  display.setTextColor(SH110X_WHITE, SH110X_BLACK); // reset
+  auto fit = appTitle.fit(availW);
+  int tx = xAvail + (availW - fit.w) / 2; if (tx < xAvail) tx = xAvail;
+  appTitle.draw(gfx, tx, 2, PAPER, fit);
+}
+
+// Trait vertical inversé: visible sur la partie pleine comme sur la partie vide
+static void drawPeakMarker(int x, int y, int iw, float fillRatio, float peakRatio) {
+  if (peakRatio > 1) peakRatio = 1;
+  int fw = (int)(iw * fillRatio + 0.5f);
+  int px = (int)(iw * peakRatio + 0.5f) - 1;
+  if (px < fw || px < 0) return; // pic confondu avec la barre
+  gfx.vspan(x + px, y, 5, kInvert);
+}
+
+// Jauge RX ou TX (même gabarit que CPU/RAM); en log, une graduation par décade
+static void drawNetGauge(int labelX, int x, int y, int w, const char *label, float kbs, float ratio) {
+  drawText(gfx, labelX, y, label + fmtRate(kbs));
+  y += 8;
+  gfx.rect(x, y, w, 7, INK);
+  const int iw = w - 2;
+  float fw = iw * ratio; if (fw < 0) fw = 0; if (fw > iw) fw = (float)iw;
+  gfx.fillRectAA(x + 1, y + 1, fw, 5);
+  if (ui.netLog)
+    for (float d = 10; d < ui.netMaxKBs; d *= 10) gfx.vspan(x + 1 + (int)(iw * netRatio(d)), y + 7, 2, INK);
 }
 
 static void drawGauges() {
@@ -222,22 +1444,30 @@ static void drawGauges() {
   // --- Colonne gauche: jauges ---
   int y = headerH + 2;
   const int labelX = max(0, leftX - 2); // libellés un peu plus à gauche
+  if (Profile::netView && ui.netPage) {
+    drawNetGauge(labelX, leftX, y, colW, "RX ", data.net_rx, ui.curRxRatio);
+    drawNetGauge(labelX, leftX, y + 18, colW, "TX ", data.net_tx, ui.curTxRatio);
+    ui.gaugesBottomY = y + 18 + 15;
+    return;
+  }
   // CPU
-  display.setCursor(labelX, y); display.print("CPU:");
+  drawText(gfx, labelX, y, "CPU:");
   y += 8; // plus d'espace sous le libellé pour lisibilité
-  display.drawRect(leftX, y, colW, 7, SH110X_WHITE);
+  gfx.rect(leftX, y, colW, 7, INK);
   {
-    int iw = colW - 2; int fw = (int)(iw * (ui.curCpu / 100.0f) + 0.5f); if (fw < 0) fw = 0; if (fw > iw) fw = iw;
-    if (fw > 0) display.fillRect(leftX + 1, y + 1, fw, 5, SH110X_WHITE);
+    int iw = colW - 2; float fw = iw * (ui.curCpu / 100.0f); if (fw < 0) fw = 0; if (fw > iw) fw = (float)iw;
+    gfx.fillRectAA(leftX + 1, y + 1, fw, 5); // bord anticrénelé en niveaux de gris
+    drawPeakMarker(leftX + 1, y + 1, iw, ui.curCpu / 100.0f, ui.cpuPeak / 100.0f);
   }
   y += 7 + 3;
   // RAM
-  display.setCursor(labelX, y); display.print("RAM:");
+  drawText(gfx, labelX, y, "RAM:");
   y += 8; // même espacement accru
-  display.drawRect(leftX, y, colW, 7, SH110X_WHITE);
+  gfx.rect(leftX, y, colW, 7, INK);
   {
-    int iw = colW - 2; int fw = (int)(iw * ui.curRamRatio + 0.5f); if (fw < 0) fw = 0; if (fw > iw) fw = iw;
-    if (fw > 0) display.fillRect(leftX + 1, y + 1, fw, 5, SH110X_WHITE);
+    int iw = colW - 2; float fw = iw * ui.curRamRatio; if (fw < 0) fw = 0; if (fw > iw) fw = (float)iw;
+    gfx.fillRectAA(leftX + 1, y + 1, fw, 5);
+    drawPeakMarker(leftX + 1, y + 1, iw, ui.curRamRatio, ui.ramPeakRatio);
   }
   y += 7;
   ui.gaugesBottomY = y;
@@ -266,10 +1496,14 @@ static void drawInfoLines() {
   int cx = startRight + areaW / 2;
   int cy = topY + areaH / 2 + ui.headBob;
 
-  // Humeur selon moyenne CPU/RAM
+  // Humeur selon moyenne CPU/RAM sur la dernière minute (instantané à défaut):
+  // un pic isolé ne fait plus grimacer le visage
+  const WindowAgg cpu1 = aggCpu.get(AGG_1M), ram1 = aggRam.get(AGG_1M);
   float load = 0.0f;
-  if (data.cpu >= 0) load += (data.cpu/100.0f);
-  if (data.ram > 0 && data.ram_used >= 0) load += ((float)data.ram_used/(float)data.ram);
+  if (!cpu1.empty()) load += cpu1.mean()/100.0f;
+  else if (data.cpu >= 0) load += (data.cpu/100.0f);
+  if (!ram1.empty()) load += ram1.mean()/100.0f;
+  else if (data.ram > 0 && data.ram_used >= 0) load += ((float)data.ram_used/(float)data.ram);
   load *= 0.5f;
 
   // Visage (yeux, sourcils, bouche)
@@ -281,65 +1515,61 @@ static void drawInfoLines() {
   int eyeHRight = ui.tamaBlink ? 1 : max(2, r/5);
   // Yeux (mode sommeil: lignes fermées)
   if (ui.tamaSleeping) {
-    display.drawFastHLine(cx - eyeDX - eyeW/2, eyeY, eyeW, SH110X_WHITE);
-    display.drawFastHLine(cx + eyeDX - eyeW/2, eyeY, eyeW, SH110X_WHITE);
+    gfx.hspan(cx - eyeDX - eyeW/2, eyeY, eyeW, INK);
+    gfx.hspan(cx + eyeDX - eyeW/2, eyeY, eyeW, INK);
   } else {
-    display.fillRect(cx - eyeDX - eyeW/2, eyeY - eyeHLeft/2, eyeW, eyeHLeft, SH110X_WHITE);
-    display.fillRect(cx + eyeDX - eyeW/2, eyeY - eyeHRight/2, eyeW, eyeHRight, SH110X_WHITE);
+    gfx.fillRect(cx - eyeDX - eyeW/2, eyeY - eyeHLeft/2, eyeW, eyeHLeft, INK);
+    gfx.fillRect(cx + eyeDX - eyeW/2, eyeY - eyeHRight/2, eyeW, eyeHRight, INK);
   }
   // Sourcils (indicatifs humeur)
   int mouthY = cy + r/4;
   int mouthW = max(6, (int)(r * 0.7f)); // bouche un peu moins large
   if (ui.tamaSleeping) {
     // bouche neutre
-    display.drawFastHLine(cx - mouthW/2, mouthY, mouthW, SH110X_WHITE);
+    gfx.hspan(cx - mouthW/2, mouthY, mouthW, INK);
   } else if (load < 0.42f) {
   // heureux: petits arcs au-dessus des yeux (mignons)
   int lx0 = cx - eyeDX - eyeW;
   int lx1 = cx - eyeDX + eyeW;
   int lxc = (lx0 + lx1) / 2;
   int ly  = eyeY - eyeHLeft - 4; // un peu plus haut
-  display.drawLine(lx0, ly, lxc, ly - 2, SH110X_WHITE);
-  display.drawLine(lxc, ly - 2, lx1, ly, SH110X_WHITE);
+  gfx.line(lx0, ly, lxc, ly - 2);
+  gfx.line(lxc, ly - 2, lx1, ly);
 
   int rx0 = cx + eyeDX - eyeW;
   int rx1 = cx + eyeDX + eyeW;
   int rxc = (rx0 + rx1) / 2;
   int ry  = eyeY - eyeHRight - 4;
-  display.drawLine(rx0, ry, rxc, ry - 2, SH110X_WHITE);
-  display.drawLine(rxc, ry - 2, rx1, ry, SH110X_WHITE);
+  gfx.line(rx0, ry, rxc, ry - 2);
+  gfx.line(rxc, ry - 2, rx1, ry);
   } else if (load > 0.68f) {
-    display.drawLine(cx - eyeDX - eyeW, eyeY - eyeHLeft - 1, cx - eyeDX + eyeW, eyeY - eyeHLeft - 0, SH110X_WHITE);
-    display.drawLine(cx + eyeDX - eyeW, eyeY - eyeHRight - 0, cx + eyeDX + eyeW, eyeY - eyeHRight - 1, SH110X_WHITE);
+    gfx.line(cx - eyeDX - eyeW, eyeY - eyeHLeft - 1, cx - eyeDX + eyeW, eyeY - eyeHLeft - 0);
+    gfx.line(cx + eyeDX - eyeW, eyeY - eyeHRight - 0, cx + eyeDX + eyeW, eyeY - eyeHRight - 1);
   }
 
   // Zz bulle de sommeil
   if (ui.tamaSleeping) {
     // animation lente des 'Z'
-    if (millis() - ui.sleepMs > 600) { ui.sleepMs = millis(); ui.sleepStep = (ui.sleepStep + 1) % 3; }
+    if (nowMs() - ui.sleepMs > 600) { ui.sleepMs = nowMs(); ui.sleepStep = (ui.sleepStep + 1) % 3; }
     int zx = cx + r - 4;
     int zy = cy - r + 4 + (ui.sleepStep == 1 ? -1 : ui.sleepStep == 2 ? -2 : 0);
-    // deux petits Z superposés
-    display.drawLine(zx, zy, zx + 3, zy, SH110X_WHITE);
-    display.drawLine(zx + 1, zy - 1, zx + 1, zy + 2, SH110X_WHITE);
-    display.drawLine(zx, zy + 2, zx + 3, zy + 2, SH110X_WHITE);
-    display.drawLine(zx + 5, zy - 3, zx + 8, zy - 3, SH110X_WHITE);
-    display.drawLine(zx + 6, zy - 4, zx + 6, zy - 1, SH110X_WHITE);
-    display.drawLine(zx + 5, zy - 1, zx + 8, zy - 1, SH110X_WHITE);
+    // deux petits Z superposés (motif 9x7 en colonnes, bit 0 = zy - 4)
+    static const uint8_t kZz[9] = {0x50, 0x78, 0x50, 0x50, 0x00, 0x0A, 0x0F, 0x0A, 0x0A};
+    gfx.blit(kZz, sizeof(kZz), 7, zx, zy - 4, INK);
   }
 
   if (!ui.tamaSleeping) {
     if (load < 0.42f) {
       // sourire
-      display.drawLine(cx - mouthW/2, mouthY + 2, cx, mouthY + 4, SH110X_WHITE);
-      display.drawLine(cx, mouthY + 4, cx + mouthW/2, mouthY + 2, SH110X_WHITE);
+      gfx.line(cx - mouthW/2, mouthY + 2, cx, mouthY + 4);
+      gfx.line(cx, mouthY + 4, cx + mouthW/2, mouthY + 2);
     } else if (load < 0.68f) {
       // neutre
-      display.drawFastHLine(cx - mouthW/2, mouthY, mouthW, SH110X_WHITE);
+      gfx.hspan(cx - mouthW/2, mouthY, mouthW, INK);
     } else {
       // triste
-      display.drawLine(cx - mouthW/2, mouthY + 2, cx, mouthY, SH110X_WHITE);
-      display.drawLine(cx, mouthY, cx + mouthW/2, mouthY + 2, SH110X_WHITE);
+      gfx.line(cx - mouthW/2, mouthY + 2, cx, mouthY);
+      gfx.line(cx, mouthY, cx + mouthW/2, mouthY + 2);
     }
   }
 
@@ -347,31 +1577,172 @@ static void drawInfoLines() {
   if (ui.tamaSweat) {
     int sx = cx + eyeDX + 2;
     int sy = eyeY - 2;
-    display.drawLine(sx, sy, sx + 1, sy + 2, SH110X_WHITE);
-    display.drawLine(sx + 1, sy + 2, sx, sy + 4, SH110X_WHITE);
+    gfx.line(sx, sy, sx + 1, sy + 2);
+    gfx.line(sx + 1, sy + 2, sx, sy + 4);
   }
 }
 
 static void drawTicker() {
   const int tickH = 9;
   int tickY = SCREEN_HEIGHT - tickH + 2;
-  display.drawFastHLine(0, tickY - 2, SCREEN_WIDTH, SH110X_WHITE);
-  display.setCursor(ui.tickerX, tickY);
-  display.print(ui.tickerText);
+  // Alerte "banner" active: bandeau inversé fixe à la place du défilement
+  const int8_t a = alerts.newestActive(ALERT_FX_BANNER);
+  if (a >= 0) {
+    gfx.fillRect(0, tickY - 2, SCREEN_WIDTH, tickH, INK);
+    drawText(gfx, 2, tickY, "! " + alertLabel(alerts.rule((uint8_t)a)), PAPER);
+    return;
+  }
+  gfx.hspan(0, tickY - 2, SCREEN_WIDTH, INK);
+  ui.ticker.draw(gfx, ui.tickerX, tickY, INK);
+}
+
+// Historique CPU (barre = moyenne, point = pic) et RAM (point) sur les
+// HIST_SLOTS derniers créneaux, le plus récent à droite, dans une zone
+// 128x64 à partir de y0 de la surface donnée.
+// En 1 bit le point RAM s'éteint dans la barre; en gris la barre est atténuée.
+template <class Surf>
+static void drawHistory(Surf &surf, int y0) {
+  const int gx = 4, gw = 120, gy = y0 + 11, gh = 42;
+  const uint8_t ink = Surf::kInk, bar = Surf::kInk > 1 ? Surf::kInk / 3 : Surf::kInk;
+  drawText(surf, 0, y0, "CPU/RAM " + String((int)(HIST_SLOTS * HIST_SLOT_MS / 60000UL)) + "min");
+  String cur = String((int)ui.curCpu) + "%";
+  printRightAligned(surf, SCREEN_WIDTH, y0, cur);
+
+  const int colW = gw / HIST_SLOTS > 0 ? gw / HIST_SLOTS : 1;
+  for (uint16_t age = 0; age < HIST_SLOTS; age++) {
+    const HistSlot &sl = history.at(age);
+    int x = gx + gw - (age + 1) * colW;
+    if (x < gx) break;
+    int top = gy + gh;
+    if (!sl.empty()) {
+      int h = sl.cpu * gh / 100;
+      top -= h;
+      if (h > 0) surf.fillRect(x, top, colW, h, bar);
+      if (sl.cpuMax != HistSlot::kEmpty) surf.pixel(x, gy + gh - 1 - sl.cpuMax * (gh - 1) / 100, ink);
+    }
+    if (sl.ram != HistSlot::kEmpty) {
+      int ry = gy + gh - 1 - sl.ram * (gh - 1) / 100;
+      surf.pixel(x, ry, ry >= top && bar == ink ? PAPER : ink);
+    }
+  }
+  surf.hspan(gx, gy + gh, gw, ink);
+
+  drawText(surf, 0, y0 + 56, "-" + String((int)(HIST_SLOTS * HIST_SLOT_MS / 3600000UL)) + "h");
+  if (data.ram > 0 && data.ram_used >= 0) {
+    String ram = "RAM " + String((int)(100.0f * data.ram_used / data.ram)) + "%";
+    drawText(surf, (SCREEN_WIDTH - textWidth(ram)) / 2, y0 + 56, ram);
+  }
+  printRightAligned(surf, SCREEN_WIDTH, y0 + 56, "now");
+}
+
+// -----------------------------------------------------------------------------
+// Pages: processus, réseau; rotation et transitions
+// -----------------------------------------------------------------------------
+static void drawTitleBar(const char *title, const String &right) {
+  gfx.fillRect(0, 0, SCREEN_WIDTH, 10, INK);
+  drawText(gfx, 2, 2, title, PAPER);
+  drawText(gfx, SCREEN_WIDTH - 2 - textWidth(right), 2, right, PAPER);
+}
+
+// Processus les plus actifs: % d'un cœur, barre plafonnée à 100 %
+static void drawProcsPage() {
+  drawTitleBar("TOP CPU", data.cpu >= 0 ? fmtPercent((int)data.cpu) : String("--"));
+  if (data.procs.empty()) { drawText(gfx, 2, 28, "--"); return; }
+  int y = 12;
+  for (const ProcEntry &p : data.procs) {
+    drawText(gfx, 2, y, p.id.c_str());
+    printRightAligned(gfx, SCREEN_WIDTH - 2, y, fmtPercent((int)(p.cpu + 0.5f)));
+    gfx.fillRectAA(2, y + 8, (SCREEN_WIDTH - 4) * min(p.cpu, 100.0f) / 100.0f, 2);
+    y += 13;
+  }
+}
+
+// RX/TX pleine largeur (même échelle que la vue d'ensemble) puis une ligne par interface
+static void drawNetPage() {
+  drawTitleBar("NET", "max " + fmtRate(ui.netMaxKBs));
+  if (!Profile::netView || !netKnown()) { drawText(gfx, 2, 28, "--"); return; }
+  drawNetGauge(2, 2, 12, SCREEN_WIDTH - 4, "RX ", data.net_rx, ui.curRxRatio);
+  drawNetGauge(2, 2, 30, SCREEN_WIDTH - 4, "TX ", data.net_tx, ui.curTxRatio);
+  int y = 48;
+  for (const NicEntry &n : data.nics) {
+    if (y > SCREEN_HEIGHT - 8) break;
+    if (isnan(n.rx) || isnan(n.tx)) continue;
+    drawText(gfx, 2, y, n.id.c_str());
+    printRightAligned(gfx, SCREEN_WIDTH - 2, y, fmtRate(n.rx) + "/" + fmtRate(n.tx));
+    y += 8;
+  }
+}
+
+static void drawPage(uint8_t p) {
+  switch (p) {
+    case PAGE_HISTORY: drawHistory(gfx, 0); break;
+    case PAGE_PROCS: drawProcsPage(); break;
+    case PAGE_NET: drawNetPage(); break;
+    default: drawHeader(); drawGauges(); drawInfoLines(); drawTicker();
+  }
+}
+
+// La rotation saute les pages sans données; un bandeau d'alerte ramène à la vue d'ensemble
+static bool pageAvailable(uint8_t p) {
+  if (p == PAGE_OVERVIEW) return true;
+  if (alerts.newestActive(ALERT_FX_BANNER) >= 0) return false;
+  if (p == PAGE_PROCS) return !data.procs.empty();
+  if (p == PAGE_NET) return Profile::netView && netKnown();
+  return true;
+}
+
+static void pagesCycle(uint32_t now) {
+  if (!pages.cycleMs) return;
+  if (!pageAvailable(pages.want)) pages.want = PAGE_OVERVIEW;
+  if (!reached(now, pages.nextMs)) return;
+  pages.nextMs = now + pages.cycleMs;
+  uint8_t p = pages.want;
+  do p = (uint8_t)((p + 1) % PAGE_COUNT); while (!pageAvailable(p));
+  pages.want = p;
+}
+
+// Ligne de départ du SH1106 (transitions); le SSD1327 n'en a pas l'usage
+static void setStartLine(uint8_t line) {
+#if !SMON_PANEL_SSD1327
+  display.setStartLine(line);
+#else
+  (void)line;
+#endif
+}
+
+// Frame de l'écran principal: la page courante, ou l'étape suivante de la
+// transition (les deux images restent figées le temps du défilement)
+static void renderMain(uint32_t now) {
+  if (kUiPages) {
+    pagesCycle(now);
+    if (!pageRoll.active() && pages.want != pages.shown) {
+      uint8_t *fb = gfx.buffer();
+      gfx.attach(pageRoll.begin(fb, now));
+      gfx.clear();
+      drawPage(pages.want);
+      gfx.attach(fb);
+      pages.shown = pages.want;
+      pages.switches++;
+    }
+    if (pageRoll.active()) { pageRoll.step(now, gfx.buffer()); return; }
+  }
+  display.clearDisplay();
+  drawPage(pages.shown);
+#if SMON_PANEL_SSD1327
+  drawHistory(gfx, SCREEN_HEIGHT);
+#endif
 }
 
 static void paintWaiting() {
-  static unsigned long lastPaint = 0;
-  if (millis() - lastPaint < 1000) return;
-  lastPaint = millis();
+  static uint32_t lastPaint = 0;
+  if (nowMs() - lastPaint < 1000) return;
+  lastPaint = nowMs();
   display.clearDisplay();
-  display.setTextSize(1);
-  display.setTextColor(SH110X_WHITE);
-  display.setCursor(0, 0); display.print("Smart Monitor");
-  display.setCursor(0, 16); display.print("En attente donnees...");
-  display.setCursor(0, 28); display.print("Verifiez script host");
-  display.setCursor(0, 40); display.print("115200 baud");
-  display.display();
+  drawText(gfx, 0, 0, "Smart Monitor");
+  drawText(gfx, 0, 16, "En attente donnees...");
+  drawText(gfx, 0, 28, "Verifiez script host");
+  drawText(gfx, 0, 40, "115200 baud");
+  display.commit(lastPaint);
 }
 
 // -----------------------------------------------------------------------------
@@ -380,17 +1751,27 @@ static void paintWaiting() {
 void setup() {
   Serial.begin(115200);
 #if defined(ARDUINO_ARCH_ESP32)
-  Serial.setRxBufferSize(1024);
+  Serial.setRxBufferSize(Profile::rxBuffer);
 #endif
   Wire.begin();
 
   delay(200);
-  display.begin(I2C_ADDRESS, true);
+  display.begin(I2C_ADDRESS);
+  gfx.attach(display.getBuffer());
   display.clearDisplay();
-  display.setTextSize(1);
-  display.setTextColor(SH110X_WHITE);
-  display.setCursor(0, 0); display.print("Smart Monitor");
-  display.display();
+  drawText(gfx, 0, 0, "Smart Monitor");
+  display.flushAll(nowMs());
+  flusher.attach(display);
+#ifdef SMON_PANEL2_ADDR
+  histOk = histPanel.begin(SMON_PANEL2_ADDR);
+  if (histOk) {
+    histGfx.attach(histPanel.getBuffer());
+    histPanel.clearDisplay();
+    drawText(histGfx, 0, 0, "Historique");
+    histPanel.flushAll(nowMs());
+    flusher.attach(histPanel);
+  }
+#endif
 
   // Seed aléatoire pour les animations
 #if defined(ARDUINO_ARCH_ESP32)
@@ -398,106 +1779,291 @@ void setup() {
 #else
   randomSeed(analogRead(0));
 #endif
+
+  // Échéances armées sur l'horloge courante: 0 serait "dans le futur" pour
+  // reached() dès qu'elle dépasse 2^31 ms
+  ui.tamaNextBlink = ui.cpuPeakUntil = ui.ramPeakUntil = nowMs();
+  appTitle.assign("SMON");
+
+  // Partition "spiffs" en LittleFS, formatée au premier démarrage
+  if (Profile::flashHistory && LittleFS.begin(true)) rrd.begin(LittleFS);
+
+  sendHello(); // après un reset, le bridge renvoie l'historique manquant
+}
+
+// 2e écran (historique), à son rythme propre, que l'écran principal soit rendu ici ou par l'hôte
+static void drawHistPanel(uint32_t now) {
+#ifdef SMON_PANEL2_ADDR
+  static uint32_t nextHist = now;
+  if (histOk && reached(now, nextHist)) {
+    nextHist = now + Profile::histFrameMs;
+    histPanel.clearDisplay();
+    drawHistory(histGfx, 0);
+    histPanel.commit(now);
+  }
+#else
+  (void)now;
+#endif
 }
 
 void loop() {
-  // 1) Lecture série ligne par ligne (CR ou LF)
-  static String line; static unsigned long lastDataMs = 0;
-  while (Serial.available()) {
+  // 0) Pages en attente des écrans: une tranche de bus, puis on rend la main à la série
+  flusher.service(nowMs(), Profile::flushSliceUs);
+  // Transition de page: la ligne de départ suit les bandes de l'étape, une fois celles-ci sur l'écran
+  uint8_t startLine;
+  if (kUiPages && !display.pending() && pageRoll.takeLine(startLine)) setStartLine(startLine);
+
+  // 1) Lecture série ligne par ligne (CR ou LF), au plus rxBuffer octets par
+  //    passage: un afflux ne retarde la frame que d'un tampon. Si d'autres octets
+  //    attendent, un instantané est mis de côté au lieu d'être lu: le suivant le
+  //    remplace (compté). Le plus récent est appliqué avant la première commande
+  //    ou trame typée qui le suit, sinon en fin de lecture: l'ordre d'arrivée
+  //    est respecté, seuls les instantanés consécutifs sont fusionnés.
+  static String line, snap; static uint32_t lastDataMs = 0; static bool gotData = false;
+  static bool lineOverflow = false;
+  auto take = [](const String &l) { if (updateFromJsonLine(l)) { lastDataMs = nowMs(); gotData = true; } };
+  auto flushSnap = [&]() { if (kNewestWins && snap.length()) { take(snap); snap = ""; } };
+  for (uint16_t n = 0; n < Profile::rxBuffer && Serial.available(); n++) {
     char c = (char)Serial.read();
     if (c == '\n' || c == '\r') {
       line.trim();
-      if (line.length() > 0) {
-        if (updateFromJsonLine(line)) lastDataMs = millis();
+      if (lineOverflow) {
+        TELE_COUNT(linesOverflow); // tronquée: inutile de tenter le parse
+      } else if (line.length() > 0) {
+        if (kNewestWins && (snap.length() || Serial.available()) &&
+            isSnapshotLine(line.c_str(), (uint16_t)line.length())) {
+          if (snap.length()) TELE_COUNT(linesSkipped);
+          snap = line;
+        } else {
+          flushSnap();
+          take(line);
+        }
       }
       line = "";
+      lineOverflow = false;
     } else {
       // Autoriser des lignes JSON un peu plus longues
-      if (line.length() < 1536) line += c;
+      if (line.length() < Profile::lineMax) line += c;
+      else lineOverflow = true;
     }
   }
+  flushSnap();
+#if SMON_INSTRUMENT
+  emitTelemetry(nowMs());
+#endif
+  if (Profile::flashHistory && dump.on) rrdDumpStep(); // une page par passage
+
+  // Frames de l'hôte: l'écran n'est plus qu'un framebuffer, le rendu local attend.
+  // L'accusé part quand les pages de la frame sont sur l'écran (contrôle de flux).
+  if (kHostFrames && hostFb.active(nowMs())) {
+    if (pageRoll.active()) { pageRoll.cancel(); setStartLine(0); } // les pages de l'hôte s'écrivent ligne 0 en haut
+    if (!display.pending() && hostFb.takeAck()) {
+      char buf[32];
+      snprintf(buf, sizeof(buf), "{\"t\":\"fbk\",\"s\":%u}", (unsigned)hostFb.last());
+      Serial.println(buf);
+    }
+    drawHistPanel(nowMs());
+    return;
+  }
 
   // 2) Connexion/attente: si jamais aucune donnée reçue, écran d'attente.
   //    Sinon, en cas de perte de données, on montre le tamagochi endormi au lieu d'un écran plein.
-  if (lastDataMs == 0) {
+  if (!gotData) {
     paintWaiting();
     return;
   }
-  if ((millis() - lastDataMs) > 4000) {
+  if (nowMs() - lastDataMs > Profile::noDataSleepMs) {
     ui.tamaSleeping = true; // dort si plus de données récentes, mais on continue à rendre l'UI
   }
 
   // 3) Animation douce (moins d'agitation)
-  static unsigned long lastAnim = 0;
-  if (millis() - lastAnim < 60) return; // ~16 FPS max
-  lastAnim = millis();
+  static uint32_t lastAnim = 0;
+  if (nowMs() - lastAnim < Profile::frameMs) return; // cadence du profil (~16 FPS par défaut)
+  // Sans dérive: une tranche de flush qui retarde une frame ne décale pas les suivantes
+  lastAnim = nowMs() - lastAnim < 2u * Profile::frameMs ? lastAnim + Profile::frameMs : nowMs();
+
+  // Échantillons rapides échus: le dernier devient la cible, chacun nourrit le pic
+  TimedSample sm;
+  while (liveQueue.popDue(nowMs(), sm)) {
+    ui.tgtCpu = sm.cpu;
+    alertSample(kAlertCpu, sm.cpu, nowMs());
+    if (sm.ram != 0xFF) alertSample(kAlertRam, sm.ram, nowMs());
+    if (sm.cpu >= ui.cpuPeak) { ui.cpuPeak = sm.cpu; ui.cpuPeakUntil = nowMs() + PEAK_HOLD_MS; }
+    if (sm.ram != 0xFF) ui.tgtRamRatio = sm.ram / 100.0f;
+  }
+  const float follow = liveActive() ? Profile::easeLive : Profile::ease; // en direct: suivi plus vif des transitoires
 
-  ui.curCpu += (ui.tgtCpu - ui.curCpu) * 0.15f;
+  ui.curCpu += (ui.tgtCpu - ui.curCpu) * follow;
   if (ui.curCpu < 0) ui.curCpu = 0; if (ui.curCpu > 100) ui.curCpu = 100;
-  ui.curRamRatio += (ui.tgtRamRatio - ui.curRamRatio) * 0.15f;
+  ui.curRamRatio += (ui.tgtRamRatio - ui.curRamRatio) * follow;
   if (ui.curRamRatio < 0) ui.curRamRatio = 0; if (ui.curRamRatio > 1) ui.curRamRatio = 1;
-  ui.curNetRatio += (ui.tgtNetRatio - ui.curNetRatio) * 0.15f;
-  if (ui.curNetRatio < 0) ui.curNetRatio = 0; if (ui.curNetRatio > 1) ui.curNetRatio = 1;
+  if (Profile::netView) netStep(nowMs());
 
-  // Ticker avance lentement
-  ui.tickerX -= 1; if (ui.tickerX + ui.tickerW < 0) ui.tickerX = SCREEN_WIDTH;
+  // Peak-hold: après le maintien, le pic redescend vers la valeur affichée
+  {
+    static uint32_t lastPeakMs = nowMs();
+    uint32_t t = nowMs();
+    const float step = PEAK_DECAY_PER_S * (float)(t - lastPeakMs) / 1000.0f;
+    lastPeakMs = t;
+    // Échéance passée: on la garde collée à t, sinon elle redeviendrait "future" 24,8 jours plus tard
+    if (reached(t, ui.cpuPeakUntil)) { ui.cpuPeakUntil = t; ui.cpuPeak = max(ui.curCpu, ui.cpuPeak - step * 100.0f); }
+    if (reached(t, ui.ramPeakUntil)) { ui.ramPeakUntil = t; ui.ramPeakRatio = max(ui.curRamRatio, ui.ramPeakRatio - step); }
+  }
+
+  // Ticker avance lentement (même vitesse quelle que soit la cadence du profil)
+  static uint8_t tickerPhase = 0;
+  if (++tickerPhase >= Profile::tickerEvery) {
+    tickerPhase = 0;
+    ui.tickerX -= 1; if (ui.tickerX + ui.tickerW < 0) ui.tickerX = SCREEN_WIDTH;
+  }
 
   // Animation Tamagochi: clignement et phase bouche
-  unsigned long now = millis();
-  if (now > ui.tamaNextBlink) {
+  uint32_t now = nowMs();
+  if (reached(now, ui.tamaNextBlink)) {
     ui.tamaBlink = true;
     ui.tamaBlinkUntil = now + 120; // cligne ~120ms
     ui.tamaNextBlink = now + 2000 + (now % 3000);
   }
-  if (ui.tamaBlink && now > ui.tamaBlinkUntil) ui.tamaBlink = false;
+  if (ui.tamaBlink && reached(now, ui.tamaBlinkUntil)) ui.tamaBlink = false;
   if (now - ui.tamaMouthMs > 300) { ui.tamaMouthMs = now; ui.tamaMouthPhase = (ui.tamaMouthPhase + 1) & 3; }
 
   // Clin d'œil occasionnel
-  static unsigned long nextWink = 0;
-  if (now > nextWink) {
-    if ((random(100) < 10) && !ui.tamaBlink) { // 10% chance
+  static uint32_t nextWink = nowMs();
+  if (Profile::animations && reached(now, nextWink)) {
+    if ((rnd(100) < 10) && !ui.tamaBlink) { // 10% chance
       ui.tamaWink = true; ui.tamaWinkUntil = now + 120;
     }
-    nextWink = now + 1500 + random(2000);
+    nextWink = now + 1500 + rnd(2000);
   }
-  if (ui.tamaWink && now > ui.tamaWinkUntil) ui.tamaWink = false;
+  if (ui.tamaWink && reached(now, ui.tamaWinkUntil)) ui.tamaWink = false;
 
   // (langue désactivée)
 
   // Sueur quand charge haute ou au hasard
-  static unsigned long nextSweat = 0;
+  static uint32_t nextSweat = nowMs();
   float loadNow = 0.0f; loadNow += ui.curCpu/100.0f; loadNow += ui.curRamRatio; loadNow *= 0.5f;
-  if (now > nextSweat) {
+  if (Profile::animations && reached(now, nextSweat)) {
     int prob = (int)(max(0.0f, (loadNow - 0.7f)) * 100); // augmente >70%
     prob += 5; // légère chance même basse charge
-    if (random(100) < prob) { ui.tamaSweat = true; ui.tamaSweatUntil = now + 500; }
-    nextSweat = now + 2000 + random(2000);
+    if (rnd(100) < prob) { ui.tamaSweat = true; ui.tamaSweatUntil = now + 500; }
+    nextSweat = now + 2000 + rnd(2000);
   }
-  if (ui.tamaSweat && now > ui.tamaSweatUntil) ui.tamaSweat = false;
+  if (ui.tamaSweat && reached(now, ui.tamaSweatUntil)) ui.tamaSweat = false;
 
   // Head bob léger
-  ui.headBob = (int8_t)(sin(now / 400.0) * 1.5);
+  if (Profile::animations) ui.headBob = (int8_t)(sin(now / 400.0) * 1.5);
 
   // Sommeil: si charge faible prolongée, entrer en sommeil
   float curLoad = 0.0f; curLoad += ui.curCpu/100.0f; curLoad += ui.curRamRatio; curLoad *= 0.5f;
   if (curLoad < 0.22f) { // seuil un peu plus permissif
-    if (ui.lowLoadSince == 0) ui.lowLoadSince = now;
-    if (!ui.tamaSleeping && now - ui.lowLoadSince > 9000) ui.tamaSleeping = true; // 9s faible
+    if (!ui.lowLoad) { ui.lowLoad = true; ui.lowLoadSince = now; }
+    if (!ui.tamaSleeping && now - ui.lowLoadSince > Profile::lowLoadSleepMs) ui.tamaSleeping = true;
   } else {
-    ui.lowLoadSince = 0;
+    ui.lowLoad = false;
     // Ne pas réveiller si la connexion est perdue (on garde le dodo)
-    if ((millis() - lastDataMs) <= 4000) ui.tamaSleeping = false;
+    if (now - lastDataMs <= Profile::noDataSleepMs) ui.tamaSleeping = false;
     ui.sleepStep = 0;
   }
 
-  // 4) Rendu
-  display.clearDisplay();
-  drawHeader();
-  drawGauges();
-  drawInfoLines();
-  drawTicker();
-  display.display();
+  // 4) Rendu (les fenêtres glissantes avancent aussi sans données)
+  aggRoll(now);
+  if (now - lastDataMs > Profile::noDataSleepMs) alertReport(alerts.release(), NAN, now); // plus d'échantillons
+  alertFlash(now);
+#if SMON_INSTRUMENT
+  uint32_t t0 = nowUs();
+  if (tele.lastFrameUs != 0) tele.intervalUs.add(t0 - tele.lastFrameUs);
+  tele.lastFrameUs = t0;
+#endif
+  renderMain(now);
+  display.commit(now);
+#if SMON_INSTRUMENT
+  tele.renderUs.add(nowUs() - t0);
+  tele.frames++;
+#endif
+
+  drawHistPanel(now);
 }
 // -----------------------------------------------------------------------------
 // Setup & Loop
-// -----------------------------------------------------------------------------
\ No newline at end of file
+// -----------------------------------------------------------------------------
+
+#if defined(SMON_NATIVE)
+// -----------------------------------------------------------------------------
+// Sonde pour le harness de simulation native (program --sim)
+// -----------------------------------------------------------------------------
+#include <sim_probe.h>
+#include <stdarg.h>
+void simProbe(SimProbe &p) {
+  p.frames = display.frames();
+  p.blink = ui.tamaBlink;
+  p.sleeping = ui.tamaSleeping;
+  p.netMaxKBs = ui.netMaxKBs;
+  p.liveQueued = liveQueue.size();
+  p.lagMs[0] = display.takeMaxLag();
+  p.lagBudgetMs[0] = display.latencyMs();
+#ifdef SMON_PANEL2_ADDR
+  p.lagMs[1] = histPanel.takeMaxLag();
+  p.lagBudgetMs[1] = histPanel.latencyMs();
+#else
+  p.lagMs[1] = 0;
+  p.lagBudgetMs[1] = Profile::histFrameMs;
+#endif
+}
+
+// Banc JSON (program --sim-bench-json): une ligne (instantané ou delta) lue par le chemin rapide ou
+// par ArduinoJson depuis un état vierge, sans applySnapshot(); l'empreinte
+// (facultative) résume ce qui a été lu pour comparer les deux chemins
+bool simParseLine(const char *line, uint16_t len, bool generic, char *digest, size_t cap) {
+  data = DataState();
+  truncs = TruncCounters();
+  extraCount = 0;
+  appTitle.assign("SMON");
+  // Delta lu seul: séquence amorcée pour qu'il suive la ligne précédente
+  deltaSync = DeltaSync();
+  const uint32_t now = nowMs();
+  bool ok;
+  if (!generic) {
+    ok = scanSnapshot(line, len);
+    if (!ok && kDeltaIngest && scanDelta(line, len)) {
+      deltaSync.accept((uint16_t)(stage.seq - 1), true);
+      ok = commitDelta(now);
+    }
+  } else {
+    static StaticJsonDocument<JSON_DOC_BYTES> doc;
+    ok = !deserializeJson(doc, line, len) && !doc.containsKey("cmd");
+    if (ok && doc.containsKey("t")) {
+      ok = kDeltaIngest && !strcmp(doc["t"] | "", "d");
+      if (ok) {
+        deltaSync.accept((uint16_t)((doc["s"] | 0UL) - 1), true);
+        ok = readDeltaDoc(doc, now);
+      }
+    } else if (ok) {
+      readSnapshotDoc(doc);
+    }
+  }
+  if (!digest || !cap) return ok;
+  const DataState &d = data;
+  size_t n = 0;
+  auto put = [&](const char *fmt, ...) {
+    if (n >= cap) return;
+    va_list ap;
+    va_start(ap, fmt);
+    const int k = vsnprintf(digest + n, cap - n, fmt, ap);
+    va_end(ap);
+    if (k > 0) n += (size_t)k;
+  };
+  put("cpu %.9g/%.9g/%.9g t %.9g net %.9g/%.9g ram %ld/%ld/%ld up %ld df %ld ep %lu w '%s'",
+      d.cpu, d.cpuMax, d.cpuP95, d.tempC, d.net_rx, d.net_tx, (long)d.ram, (long)d.ram_used,
+      (long)d.ramMax, (long)d.uptime, (long)d.diskFreeMB, (unsigned long)d.epoch, d.weatherDesc.c_str());
+  for (const DiskEntry &e : d.disks) put(" D'%s' %lu/%lu", e.id.c_str(), (unsigned long)e.freeMB, (unsigned long)e.sizeMB);
+  for (const NicEntry &e : d.nics) put(" N'%s' %.9g/%.9g", e.id.c_str(), e.rx, e.tx);
+  for (const ProcEntry &e : d.procs) put(" P'%s' %.9g", e.id.c_str(), e.cpu);
+  for (uint8_t i = 0; i < extraCount; i++) put(" X'%s' %.9g", extras[i].name, extras[i].value);
+  put(" tr %lu/%lu/%lu/%lu app", (unsigned long)truncs.disks, (unsigned long)truncs.nics,
+      (unsigned long)truncs.procs, (unsigned long)truncs.ids);
+  for (uint16_t i = 0; i < appTitle.size(); i++) put(" %02x", appTitle.glyphs()[i]);
+  uint32_t epoch = 0;
+  put(" ds %d/%lu/%lu", (int)deltaSync.epoch(now, epoch), (unsigned long)epoch, (unsigned long)deltaSync.boot());
+  return ok;
+}
+#endif
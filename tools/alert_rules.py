@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+# Compiles alert rules written by hand into the device's compact rule table.
+#   python tools/alert_rules.py "cpu > 90 for 30s flash" "disk_free < 5GB"
+# prints the {"cmd":"rules"} line the bridge sends after each device hello.
+#
+# Grammar: <metric> <op> <value>[unit] [for <n>[s|m|h]] [banner] [flash]
+#   metric  cpu (%), ram (% used), ram_free, disk_free (MB on the device),
+#           net (KB/s rx+tx), temp (C)
+#   op      > or <
+#   unit    %, C, KB/s, MB/s (net); KB, MB, GB, TB (ram_free, disk_free)
+# Without an effect keyword the rule shows a banner. Each rule becomes
+# [metric, op, threshold, hold_ms, fx] with thresholds in the device's units.
+from __future__ import annotations
+import argparse
+import json
+import re
+import sys
+from typing import Iterable, List
+
+METRICS = ("cpu", "ram", "ram_free", "net", "temp", "disk_free")
+FX_BANNER = 0x01
+FX_FLASH = 0x02
+MAX_RULES = 8  # Profile::alertRules (4 in the minimal-flash build)
+
+_UNITS = {
+    "cpu": {"": 1, "%": 1},
+    "ram": {"": 1, "%": 1},
+    "temp": {"": 1, "c": 1},
+    "net": {"": 1, "kb/s": 1, "mb/s": 1024},
+    "ram_free": {"": 1, "kb": 1 / 1024, "mb": 1, "gb": 1024, "tb": 1024 * 1024},
+    "disk_free": {"": 1, "kb": 1 / 1024, "mb": 1, "gb": 1024, "tb": 1024 * 1024},
+}
+_HOLD = {"": 1000, "s": 1000, "m": 60000, "h": 3600000}
+_RULE = re.compile(
+    r"^\s*(?P<metric>[a-z_]+)\s*(?P<op>[<>])\s*(?P<value>-?\d+(?:\.\d+)?)\s*(?P<unit>%|(?!(?:for|banner|flash)\b)[a-z/]+)?"
+    r"(?:\s+for\s+(?P<hold>\d+(?:\.\d+)?)\s*(?P<hunit>[smh])?)?"
+    r"(?P<fx>(?:\s+(?:banner|flash))*)\s*$",
+    re.IGNORECASE)
+
+
+def parse_rule(text: str) -> list:
+    """One rule -> [metric, op, threshold, hold_ms, fx]; ValueError if malformed."""
+    m = _RULE.match(text)
+    if not m:
+        raise ValueError(f"cannot parse rule: {text!r}")
+    metric = m["metric"].lower()
+    if metric not in METRICS:
+        raise ValueError(f"unknown metric {metric!r} in {text!r} (expected one of {', '.join(METRICS)})")
+    unit = (m["unit"] or "").lower()
+    if unit not in _UNITS[metric]:
+        raise ValueError(f"unit {m['unit']!r} does not apply to {metric} in {text!r}")
+    value = float(m["value"]) * _UNITS[metric][unit]
+    hold_ms = int(round(float(m["hold"]) * _HOLD[(m["hunit"] or "").lower()])) if m["hold"] else 0
+    words = m["fx"].lower().split()
+    fx = (FX_BANNER if "banner" in words else 0) | (FX_FLASH if "flash" in words else 0)
+    return [metric, m["op"], round(value, 2), hold_ms, fx or FX_BANNER]
+
+
+def read_rules_file(path: str) -> List[str]:
+    """One rule per line; blank lines and # comments are skipped."""
+    with open(path, "r", encoding="utf-8") as f:
+        return [ln.split("#", 1)[0].strip() for ln in f if ln.split("#", 1)[0].strip()]
+
+
+def rules_command(texts: Iterable[str]) -> bytes:
+    """The {"cmd":"rules"} line for these rules (an empty list clears the device's table)."""
+    rules = [parse_rule(t) for t in texts]
+    if len(rules) > MAX_RULES:
+        raise ValueError(f"{len(rules)} rules, the device keeps at most {MAX_RULES}")
+    return (json.dumps({"cmd": "rules", "r": rules}, separators=(",", ":")) + "\n").encode("utf-8")
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description="Compile Smart Monitor alert rules")
+    parser.add_argument("rules", nargs="*", help='Rules such as "cpu > 90 for 30s"')
+    parser.add_argument("--file", help="Read rules from this file (one per line)")
+    args = parser.parse_args()
+    texts = list(args.rules) + (read_rules_file(args.file) if args.file else [])
+    try:
+        sys.stdout.write(rules_command(texts).decode("utf-8"))
+    except ValueError as e:
+        print(f"[alert_rules] {e}", file=sys.stderr)
+        return 2
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
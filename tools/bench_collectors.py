@@ -0,0 +1,61 @@
+#!/usr/bin/env python3
+# Micro-benchmark: µs per sample for each collector backend.
+#   python tools/bench_collectors.py [--samples 20000]
+from __future__ import annotations
+import argparse
+import platform
+import time
+
+try:
+    from collectors import PsutilCollector, ProcfsCollector
+except Exception:
+    from tools.collectors import PsutilCollector, ProcfsCollector  # type: ignore
+
+
+def bench(fn, samples: int) -> float:
+    fn()  # warm-up (first call may open files / build caches)
+    t0 = time.perf_counter()
+    for _ in range(samples):
+        fn()
+    return (time.perf_counter() - t0) / samples * 1e6
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description="Collector cost per sample")
+    parser.add_argument("--samples", type=int, default=20000)
+    args = parser.parse_args()
+
+    backends = [PsutilCollector()]
+    if platform.system() == "Linux":
+        backends.append(ProcfsCollector())
+
+    def hot(c):
+        # What the high-rate sampler calls on every sample
+        return lambda: (c.cpu_times(), c.memory_kb())
+
+    def full(c):
+        return lambda: (c.cpu_times(), c.memory_kb(), c.nic_bytes(), c.disk_free_kb("/"), c.disks())
+
+    rows = []
+    for c in backends:
+        rows.append((c.name, {
+            "cpu": bench(c.cpu_times, args.samples),
+            "mem": bench(c.memory_kb, args.samples),
+            "net": bench(c.net_bytes, args.samples),
+            "disk": bench(lambda: c.disk_free_kb("/"), args.samples),
+            "sample": bench(hot(c), args.samples),
+            "all": bench(full(c), args.samples),
+        }))
+
+    cols = ("cpu", "mem", "net", "disk", "sample", "all")
+    print(f"{'backend':<8}" + "".join(f"{k + ' µs':>12}" for k in cols))
+    for name, r in rows:
+        print(f"{name:<8}" + "".join(f"{r[k]:>12.1f}" for k in cols))
+    if len(rows) == 2:
+        base, fast = rows[0][1], rows[1][1]
+        print(f"{'speedup':<8}" + "".join(f"{base[k] / fast[k]:>11.1f}x" for k in cols))
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
@@ -0,0 +1,237 @@
+"""
+Metric collectors for the host bridge.
+
+Both backends expose the same small set of counters; callers turn them into
+rates/percentages themselves:
+- cpu_times() -> (busy, idle) cumulative, any unit (only ratios are used)
+- memory_kb() -> (total_kb, used_kb) with used = total - available
+- net_bytes() -> (rx_bytes, tx_bytes) cumulative over all non-loopback NICs
+- nic_bytes() -> {nic: (rx_bytes, tx_bytes)} per non-loopback NIC
+- disk_free_kb(path) -> free KB for unprivileged users
+- disks() -> [(mountpoint, free_kb, total_kb)] for real filesystems
+
+ProcfsCollector (Linux) keeps /proc/stat, /proc/meminfo and /proc/net/dev open
+and re-reads them with preadv() into preallocated buffers, parsing only the
+needed fields. PsutilCollector is the portable fallback.
+"""
+from __future__ import annotations
+
+import os
+import platform
+import time
+from typing import Dict, List, Tuple
+
+import psutil
+
+LOOPBACK_NICS = ("lo", "lo0")
+# Pseudo / image filesystems that are not worth a disk entry
+SKIP_FSTYPES = frozenset(("squashfs", "tmpfs", "devtmpfs", "overlay", "iso9660", "udf", "ramfs", "autofs"))
+MOUNTS_TTL_S = 60.0
+
+
+class _Mounts:
+    """Mount points of real filesystems, re-listed at most every MOUNTS_TTL_S."""
+
+    def __init__(self):
+        self.ts = -MOUNTS_TTL_S
+        self.paths: List[str] = []
+
+    def get(self) -> List[str]:
+        now = time.monotonic()
+        if now - self.ts >= MOUNTS_TTL_S:
+            self.ts = now
+            try:
+                parts = psutil.disk_partitions(all=False)
+            except Exception:
+                parts = []
+            seen = set()
+            self.paths = []
+            for p in parts:
+                if p.fstype in SKIP_FSTYPES or p.mountpoint.startswith("/snap/") or p.device in seen:
+                    continue
+                seen.add(p.device)  # bind mounts of the same device: first one only
+                self.paths.append(p.mountpoint)
+        return self.paths
+
+
+class PsutilCollector:
+    name = "psutil"
+
+    def __init__(self):
+        self._mounts = _Mounts()
+
+    def cpu_times(self) -> Tuple[float, float]:
+        t = psutil.cpu_times()
+        idle = t.idle + getattr(t, "iowait", 0.0)
+        # guest time is already included in user/nice on Linux
+        total = sum(t) - getattr(t, "guest", 0.0) - getattr(t, "guest_nice", 0.0)
+        return total - idle, idle
+
+    def memory_kb(self) -> Tuple[int, int]:
+        vm = psutil.virtual_memory()
+        return int(vm.total / 1024), int((vm.total - vm.available) / 1024)
+
+    def nic_bytes(self) -> Dict[str, Tuple[int, int]]:
+        return {nic: (n.bytes_recv, n.bytes_sent)
+                for nic, n in psutil.net_io_counters(pernic=True).items() if nic not in LOOPBACK_NICS}
+
+    def net_bytes(self) -> Tuple[int, int]:
+        rx = tx = 0
+        for r, t in self.nic_bytes().values():
+            rx += r
+            tx += t
+        return rx, tx
+
+    def disk_free_kb(self, path: str = "/") -> int:
+        try:
+            return int(psutil.disk_usage(path).free / 1024)
+        except Exception:
+            return -1
+
+    def disks(self) -> List[Tuple[str, int, int]]:
+        out = []
+        for path in self._mounts.get():
+            try:
+                du = psutil.disk_usage(path)
+            except Exception:
+                continue
+            if du.total > 0:
+                out.append((path, int(du.free / 1024), int(du.total / 1024)))
+        return out
+
+    def close(self) -> None:
+        pass
+
+
+class _ProcFile:
+    """An open procfs file re-read in place at offset 0.
+
+    With whole=False only the head of the file is read (the buffer size is the
+    budget); with whole=True the buffer grows until the file fits.
+    """
+
+    def __init__(self, path: str, size: int, whole: bool = False):
+        self.path = path
+        self.whole = whole
+        self.fd = os.open(path, os.O_RDONLY | getattr(os, "O_CLOEXEC", 0))
+        self.buf = bytearray(size)
+        self.view = memoryview(self.buf)
+
+    def read(self) -> int:
+        n = os.preadv(self.fd, [self.view], 0)
+        while self.whole and n == len(self.buf):
+            # Larger than expected (many NICs): grow once and keep the size
+            self.buf = bytearray(len(self.buf) * 2)
+            self.view = memoryview(self.buf)
+            n = os.preadv(self.fd, [self.view], 0)
+        return n
+
+    def close(self) -> None:
+        try:
+            self.view.release()
+            os.close(self.fd)
+        except OSError:
+            pass
+
+
+class ProcfsCollector:
+    name = "procfs"
+
+    def __init__(self):
+        # Only the aggregate "cpu" line of /proc/stat and the first lines of
+        # /proc/meminfo are needed: small buffers, the kernel stops there.
+        self._stat = _ProcFile("/proc/stat", 256)
+        self._mem = _ProcFile("/proc/meminfo", 192)
+        self._net = _ProcFile("/proc/net/dev", 4096, whole=True)
+        self._mounts = _Mounts()
+
+    def cpu_times(self) -> Tuple[float, float]:
+        f = self._stat
+        n = f.read()
+        # cpu  user nice system idle iowait irq softirq steal guest guest_nice
+        user, nice, system, idle, iowait, irq, softirq, steal = map(
+            int, f.buf[5:f.buf.find(b"\n", 0, n)].split(None, 8)[:8])
+        return user + nice + system + irq + softirq + steal, idle + iowait
+
+    def memory_kb(self) -> Tuple[int, int]:
+        f = self._mem
+        n = f.read()
+        buf = f.buf
+        # "MemTotal:       16318412 kB" ... "MemAvailable:    9876543 kB"
+
+        def field(key: bytes) -> int:
+            i = buf.find(key, 0, n)
+            if i < 0:
+                return -1
+            i += len(key)
+            return int(buf[i:buf.find(b"k", i, n)])
+
+        total = field(b"MemTotal:")
+        avail = field(b"MemAvailable:")
+        if avail < 0:
+            # No MemAvailable before Linux 3.14 (and in some containers): the old estimate
+            avail = sum(max(0, field(k)) for k in (b"MemFree:", b"Buffers:", b"Cached:"))
+        return total, total - avail
+
+    def nic_bytes(self) -> Dict[str, Tuple[int, int]]:
+        f = self._net
+        n = f.read()
+        buf = f.buf
+        out = {}
+        # Two header lines, then "  eth0: rx_bytes packets errs drop fifo frame compressed multicast tx_bytes ..."
+        pos = buf.find(b"\n", buf.find(b"\n", 0, n) + 1, n) + 1
+        while 0 < pos < n:
+            eol = buf.find(b"\n", pos, n)
+            if eol < 0:
+                eol = n
+            colon = buf.find(b":", pos, eol)
+            if colon > 0:
+                nic = buf[pos:colon].strip().decode()
+                if nic not in LOOPBACK_NICS:
+                    v = buf[colon + 1:eol].split()
+                    out[nic] = (int(v[0]), int(v[8]))
+            pos = eol + 1
+        return out
+
+    def net_bytes(self) -> Tuple[int, int]:
+        rx = tx = 0
+        for r, t in self.nic_bytes().values():
+            rx += r
+            tx += t
+        return rx, tx
+
+    def disk_free_kb(self, path: str = "/") -> int:
+        # statvfs is a single syscall with no parsing: nothing to gain over it
+        try:
+            st = os.statvfs(path)
+            return int(st.f_bavail * st.f_frsize / 1024)
+        except OSError:
+            return -1
+
+    def disks(self) -> List[Tuple[str, int, int]]:
+        out = []
+        for path in self._mounts.get():
+            try:
+                st = os.statvfs(path)
+            except OSError:
+                continue
+            if st.f_blocks:
+                out.append((path, int(st.f_bavail * st.f_frsize / 1024), int(st.f_blocks * st.f_frsize / 1024)))
+        return out
+
+    def close(self) -> None:
+        for f in (self._stat, self._mem, self._net):
+            f.close()
+
+
+def make_collector(kind: str = "auto"):
+    """'procfs', 'psutil' or 'auto' (procfs on Linux when readable)."""
+    if kind in ("auto", "procfs") and platform.system() == "Linux":
+        try:
+            return ProcfsCollector()
+        except (OSError, ValueError, IndexError):
+            if kind == "procfs":
+                raise
+    if kind == "procfs":
+        raise RuntimeError("procfs collector is only available on Linux")
+    return PsutilCollector()
@@ -0,0 +1,102 @@
+"""
+Delta snapshots for the device (host_bridge.py, firmware include/snap_delta.h).
+
+Instead of the full snapshot on every update, the bridge sends:
+
+  {"t":"d","s":<seq>,"k":1,"0":23.4,"3":16329872,...}   keyframe, every field
+  {"t":"d","s":<seq>,"0":24.1,"4":8234601}              delta, changed fields only
+
+- Keys are the index of the field in FIELDS (same order as the firmware's
+  DeltaKey). A field that disappeared is sent as null.
+- Arrays go as positional rows: disks [id, free, size], nics [id, rx, tx],
+  procs [id, cpu].
+- The host boot time and the clock only travel in keyframes: between two,
+  the device advances the time itself and derives the uptime from the boot
+  time.
+- s counts lines (16 bits). A keyframe goes first, every keyframe_s seconds,
+  and whenever the device asks ({"t":"dk"}) because a delta did not follow
+  the line it applied (lost line, device reset).
+
+An update with no change still sends {"t":"d","s":n}: the device takes one
+sample per line for its history and aggregates.
+"""
+from __future__ import annotations
+
+import json
+from typing import Any, Dict, Optional
+
+FIELDS = ("cpu", "cpu_max", "cpu_p95", "ram", "ram_used", "ram_max",
+          "time", "disk_free", "net.rx", "net.tx", "weather.temp", "weather.desc", "app",
+          "disks", "nics", "procs", "x", None, "boot")  # 17: was the host name, kept free
+KEY_ONLY = {"time", "boot"}  # sent with keyframes only
+
+
+def flatten(payload: dict, boot: Optional[float]) -> Dict[int, Any]:
+    """Snapshot payload (PayloadBuilder.build) -> {field index: value}, absent fields left out."""
+    net = payload.get("net") or {}
+    weather = payload.get("weather") or {}
+    flat = {
+        "net.rx": net.get("rx"), "net.tx": net.get("tx"),
+        "weather.temp": weather.get("temp"), "weather.desc": weather.get("desc"),
+        "boot": int(boot) if boot is not None else None,
+    }
+    if "disks" in payload:
+        flat["disks"] = [[d["id"], d["free"], d["size"]] for d in payload["disks"]]
+    if "nics" in payload:
+        flat["nics"] = [[n["id"], n["rx"], n["tx"]] for n in payload["nics"]]
+    if "procs" in payload:
+        flat["procs"] = [[p["id"], p["cpu"]] for p in payload["procs"]]
+    out = {}
+    for i, name in enumerate(FIELDS):
+        v = flat[name] if name in flat else payload.get(name)
+        if v is not None:
+            out[i] = v
+    return out
+
+
+class DeltaEncoder:
+    """Turns successive payloads into {"t":"d"} lines, keyframes on demand."""
+
+    def __init__(self, keyframe_s: float = 30.0):
+        self.keyframe_s = keyframe_s
+        self.enabled = False          # the device's hello offered "d"
+        self.seq = 0
+        self.sent: Optional[Dict[int, Any]] = None  # what the device holds, None = keyframe next
+        self.last_key = 0.0
+        self.counts = {"lines": 0, "keyframes": 0, "key_requests": 0, "bytes": 0}
+
+    def on_message(self, msg: dict) -> None:
+        kind = msg.get("t")
+        if kind == "hello":
+            self.enabled = msg.get("d") == 1
+            self.sent = None
+        elif kind == "dk":
+            self.counts["key_requests"] += 1
+            self.sent = None
+
+    def encode(self, payload: dict, now: float, boot: Optional[float] = None) -> bytes:
+        flat = flatten(payload, boot)
+        key = self.sent is None or now - self.last_key >= self.keyframe_s
+        self.seq = (self.seq + 1) & 0xFFFF
+        msg: Dict[str, Any] = {"t": "d", "s": self.seq}
+        if key:
+            msg["k"] = 1
+            msg.update((str(i), v) for i, v in flat.items())
+            self.last_key = now
+            self.counts["keyframes"] += 1
+        else:
+            for i, name in enumerate(FIELDS):
+                if name in KEY_ONLY:
+                    continue
+                if i in flat and flat[i] != self.sent.get(i):
+                    msg[str(i)] = flat[i]
+                elif i not in flat and i in self.sent:
+                    msg[str(i)] = None
+        self.sent = flat
+        line = (json.dumps(msg, separators=(",", ":")) + "\n").encode("utf-8")
+        self.counts["lines"] += 1
+        self.counts["bytes"] += len(line)
+        return line
+
+    def stats(self) -> Dict[str, int]:
+        return dict(self.counts)
@@ -0,0 +1,253 @@
+# Generates include/font_data.h: a proportional 7 px bitmap font for the
+# firmware's text engine (include/font.h), as constexpr tables.
+#
+# The source glyphs are the classic 5x7 Adafruit_GFX/HD44780 cells; blank side
+# columns are trimmed so each glyph keeps only its inked width, digits are
+# padded to a common width (values do not jitter while they change), and only
+# the requested character subset is emitted.
+#
+# It also emits the Unicode fold table the firmware applies once per incoming
+# string (GlyphString, include/font.h): Latin-1, Latin Extended-A and common
+# punctuation map to up to 3 glyphs of the subset, from the NFKD decomposition
+# with the accents dropped, or from FOLD_OVERRIDES (ligatures, quotes, symbols).
+#
+#   python tools/gen_font.py            # regenerate include/font_data.h
+#   python tools/gen_font.py --check    # exit 1 if the header is stale
+#
+# Also usable as a PlatformIO pre-build script (extra_scripts = pre:...): the
+# header is rewritten only when this generator is newer than it.
+import argparse
+import os
+import sys
+import unicodedata
+
+HERE = os.path.dirname(os.path.abspath(__file__)) if "__file__" in globals() else os.path.join(os.getcwd(), "tools")
+OUT = os.path.join(HERE, "..", "include", "font_data.h")
+
+HEIGHT = 7
+SPACING = 1          # blank column after every glyph
+SPACE_WIDTH = 2      # inked width of ' ' (plus SPACING)
+ELLIPSIS = 0x7F      # code point reused for the clipping ellipsis
+DEFAULT_CHARS = "".join(chr(c) for c in range(0x20, 0x7F)) + chr(ELLIPSIS)
+
+FOLD_RANGES = [(0x00A0, 0x017F), (0x2010, 0x203A), (0x20AC, 0x20AC), (0x2122, 0x2122)]
+FOLD_MAX = 3
+# Where NFKD gives nothing usable (or something misleading); "" = drop the character
+FOLD_OVERRIDES = {
+    "\u00a0": " ", "\u00ad": "", "\u00b0": "", "\u00b4": "'", "\u00a8": '"', "\u00b8": ",",
+    "\u00df": "ss", "\u00c6": "AE", "\u00e6": "ae", "\u0152": "OE", "\u0153": "oe",
+    "\u00d8": "O", "\u00f8": "o", "\u0110": "D", "\u0111": "d", "\u0141": "L", "\u0142": "l",
+    "\u0126": "H", "\u0127": "h", "\u0131": "i", "\u0138": "k", "\u00de": "Th", "\u00fe": "th",
+    "\u00d0": "D", "\u00f0": "d", "\u0149": "'n", "\u017f": "s", "\u013f": "L", "\u0140": "l",
+    "\u014a": "N", "\u014b": "n", "\u0166": "T", "\u0167": "t",
+    "\u00ab": "<<", "\u00bb": ">>", "\u2039": "<", "\u203a": ">", "\u2018": "'", "\u2019": "'",
+    "\u201a": ",", "\u201c": '"', "\u201d": '"', "\u201e": '"', "\u2010": "-", "\u2011": "-",
+    "\u2012": "-", "\u2013": "-", "\u2014": "-", "\u2015": "-", "\u2026": chr(ELLIPSIS),
+    "\u2022": "*", "\u00b7": ".", "\u00d7": "x", "\u00f7": "/", "\u20ac": "EUR", "\u00a3": "L",
+    "\u00a5": "Y", "\u00a2": "c", "\u00a9": "(c)", "\u00ae": "(R)", "\u2122": "TM", "\u00a1": "!",
+    "\u00bf": "?", "\u00a7": "S", "\u00b6": "P", "\u00b5": "u", "\u00a6": "|", "\u00ac": "-",
+    "\u00af": "-", "\u00aa": "a", "\u00ba": "o", "\u00b1": "+-", "\u00bc": "1/4", "\u00bd": "1/2",
+    "\u00be": "3/4",
+}
+
+# Column bytes, bit 0 = top row
+GLYPHS = {
+    " ": (0x00, 0x00, 0x00, 0x00, 0x00), "!": (0x00, 0x00, 0x5F, 0x00, 0x00),
+    '"': (0x00, 0x07, 0x00, 0x07, 0x00), "#": (0x14, 0x7F, 0x14, 0x7F, 0x14),
+    "$": (0x24, 0x2A, 0x7F, 0x2A, 0x12), "%": (0x23, 0x13, 0x08, 0x64, 0x62),
+    "&": (0x36, 0x49, 0x55, 0x22, 0x50), "'": (0x00, 0x05, 0x03, 0x00, 0x00),
+    "(": (0x00, 0x1C, 0x22, 0x41, 0x00), ")": (0x00, 0x41, 0x22, 0x1C, 0x00),
+    "*": (0x14, 0x08, 0x3E, 0x08, 0x14), "+": (0x08, 0x08, 0x3E, 0x08, 0x08),
+    ",": (0x00, 0x50, 0x30, 0x00, 0x00), "-": (0x08, 0x08, 0x08, 0x08, 0x08),
+    ".": (0x00, 0x60, 0x60, 0x00, 0x00), "/": (0x20, 0x10, 0x08, 0x04, 0x02),
+    "0": (0x3E, 0x51, 0x49, 0x45, 0x3E), "1": (0x00, 0x42, 0x7F, 0x40, 0x00),
+    "2": (0x42, 0x61, 0x51, 0x49, 0x46), "3": (0x21, 0x41, 0x45, 0x4B, 0x31),
+    "4": (0x18, 0x14, 0x12, 0x7F, 0x10), "5": (0x27, 0x45, 0x45, 0x45, 0x39),
+    "6": (0x3C, 0x4A, 0x49, 0x49, 0x30), "7": (0x01, 0x71, 0x09, 0x05, 0x03),
+    "8": (0x36, 0x49, 0x49, 0x49, 0x36), "9": (0x06, 0x49, 0x49, 0x29, 0x1E),
+    ":": (0x00, 0x36, 0x36, 0x00, 0x00), ";": (0x00, 0x56, 0x36, 0x00, 0x00),
+    "<": (0x08, 0x14, 0x22, 0x41, 0x00), "=": (0x14, 0x14, 0x14, 0x14, 0x14),
+    ">": (0x00, 0x41, 0x22, 0x14, 0x08), "?": (0x02, 0x01, 0x51, 0x09, 0x06),
+    "@": (0x32, 0x49, 0x79, 0x41, 0x3E), "A": (0x7E, 0x11, 0x11, 0x11, 0x7E),
+    "B": (0x7F, 0x49, 0x49, 0x49, 0x36), "C": (0x3E, 0x41, 0x41, 0x41, 0x22),
+    "D": (0x7F, 0x41, 0x41, 0x22, 0x1C), "E": (0x7F, 0x49, 0x49, 0x49, 0x41),
+    "F": (0x7F, 0x09, 0x09, 0x01, 0x01), "G": (0x3E, 0x41, 0x41, 0x51, 0x32),
+    "H": (0x7F, 0x08, 0x08, 0x08, 0x7F), "I": (0x00, 0x41, 0x7F, 0x41, 0x00),
+    "J": (0x20, 0x40, 0x41, 0x3F, 0x01), "K": (0x7F, 0x08, 0x14, 0x22, 0x41),
+    "L": (0x7F, 0x40, 0x40, 0x40, 0x40), "M": (0x7F, 0x02, 0x04, 0x02, 0x7F),
+    "N": (0x7F, 0x04, 0x08, 0x10, 0x7F), "O": (0x3E, 0x41, 0x41, 0x41, 0x3E),
+    "P": (0x7F, 0x09, 0x09, 0x09, 0x06), "Q": (0x3E, 0x41, 0x51, 0x21, 0x5E),
+    "R": (0x7F, 0x09, 0x19, 0x29, 0x46), "S": (0x46, 0x49, 0x49, 0x49, 0x31),
+    "T": (0x01, 0x01, 0x7F, 0x01, 0x01), "U": (0x3F, 0x40, 0x40, 0x40, 0x3F),
+    "V": (0x1F, 0x20, 0x40, 0x20, 0x1F), "W": (0x7F, 0x20, 0x18, 0x20, 0x7F),
+    "X": (0x63, 0x14, 0x08, 0x14, 0x63), "Y": (0x03, 0x04, 0x78, 0x04, 0x03),
+    "Z": (0x61, 0x51, 0x49, 0x45, 0x43), "[": (0x00, 0x7F, 0x41, 0x41, 0x00),
+    "\\": (0x02, 0x04, 0x08, 0x10, 0x20), "]": (0x00, 0x41, 0x41, 0x7F, 0x00),
+    "^": (0x04, 0x02, 0x01, 0x02, 0x04), "_": (0x40, 0x40, 0x40, 0x40, 0x40),
+    "`": (0x00, 0x01, 0x02, 0x04, 0x00), "a": (0x20, 0x54, 0x54, 0x54, 0x78),
+    "b": (0x7F, 0x48, 0x44, 0x44, 0x38), "c": (0x38, 0x44, 0x44, 0x44, 0x20),
+    "d": (0x38, 0x44, 0x44, 0x48, 0x7F), "e": (0x38, 0x54, 0x54, 0x54, 0x18),
+    "f": (0x08, 0x7E, 0x09, 0x01, 0x02), "g": (0x08, 0x14, 0x54, 0x54, 0x3C),
+    "h": (0x7F, 0x08, 0x04, 0x04, 0x78), "i": (0x00, 0x44, 0x7D, 0x40, 0x00),
+    "j": (0x20, 0x40, 0x44, 0x3D, 0x00), "k": (0x00, 0x7F, 0x10, 0x28, 0x44),
+    "l": (0x00, 0x41, 0x7F, 0x40, 0x00), "m": (0x7C, 0x04, 0x18, 0x04, 0x78),
+    "n": (0x7C, 0x08, 0x04, 0x04, 0x78), "o": (0x38, 0x44, 0x44, 0x44, 0x38),
+    "p": (0x7C, 0x14, 0x14, 0x14, 0x08), "q": (0x08, 0x14, 0x14, 0x18, 0x7C),
+    "r": (0x7C, 0x08, 0x04, 0x04, 0x08), "s": (0x48, 0x54, 0x54, 0x54, 0x20),
+    "t": (0x04, 0x3F, 0x44, 0x40, 0x20), "u": (0x3C, 0x40, 0x40, 0x20, 0x7C),
+    "v": (0x1C, 0x20, 0x40, 0x20, 0x1C), "w": (0x3C, 0x40, 0x30, 0x40, 0x3C),
+    "x": (0x44, 0x28, 0x10, 0x28, 0x44), "y": (0x0C, 0x50, 0x50, 0x50, 0x3C),
+    "z": (0x44, 0x64, 0x54, 0x4C, 0x44), "{": (0x00, 0x08, 0x36, 0x41, 0x00),
+    "|": (0x00, 0x00, 0x7F, 0x00, 0x00), "}": (0x00, 0x41, 0x36, 0x08, 0x00),
+    "~": (0x02, 0x01, 0x02, 0x04, 0x02), chr(ELLIPSIS): (0x40, 0x00, 0x40, 0x00, 0x40),
+}
+
+
+def trim(cols):
+    cols = list(cols)
+    while cols and cols[0] == 0:
+        cols.pop(0)
+    while cols and cols[-1] == 0:
+        cols.pop()
+    return cols
+
+
+def build(chars: str, tabular_digits: bool):
+    chars = sorted(set(chars) | {"?"})  # '?' stands in for anything missing
+    missing = [c for c in chars if c not in GLYPHS]
+    if missing:
+        raise SystemExit(f"gen_font: no source glyph for {missing!r}")
+    glyphs = {}
+    for c in chars:
+        cols = trim(GLYPHS[c])
+        if c == " ":
+            cols = [0] * SPACE_WIDTH
+        glyphs[c] = cols
+    if tabular_digits:
+        w = max(len(glyphs[d]) for d in "0123456789" if d in glyphs)
+        for d in "0123456789":
+            if d in glyphs:
+                cols = glyphs[d]
+                left = (w - len(cols)) // 2
+                glyphs[d] = [0] * left + cols + [0] * (w - len(cols) - left)
+    return chars, glyphs
+
+
+def fold_table(chars):
+    """[(code point, replacement)] for every folded character whose replacement the subset can draw."""
+    have = set(chars)
+    table = []
+    for lo, hi in FOLD_RANGES:
+        for cp in range(lo, hi + 1):
+            c = chr(cp)
+            if c in have:
+                continue
+            if c in FOLD_OVERRIDES:
+                to = FOLD_OVERRIDES[c]
+            else:
+                to = "".join(d for d in unicodedata.normalize("NFKD", c) if not unicodedata.combining(d))
+                if not to or to == c:
+                    continue
+            if len(to) <= FOLD_MAX and all(t in have for t in to):
+                table.append((cp, to))
+    return table
+
+
+def render(chars, glyphs) -> str:
+    first, last = 0x20, 0x7F
+    index = {c: i for i, c in enumerate(chars)}
+    fold = fold_table(chars)
+    offsets, data = [], []
+    for c in chars:
+        offsets.append(len(data))
+        data.extend(glyphs[c])
+    offsets.append(len(data))
+
+    def rows(values, fmt, per_line):
+        items = [fmt(v) for v in values]
+        return "\n".join("    " + ", ".join(items[i:i + per_line]) + "," for i in range(0, len(items), per_line))
+
+    idx = [index.get(chr(c), 0xFF) for c in range(first, last + 1)]
+    lines = [
+        "// -----------------------------------------------------------------------------",
+        "// Police proportionnelle 7 px, GÉNÉRÉE par tools/gen_font.py: ne pas éditer.",
+        f"// {len(chars)} glyphes, {len(data)} colonnes; octet = colonne, bit 0 en haut.",
+        "// -----------------------------------------------------------------------------",
+        "#pragma once",
+        "#include <stdint.h>",
+        "",
+        f"static constexpr uint8_t kFontHeight = {HEIGHT};",
+        f"static constexpr uint8_t kFontSpacing = {SPACING};   // colonne vide après chaque glyphe",
+        f"static constexpr uint8_t kFontFirst = 0x{first:02X}, kFontLast = 0x{last:02X};",
+        f"static constexpr char kFontEllipsis = 0x{ELLIPSIS:02X};  // '...' sur un seul glyphe",
+        f"static constexpr uint8_t kFontMissing = 0x{index['?']:02X};   // glyphe de '?'",
+        f"static constexpr uint8_t kFontGlyphs = {len(chars)};",
+        "",
+        "// Code - kFontFirst -> numéro de glyphe (0xFF: absent du sous-ensemble)",
+        "static constexpr uint8_t kFontIndex[kFontLast - kFontFirst + 1] = {",
+        rows(idx, lambda v: f"0x{v:02X}", 16),
+        "};",
+        "",
+        "// Début de chaque glyphe dans kFontCols; largeur = kFontOffset[g + 1] - kFontOffset[g]",
+        "static constexpr uint16_t kFontOffset[kFontGlyphs + 1] = {",
+        rows(offsets, str, 16),
+        "};",
+        "",
+        "static constexpr uint8_t kFontCols[] = {",
+        rows(data, lambda v: f"0x{v:02X}", 16),
+        "};",
+        "",
+        "// Repli des caractères hors police: kFoldCp trié, kFoldTo = jusqu'à 3 glyphes",
+        "// (0xFF en bourrage; aucun: caractère ignoré). Absent de la table: '?'",
+        f"static constexpr uint16_t kFoldCount = {len(fold)};",
+        "static constexpr uint16_t kFoldCp[kFoldCount] = {",
+        rows([cp for cp, _ in fold], lambda v: f"0x{v:04X}", 12),
+        "};",
+        f"static constexpr uint8_t kFoldTo[kFoldCount][{FOLD_MAX}] = {{",
+        rows([[index[t] for t in to] + [0xFF] * (FOLD_MAX - len(to)) for _, to in fold],
+             lambda v: "{" + ", ".join(f"0x{x:02X}" for x in v) + "}", 6),
+        "};",
+        "",
+    ]
+    return "\n".join(lines)
+
+
+def generate(chars=DEFAULT_CHARS, tabular_digits=True) -> str:
+    return render(*build(chars, tabular_digits))
+
+
+def main() -> int:
+    ap = argparse.ArgumentParser(description="Generate the firmware's proportional font header")
+    ap.add_argument("--out", default=OUT, help="output header (default include/font_data.h)")
+    ap.add_argument("--chars", default=DEFAULT_CHARS, help="character subset to emit")
+    ap.add_argument("--proportional-digits", action="store_true", help="do not pad digits to a common width")
+    ap.add_argument("--check", action="store_true", help="exit 1 if the header differs from what would be generated")
+    args = ap.parse_args()
+    text = generate(args.chars, not args.proportional_digits)
+    try:
+        with open(args.out, encoding="utf-8") as f:
+            current = f.read()
+    except OSError:
+        current = None
+    if args.check:
+        if current != text:
+            print(f"gen_font: {args.out} is stale, run python tools/gen_font.py")
+            return 1
+        return 0
+    if current != text:
+        with open(args.out, "w", encoding="utf-8", newline="\n") as f:
+            f.write(text)
+        print(f"gen_font: wrote {os.path.normpath(args.out)}")
+    return 0
+
+
+try:
+    Import("env")  # noqa: F821  (PlatformIO pre-build script)
+except NameError:
+    if __name__ == "__main__":
+        sys.exit(main())
+else:
+    if not os.path.exists(OUT) or os.path.getmtime(OUT) < os.path.getmtime(os.path.join(HERE, "gen_font.py")):
+        with open(OUT, "w", encoding="utf-8", newline="\n") as f:
+            f.write(generate())
+        print("gen_font: regenerated include/font_data.h")
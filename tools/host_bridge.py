@@ -6,9 +6,11 @@ Host bridge script for Smart Monitor
 
 Data schema (one line per update):
 {
-  "cpu": float (0-100),
+  "cpu": float (0-100, mean over the update interval),
+  "cpu_max": float, "cpu_p95": float (over the interval's internal samples),
   "ram": int total_kb,
   "ram_used": int used_kb,
+  "ram_max": int used_kb (interval max),
   "weather": { "temp": float, "desc": str }
 }
 
@@ -21,6 +23,8 @@ Usage:
 
 Notes:
 - Weather provider: Open-Meteo (no API key). If network fails, weather fields are omitted.
+- Firmwares that offer it in their hello get delta lines instead ({"t":"d"}: changed
+  fields only, short keys, periodic keyframes; see tools/delta.py).
 - On macOS, the ESP32-C3 often appears as /dev/tty.usbmodem* or /dev/tty.usbserial*.
 """
 from __future__ import annotations
@@ -29,9 +33,7 @@ import json
 import sys
 import time
 from dataclasses import dataclass
-import subprocess
 import platform
-import socket
 from typing import Optional
 import threading
 
@@ -57,6 +59,53 @@ except Exception:
     except Exception:
         autodetect_port = lambda preferred=None: None  # noqa: E731
 
+try:
+    from serial_utils import LineReader
+    from journal import Journal, backlog_lines, default_journal_path
+except Exception:
+    from tools.serial_utils import LineReader  # type: ignore
+    from tools.journal import Journal, backlog_lines, default_journal_path  # type: ignore
+
+try:
+    from ingest import make_ingest
+except Exception:
+    from tools.ingest import make_ingest  # type: ignore
+
+try:
+    from alert_rules import read_rules_file, rules_command
+except Exception:
+    from tools.alert_rules import read_rules_file, rules_command  # type: ignore
+
+try:
+    from providers import make_providers
+except Exception:
+    from tools.providers import make_providers  # type: ignore
+
+try:
+    from host_render import FrameStreamer, HostRenderer
+except Exception:
+    from tools.host_render import FrameStreamer, HostRenderer  # type: ignore
+
+try:
+    from delta import DeltaEncoder
+except Exception:
+    from tools.delta import DeltaEncoder  # type: ignore
+
+try:
+    from collectors import make_collector
+except Exception:
+    from tools.collectors import make_collector  # type: ignore
+
+try:
+    from self_profile import NullProfiler, make_profiler
+except Exception:
+    from tools.self_profile import NullProfiler, make_profiler  # type: ignore
+
+try:
+    from soak import run_soak, ALL_FIELDS as SOAK_FIELDS
+except Exception:
+    from tools.soak import run_soak, ALL_FIELDS as SOAK_FIELDS  # type: ignore
+
 OPEN_METEO_URL = "https://api.open-meteo.com/v1/forecast"
 
 @dataclass
@@ -107,14 +156,159 @@ WEATHER_CODE_MAP = {
 }
 
 
-def get_system_stats() -> tuple[float, int, int]:
-    # CPU percent averaged over 0.5s
-    cpu = psutil.cpu_percent(interval=0.5)
+@dataclass
+class IntervalStats:
+    cpu: float          # mean over the interval
+    cpu_max: float
+    cpu_p95: float
+    total_kb: int
+    used_kb: int        # latest sample
+    used_max_kb: int    # interval max
+
+
+class CpuSampler(threading.Thread):
+    """Samples CPU and RAM continuously so spikes between sends are not lost.
+
+    CPU comes from cpu_times() counter deltas (no blocking interval), so each
+    sample covers exactly the time since the previous one and the interval
+    mean is an honest full-interval average.
+    """
+
+    def __init__(self, hz: float = 10.0, collector=None):
+        super().__init__(daemon=True)
+        self.collector = collector or make_collector()
+        self.profiler = NullProfiler()
+        self.period = 1.0 / max(0.5, hz)
+        self.lock = threading.Lock()
+        self.cpu: list[float] = []
+        self.weights: list[float] = []
+        self.ram_max_kb = 0
+        self.total_kb = 0
+        self.used_kb = 0
+        self.last_cpu: Optional[float] = None
+        self.stop_flag = False
+        # Raw (monotonic ts, cpu %, ram %) samples for batch frames; only kept once
+        # take_batch() has been called, so the list cannot grow when unused
+        self.batch: Optional[list] = None
+        self._prev = self.collector.cpu_times()
+        self._prev_ts = time.monotonic()
+        self._sample_ram()
+
+    def _sample_ram(self) -> None:
+        self.total_kb, self.used_kb = self.collector.memory_kb()
+        self.ram_max_kb = max(self.ram_max_kb, self.used_kb)
+
+    def sample(self) -> None:
+        busy, idle = self.collector.cpu_times()
+        now = time.monotonic()
+        b0, i0 = self._prev
+        total = (busy - b0) + (idle - i0)
+        with self.lock:
+            self._sample_ram()
+            if total > 0:
+                cpu = max(0.0, min(100.0, 100.0 * (busy - b0) / total))
+                self.last_cpu = cpu
+                self.cpu.append(cpu)
+                self.weights.append(now - self._prev_ts)
+                if self.batch is not None:
+                    ram = 100.0 * self.used_kb / self.total_kb if self.total_kb else None
+                    self.batch.append((now, cpu, ram))
+        self._prev, self._prev_ts = (busy, idle), now
+
+    def run(self) -> None:
+        next_ts = time.monotonic()
+        while not self.stop_flag:
+            with self.profiler.section("sampler:sample"):
+                self.sample()
+            next_ts += self.period
+            delay = next_ts - time.monotonic()
+            if delay > 0:
+                time.sleep(delay)
+            else:
+                next_ts = time.monotonic()  # fell behind (suspend, load): resync
+
+    def latest(self) -> tuple:
+        """(cpu %, ram %) of the newest sample, None until known."""
+        with self.lock:
+            ram = 100.0 * self.used_kb / self.total_kb if self.total_kb else None
+            return self.last_cpu, ram
+
+    def take_batch(self) -> list:
+        """Raw samples since the previous call, oldest first."""
+        with self.lock:
+            batch, self.batch = self.batch, []
+        return batch or []
+
+    def drain(self) -> IntervalStats:
+        """Summarize samples since the previous drain and start a new interval."""
+        if not self.is_alive():
+            self.sample()
+        with self.lock:
+            cpu, weights = self.cpu, self.weights
+            self.cpu, self.weights = [], []
+            used_max = self.ram_max_kb
+            self.ram_max_kb = self.used_kb
+            total_kb, used_kb = self.total_kb, self.used_kb
+        if not cpu:
+            return IntervalStats(0.0, 0.0, 0.0, total_kb, used_kb, used_max)
+        span = sum(weights)
+        mean = sum(c * w for c, w in zip(cpu, weights)) / span if span > 0 else sum(cpu) / len(cpu)
+        ranked = sorted(cpu)
+        p95 = ranked[min(len(ranked) - 1, int(0.95 * len(ranked)))]
+        return IntervalStats(mean, ranked[-1], p95, total_kb, used_kb, used_max)
+
+
+def encode_batch(samples: list, t0_ms: int, dt_ms: int) -> bytes:
+    """One {"t":"b"} frame: start time (host ms, 32-bit), fixed delta and one
+    hex byte (0-100, "ff" = none) per sample and metric."""
+    def hx(vals) -> str:
+        return "".join("ff" if v is None else "%02x" % int(round(v)) for v in vals)
+
+    return ('{"t":"b","t0":%d,"dt":%d,"cpu":"%s","ram":"%s"}\n' % (
+        t0_ms & 0xFFFFFFFF, dt_ms, hx(s[1] for s in samples), hx(s[2] for s in samples))).encode("ascii")
+
+
+class BatchFramer:
+    """Cuts the sampler's raw stream into {"t":"b"} frames.
+
+    Consecutive frames are kept contiguous for the device: a frame's t0 is the
+    previous t0 plus its sample count times dt, whatever the jitter of the
+    sampling thread, so the firmware chains them without gaps.
+    """
+
+    def __init__(self, sampler: CpuSampler):
+        self.sampler = sampler
+        self.dt_ms = max(1, int(round(sampler.period * 1000)))
+        self.next_ms: Optional[int] = None
+        sampler.take_batch()  # start collecting
+
+    def frame(self) -> Optional[bytes]:
+        samples = self.sampler.take_batch()
+        if not samples:
+            return None
+        t0 = int(samples[0][0] * 1000)
+        # Keep the chain unless the sampler stalled (suspend, overload)
+        if self.next_ms is None or abs(t0 - self.next_ms) > 2 * self.dt_ms:
+            self.next_ms = t0
+        t0, self.next_ms = self.next_ms, self.next_ms + len(samples) * self.dt_ms
+        return encode_batch(samples, t0, self.dt_ms)
+
+
+_default_sampler: Optional[CpuSampler] = None
+
+
+def get_sampler(hz: float = 10.0, collector: str = "auto") -> CpuSampler:
+    global _default_sampler
+    if _default_sampler is None:
+        _default_sampler = CpuSampler(hz, make_collector(collector))
+        _default_sampler.start()
+    return _default_sampler
+
 
-    vm = psutil.virtual_memory()
-    total_kb = int(vm.total / 1024)
-    used_kb = int((vm.total - vm.available) / 1024)
-    return cpu, total_kb, used_kb
+def get_system_stats() -> tuple[float, int, int]:
+    # CPU averaged over the whole interval since the previous call
+    st = get_sampler().drain()
+    return st.cpu, st.total_kb, st.used_kb
 
 
 def get_disk_free_kb() -> int:
@@ -125,22 +319,193 @@ def get_disk_free_kb() -> int:
         return -1
 
 
-def get_active_app_name_macos() -> Optional[str]:
-    if platform.system() != "Darwin":
+# Per-mount / per-NIC arrays: the firmware keeps this many entries of each,
+# keyed by ids of at most ID_LEN characters
+LIST_MAX = 4
+ID_LEN = 8
+PROC_NAME_LEN = 15  # process names on the device's "procs" page
+
+
+def short_mount_id(mount: str) -> str:
+    """'/' -> '/', '/mnt/data' -> 'data', 'C:\\' -> 'C:'."""
+    m = mount.rstrip("/\\")
+    if not m:
+        return "/"
+    if len(m) == 2 and m[1] == ":":
+        return m
+    return m.replace("\\", "/").rsplit("/", 1)[-1][:ID_LEN]
+
+
+class PayloadBuilder:
+    """Builds one update payload and keeps the state needed between updates
+    (network counters for rates, cached weather). Shared by headless and tray modes."""
+
+    def __init__(self, lat: Optional[float], lon: Optional[float], sampler: Optional[CpuSampler] = None,
+                 profiler=None, app_source: str = "auto", app_interval: float = 2.0, procs: bool = False):
+        self.lat = lat
+        self.lon = lon
+        self.sampler = sampler or get_sampler()
+        self.prof = profiler or NullProfiler()
+        self.sampler.profiler = self.prof
+        # Active app / busiest process: own threads, build() only reads their cache
+        self.providers = make_providers(app_source, app_interval, self.prof, procs)
+        self.procs = procs
+        self.prof.add_reporter("provider", self.providers.cost)
+        self.collector = self.sampler.collector
+        self.last_weather: Optional[Weather] = None
+        self.last_weather_ts = 0.0
+        self.last_nics = self.collector.nic_bytes()
+        self.last_net_ts = time.time()
+        try:
+            self.boot_time: Optional[float] = psutil.boot_time()
+        except Exception:
+            self.boot_time = None
+
+    def build(self) -> dict:
+        prof = self.prof
+        with prof.section("collect:cpu_ram"):
+            st = self.sampler.drain()
+        payload = {
+            "cpu": round(st.cpu, 1),
+            "cpu_max": round(st.cpu_max, 1),
+            "cpu_p95": round(st.cpu_p95, 1),
+            "ram": st.total_kb,
+            "ram_used": st.used_kb,
+            "ram_max": st.used_max_kb,
+        }
+
+        # Time/uptime (no host name: the device has nothing to show it on)
+        payload["time"] = int(time.time())
+        if self.boot_time is not None:
+            payload["uptime"] = int(time.time() - self.boot_time)
+        with prof.section("collect:disk"):
+            disk_free_kb = self.collector.disk_free_kb("/")
+        if disk_free_kb >= 0:
+            payload["disk_free"] = disk_free_kb
+        with prof.section("collect:disks"):
+            disks = self.collector.disks()
+        if disks:
+            disks.sort(key=lambda d: (d[0] not in ("/", "C:\\"), -d[2]))  # system disk, then largest
+            payload["disks"] = [{"id": short_mount_id(m), "free": free // 1024, "size": total // 1024}
+                                for m, free, total in disks[:LIST_MAX]]
+
+        # Network RX/TX rate (KB/s), total and per NIC
+        try:
+            now = time.time()
+            with prof.section("collect:net"):
+                nics = self.collector.nic_bytes()
+            dt = max(0.1, now - self.last_net_ts)
+            rates = []
+            for nic, (rx, tx) in nics.items():
+                prev = self.last_nics.get(nic)
+                if prev is None or not (rx or tx):
+                    continue  # new or never used
+                # max(0): counters reset when an interface goes down and up
+                rates.append((nic, max(0, rx - prev[0]) / 1024.0 / dt, max(0, tx - prev[1]) / 1024.0 / dt))
+            payload["net"] = {"rx": round(sum(r[1] for r in rates), 1), "tx": round(sum(r[2] for r in rates), 1)}
+            rates.sort(key=lambda r: -(r[1] + r[2]))
+            payload["nics"] = [{"id": nic[:ID_LEN], "rx": round(rx, 1), "tx": round(tx, 1)}
+                               for nic, rx, tx in rates[:LIST_MAX]]
+            self.last_nics, self.last_net_ts = nics, now
+        except Exception:
+            pass
+
+        # Active app (macOS) or busiest process, as last published by its provider
+        app = self.providers.get("app")
+        if app:
+            payload["app"] = app
+        # Busiest processes, only when the device may show its "procs" page
+        if self.procs:
+            top = self.providers.top_processes()
+            if top:
+                payload["procs"] = [{"id": name[:PROC_NAME_LEN], "cpu": cpu} for name, cpu in top]
+
+        # Refresh weather every 5 minutes
+        now = time.time()
+        if self.lat is not None and self.lon is not None and (now - self.last_weather_ts > 300 or self.last_weather is None):
+            with prof.section("collect:weather"):
+                self.last_weather = get_weather(self.lat, self.lon)
+            self.last_weather_ts = now
+
+        if self.last_weather is not None:
+            w = {}
+            if self.last_weather.temp is not None:
+                w["temp"] = round(float(self.last_weather.temp), 1)
+            if self.last_weather.desc:
+                w["desc"] = self.last_weather.desc
+            if self.last_weather.code is not None:
+                try:
+                    w["wcode"] = int(self.last_weather.code)
+                except Exception:
+                    pass
+            if w:
+                payload["weather"] = w
+        return payload
+
+    def close(self) -> None:
+        self.providers.stop()
+
+
+def open_journal(args) -> Optional[Journal]:
+    if args.no_journal:
         return None
     try:
-        # AppleScript pour récupérer l’app au premier plan
-        script = 'tell application "System Events" to get name of application processes whose frontmost is true'
-        r = subprocess.run(["osascript", "-e", script], capture_output=True, text=True, timeout=1.5)
-        if r.returncode == 0:
-            out = r.stdout.strip()
-            # Peut retourner une liste séparée par ", "; prendre le premier nom non vide
-            if out:
-                first = out.split(", ")[0].strip()
-                return first if first else None
-    except Exception:
-        pass
-    return None
+        return Journal(args.journal or default_journal_path(), args.journal_mb)
+    except Exception as e:
+        print(f"[host_bridge] Journal disabled: {e}")
+        return None
+
+
+def handle_device_messages(ser, reader: LineReader, journal: Optional[Journal], verbose: bool = False,
+                           setup: Optional[bytes] = None, streamer: Optional[FrameStreamer] = None,
+                           delta: Optional[DeltaEncoder] = None) -> None:
+    """Answer the device's messages; a {"t":"hello"} gets the setup commands (alert rules,
+    net scale) and the journal backlog. The frame streamer sees every message (hello, acks, alerts),
+    the delta encoder its hello and keyframe requests."""
+    for msg in reader.poll(ser):
+        kind = msg.get("t")
+        if streamer is not None:
+            streamer.on_message(msg)
+        if delta is not None:
+            delta.on_message(msg)
+            if kind == "dk" and verbose:
+                print(f"[host_bridge] Device lost the delta chain after s={msg.get('s')}: keyframe next")
+        if kind == "alert":
+            state = "fired" if msg.get("on") else "cleared"
+            print(f"[host_bridge] Alert {msg.get('r')} ({msg.get('m')}) {state}"
+                  + (f": value {msg.get('v')}, held {msg.get('held')} ms, detected {msg.get('lat')} ms late" if msg.get("on") else ""))
+            continue
+        if kind == "rules":
+            if msg.get("bad") or verbose:
+                print(f"[host_bridge] Device accepted {msg.get('n')} alert rule(s), rejected {msg.get('bad')}")
+            continue
+        if kind != "hello":
+            continue
+        if setup:
+            ser.write(setup)
+        if journal is None:
+            ser.flush()
+            continue
+        slot_ms, slots = int(msg.get("slot", 0)), int(msg.get("hist", 0))
+        if slot_ms <= 0 or slots <= 0:
+            continue
+        lines = backlog_lines(journal, slot_ms, slots)
+        if verbose:
+            print(f"[host_bridge] Device hello (fw {msg.get('fw')}): sending {len(lines)} backlog line(s)")
+        for line in lines:
+            ser.write(line)
+        ser.flush()
+
+
+def positive_float(text: str) -> float:
+    """argparse type: a float > 0."""
+    try:
+        v = float(text)
+    except ValueError:
+        raise argparse.ArgumentTypeError(f"not a number: {text!r}") from None
+    if not v > 0:
+        raise argparse.ArgumentTypeError(f"must be > 0: {text!r}")
+    return v
 
 
 def main() -> int:
@@ -150,10 +515,79 @@ def main() -> int:
     parser.add_argument("--lat", type=float, required=False, help="Latitude for weather")
     parser.add_argument("--lon", type=float, required=False, help="Longitude for weather")
     parser.add_argument("--interval", type=float, default=2.0, help="Update interval seconds")
+    parser.add_argument("--collector", choices=("auto", "procfs", "psutil"), default="auto",
+                        help="Metric backend: procfs (Linux, persistent fds) or psutil; auto picks procfs on Linux")
+    parser.add_argument("--sample-hz", type=float, default=10.0, help="Internal CPU/RAM sampling rate; each update carries the interval mean/max/p95")
+    parser.add_argument("--batch-ms", type=float, default=0.0,
+                        help="Also stream every internal CPU/RAM sample as batch frames sent every N ms (0 = off)")
     parser.add_argument("--verbose", action="store_true", help="Print debug info and each payload sent")
     parser.add_argument("--tray", action="store_true", help="Run as a macOS tray app (status bar). Requires rumps.")
+    parser.add_argument("--journal", metavar="FILE", help="Snapshot journal (ring file), default: ~/.cache/smart_monitor/journal.bin")
+    parser.add_argument("--journal-mb", type=float, default=16.0, help="Journal size in MB (fixed; oldest snapshots are overwritten)")
+    parser.add_argument("--no-journal", action="store_true", help="Do not journal snapshots nor replay a backlog after reconnect")
+    ingest = parser.add_argument_group("metrics ingest", "Accept statsd-like lines (name:value|g|c|ms) from other sources")
+    ingest.add_argument("--ingest-uds", metavar="PATH", help="Listen on this Unix socket (stream; senders are paced, never dropped)")
+    ingest.add_argument("--ingest-udp", metavar="[HOST:]PORT", help="Listen on this UDP address (default host 127.0.0.1)")
+    ingest.add_argument("--ingest-rate", type=positive_float, default=200.0, help="Lines per second allowed per source")
+    ingest.add_argument("--ingest-max-keys", type=int, default=8, help="Distinct metric names forwarded to the device")
+    parser.add_argument("--app-source", choices=("auto", "frontmost", "top", "none"), default="auto",
+                        help="What the `app` field shows: frontmost app (macOS), busiest process, or nothing; "
+                             "auto = frontmost on macOS, busiest process elsewhere")
+    parser.add_argument("--app-interval", type=float, default=2.0, help="Seconds between app provider polls")
+    parser.add_argument("--net-scale", choices=("linear", "log"), default="linear",
+                        help="Scale of the device's RX/TX page; log suits bursty links")
+    parser.add_argument("--host-render", action="store_true",
+                        help="Render the whole UI here and stream changed screen pages; the device only blits them "
+                             "(SH1106 builds; it renders locally again when frames stop)")
+    parser.add_argument("--host-render-fps", type=float, default=20.0,
+                        help="Frame rate cap of --host-render (also paced by the device's acks)")
+    parser.add_argument("--host-render-keyframe", type=float, default=10.0,
+                        help="Seconds between full frames of --host-render")
+    parser.add_argument("--delta-keyframe", type=float, default=30.0, metavar="SECONDS",
+                        help="Send changed fields only, with short keys, and a full keyframe every SECONDS "
+                             "(firmwares whose hello offers \"d\"); 0 = full snapshot on every update")
+    parser.add_argument("--page", choices=("overview", "history", "procs", "net"),
+                        help="Page the device shows (SH1106 builds; pages slide in with a hardware scroll)")
+    parser.add_argument("--page-cycle", type=float, default=0.0, metavar="SECONDS",
+                        help="Rotate the device's pages every SECONDS, skipping those without data (0 = off)")
+    parser.add_argument("--rule", action="append", default=[], metavar="RULE",
+                        help='Alert rule evaluated on the device, e.g. "cpu > 90 for 30s flash" (repeatable)')
+    parser.add_argument("--rules-file", metavar="FILE", help="Alert rules, one per line (see tools/alert_rules.py)")
+    parser.add_argument("--self-profile", action="store_true", help="Track the bridge's own CPU, RSS, wakeups, syscalls and time per collector/sink")
+    parser.add_argument("--self-profile-interval", type=float, default=60.0, help="Seconds between self-profile summaries")
+    parser.add_argument("--self-profile-budget", type=float, default=0.2, help="Warn when bridge CPU exceeds this %% of one core")
+    parser.add_argument("--self-profile-log", metavar="FILE", help="Append each self-profile summary as a JSON line")
+    soak = parser.add_argument_group("soak test", "Drive the firmware with synthetic load instead of real metrics")
+    soak.add_argument("--soak", action="store_true", help="Send synthetic payloads and report ingest/frame/memory telemetry")
+    soak.add_argument("--soak-native", metavar="BINARY", help="Spawn the native build (e.g. .pio/build/native/program) and use its pty")
+    soak.add_argument("--soak-rate", type=float, default=20.0, help="Lines per second (0 = as fast as the link accepts)")
+    soak.add_argument("--soak-size", type=int, default=0, help="Pad each line to this many bytes (0 = natural size)")
+    soak.add_argument("--soak-fields", default=",".join(SOAK_FIELDS), help="Comma-separated field mix (default: all)")
+    soak.add_argument("--soak-burst", metavar="N@SECONDS", help="Send N extra lines back-to-back every SECONDS")
+    soak.add_argument("--soak-duration", type=float, default=0.0, help="Stop after this many seconds (0 = until Ctrl-C)")
+    soak.add_argument("--soak-report", type=float, default=10.0, help="Seconds between progress reports")
+    soak.add_argument("--soak-csv", metavar="FILE", help="Also write one CSV row per report")
+    soak.add_argument("--soak-seed", type=int, help="Seed for the payload generator (reproducible runs)")
     args = parser.parse_args()
 
+    if args.soak:
+        return run_soak(args)
+
+    setup = b""  # sent after every device hello
+    if args.rule or args.rules_file:
+        try:
+            setup += rules_command(args.rule + (read_rules_file(args.rules_file) if args.rules_file else []))
+        except (OSError, ValueError) as e:
+            print(f"[host_bridge] Alert rules: {e}")
+            return 2
+    if args.net_scale == "log":
+        setup += b'{"cmd":"net","scale":"log"}\n'
+    if args.page or args.page_cycle > 0:
+        page_cmd = {"cmd": "page", "cycle": max(0.0, args.page_cycle)}
+        if args.page:
+            page_cmd["p"] = args.page
+        setup += (json.dumps(page_cmd, separators=(",", ":")) + "\n").encode("utf-8")
+
     # If tray requested, try it; on failure or unavailability, fall back to headless bridge
     if args.tray:
         if TRAY_AVAILABLE:
@@ -190,82 +624,62 @@ def main() -> int:
             ser = None
             time.sleep(1.0)
 
-    last_weather: Optional[Weather] = None
-    last_weather_ts = 0.0
-    # Net IO baseline for rates
-    last_net = psutil.net_io_counters()
-    last_net_ts = time.time()
+    prof = make_profiler(args)
+    builder = PayloadBuilder(args.lat, args.lon, get_sampler(args.sample_hz, args.collector), prof,
+                             args.app_source, args.app_interval, procs=args.page == "procs" or args.page_cycle > 0)
+    journal = open_journal(args)
+    ingest_srv = make_ingest(args)
+    reader = LineReader()
+    ser.write(b'{"cmd":"hello"}\n')  # the reply triggers the backlog replay
+    framer = BatchFramer(builder.sampler) if args.batch_ms > 0 else None
+    streamer = None
+    if args.host_render:
+        streamer = FrameStreamer(HostRenderer(), args.host_render_fps, args.host_render_keyframe, verbose=args.verbose)
+        prof.add_reporter("host_render", lambda: {"frames": streamer.stats()})
+    delta = DeltaEncoder(args.delta_keyframe) if args.delta_keyframe > 0 else None
+    if delta is not None:
+        prof.add_reporter("delta", delta.stats)
+    payload = None
+    interval = max(0.1, args.interval)
+    next_full = time.monotonic()
 
     try:
         while True:
-            cpu, total_kb, used_kb = get_system_stats()
-            disk_free_kb = get_disk_free_kb()
-
-            payload = {
-                "cpu": round(cpu, 1),
-                "ram": total_kb,
-                "ram_used": used_kb,
-            }
-
-            # Host/time/uptime
-            try:
-                payload["host"] = socket.gethostname()
-            except Exception:
-                pass
-            payload["time"] = int(time.time())
-            try:
-                payload["uptime"] = int(time.time() - psutil.boot_time())
-            except Exception:
-                pass
-            if disk_free_kb >= 0:
-                payload["disk_free"] = disk_free_kb
-
-            # Network RX/TX rate (KB/s)
-            try:
-                now = time.time()
-                cur = psutil.net_io_counters()
-                dt = max(0.1, now - last_net_ts)
-                rx_rate = (cur.bytes_recv - last_net.bytes_recv) / 1024.0 / dt
-                tx_rate = (cur.bytes_sent - last_net.bytes_sent) / 1024.0 / dt
-                payload["net"] = {"rx": round(rx_rate, 1), "tx": round(tx_rate, 1)}
-                last_net, last_net_ts = cur, now
-            except Exception:
-                pass
-
-            # Application active (macOS)
-            try:
-                app = get_active_app_name_macos()
-                if app:
-                    payload["app"] = app
-            except Exception:
-                pass
-
-            # Refresh weather every 5 minutes
-            now = time.time()
-            if args.lat is not None and args.lon is not None and (now - last_weather_ts > 300 or last_weather is None):
-                last_weather = get_weather(args.lat, args.lon)
-                last_weather_ts = now
-
-            if last_weather is not None:
-                w = {}
-                if last_weather.temp is not None:
-                    w["temp"] = round(float(last_weather.temp), 1)
-                if last_weather.desc:
-                    w["desc"] = last_weather.desc
-                if last_weather.code is not None:
-                    try:
-                        w["wcode"] = int(last_weather.code)
-                    except Exception:
-                        pass
-                if w:
-                    payload["weather"] = w
-
-            line = json.dumps(payload, separators=(",", ":")) + "\n"
-            if args.verbose:
-                print(f"[host_bridge] TX: {line.strip()}")
+            data = b""
+            if framer is not None:
+                with prof.section("sink:encode"):
+                    data = framer.frame() or b""
+            now = time.monotonic()
+            if now >= next_full:
+                next_full = next_full + interval if next_full + interval > now else now + interval
+                payload = builder.build()
+                if ingest_srv is not None:
+                    with prof.section("collect:ingest"):
+                        extra = ingest_srv.agg.drain()
+                    if extra:
+                        payload["x"] = {k: round(v, 2) for k, v in extra.items()}
+                if journal is not None:
+                    with prof.section("sink:journal"):
+                        journal.append(payload)
+
+                with prof.section("sink:encode"):
+                    if delta is not None and delta.enabled:
+                        out = delta.encode(payload, now, builder.boot_time)
+                    else:
+                        out = (json.dumps(payload, separators=(",", ":")) + "\n").encode("utf-8")
+                    data += out
+                if args.verbose:
+                    print(f"[host_bridge] TX: {out.decode('utf-8').strip()}")
             try:
-                ser.write(line.encode("utf-8"))
-                ser.flush()
+                with prof.section("device:rx"):
+                    handle_device_messages(ser, reader, journal, args.verbose, setup, streamer, delta)
+                if streamer is not None:
+                    with prof.section("sink:render"):
+                        data += streamer.frame(time.monotonic(), payload, builder.sampler.latest())
+                if data:
+                    with prof.section("sink:serial"):
+                        ser.write(data)
+                        ser.flush()
             except Exception as e:
                 if args.verbose:
                     print(f"[host_bridge] Serial write failed: {e}. Reconnecting...")
@@ -288,11 +702,17 @@ def main() -> int:
                             print(f"[host_bridge] Reconnected: {port} @ {args.baud}")
                         time.sleep(1.5)
                         preferred = port
+                        reader.reset()
+                        ser.write(b'{"cmd":"hello"}\n')
                     except Exception:
                         ser = None
                         time.sleep(1.0)
 
-            time.sleep(max(0.1, args.interval))
+            prof.tick()
+            wake = next_full if framer is None else min(next_full, time.monotonic() + args.batch_ms / 1000.0)
+            if streamer is not None:
+                wake = min(wake, streamer.next_due(time.monotonic()))
+            time.sleep(max(0.005 if streamer is not None else 0.01, wake - time.monotonic()))
     except KeyboardInterrupt:
         pass
     finally:
@@ -300,6 +720,11 @@ def main() -> int:
             ser.close()
         except Exception:
             pass
+        builder.close()
+        if journal is not None:
+            journal.close()
+        if ingest_srv is not None:
+            ingest_srv.close()
 
     return 0
 
@@ -320,10 +745,8 @@ def run_tray(args) -> int:
             # run a reduced copy of main() loop; reuse functions above
             preferred = self.args.port
             ser = None
-            last_weather = None
-            last_weather_ts = 0.0
-            last_net = psutil.net_io_counters()
-            last_net_ts = time.time()
+            builder = PayloadBuilder(self.args.lat, self.args.lon, get_sampler(self.args.sample_hz, self.args.collector),
+                                     app_source=self.args.app_source, app_interval=self.args.app_interval)
             while not self.stop_flag:
                 # ensure connection
                 while ser is None and not self.stop_flag:
@@ -342,54 +765,7 @@ def run_tray(args) -> int:
                 if self.stop_flag:
                     break
 
-                # Build payload
-                cpu, total_kb, used_kb = get_system_stats()
-                disk_free_kb = get_disk_free_kb()
-                payload = {"cpu": round(cpu, 1), "ram": total_kb, "ram_used": used_kb}
-                try:
-                    payload["host"] = socket.gethostname()
-                except Exception:
-                    pass
-                payload["time"] = int(time.time())
-                try:
-                    payload["uptime"] = int(time.time() - psutil.boot_time())
-                except Exception:
-                    pass
-                if disk_free_kb >= 0:
-                    payload["disk_free"] = disk_free_kb
-                try:
-                    now_ts = time.time()
-                    cur = psutil.net_io_counters()
-                    dt = max(0.1, now_ts - last_net_ts)
-                    rx_rate = (cur.bytes_recv - last_net.bytes_recv) / 1024.0 / dt
-                    tx_rate = (cur.bytes_sent - last_net.bytes_sent) / 1024.0 / dt
-                    payload["net"] = {"rx": round(rx_rate, 1), "tx": round(tx_rate, 1)}
-                    last_net, last_net_ts = cur, now_ts
-                except Exception:
-                    pass
-                try:
-                    app = get_active_app_name_macos()
-                    if app:
-                        payload["app"] = app
-                except Exception:
-                    pass
-                now_ts = time.time()
-                if args.lat is not None and args.lon is not None and (now_ts - last_weather_ts > 300 or last_weather is None):
-                    last_weather = get_weather(args.lat, args.lon)
-                    last_weather_ts = now_ts
-                if last_weather is not None:
-                    w = {}
-                    if last_weather.temp is not None:
-                        w["temp"] = round(float(last_weather.temp), 1)
-                    if last_weather.desc:
-                        w["desc"] = last_weather.desc
-                    if last_weather.code is not None:
-                        try:
-                            w["wcode"] = int(last_weather.code)
-                        except Exception:
-                            pass
-                    if w:
-                        payload["weather"] = w
+                payload = builder.build()
 
                 line = json.dumps(payload, separators=(",", ":")) + "\n"
                 try:
@@ -0,0 +1,364 @@
+"""
+Host-rendered frames for the device's 128x64 SH1106 (host_bridge.py --host-render).
+
+The bridge draws the whole UI here, into a 1-bit buffer laid out like the
+SH1106 RAM (8 pages of 128 column bytes, bit 0 at the top), and streams only
+the pages that changed since the previous frame:
+
+  {"t":"fb","s":<seq>,"k":1,"e":1,"p":[[page,"<hex PackBits>"],...]}
+
+- s: frame sequence number (16 bits); a frame may span several lines (same s,
+  "e" on the last one) so each stays well under the device's line limit.
+- k: keyframe, every page; sent first, every --host-render-keyframe seconds,
+  and whenever the device asks ({"t":"fbk","key":1}) because a delta did not
+  follow the frame it shows (lost line, device reset, local rendering between).
+- The device answers {"t":"fbk","s":<seq>} once the frame's pages reached the
+  panel; the next frame waits for that ack (or a timeout, then a keyframe), so
+  the frame rate follows the serial link and the I2C bus.
+
+The device falls back to its own rendering when frames stop. Only firmwares
+whose hello carries "fb":[128,64] get frames (not the SSD1327 build).
+
+The layout reuses the firmware's font (tools/gen_font.py) and adds what the
+device does not draw itself: a clock and a one-minute CPU/RAM sparkline.
+"""
+from __future__ import annotations
+
+import json
+import time
+from collections import deque
+from typing import Dict, List, Optional, Tuple
+
+try:
+    import gen_font
+except Exception:
+    from tools import gen_font  # type: ignore
+
+W, H = 128, 64
+PAGES = H // 8
+LINE_HEX_MAX = 1000    # hex chars per line (device: 1536 B lines, 2048 B JSON document)
+SPARK_STEP_S = 1.0     # one sparkline column per second
+TICKER_PX_S = 20.0     # ticker speed, independent of the frame rate
+INVERT = -1
+
+
+# ------------------------------------------------------------------ encoding
+
+def packbits(data: bytes) -> bytes:
+    """PackBits: header h < 128 -> h + 1 literal bytes; h > 128 -> next byte repeated 257 - h times."""
+    out = bytearray()
+    i, n = 0, len(data)
+    while i < n:
+        j = i
+        while j + 1 < n and data[j + 1] == data[i] and j - i < 127:
+            j += 1
+        if j - i >= 2:  # run of 3 or more
+            out += bytes((257 - (j - i + 1), data[i]))
+            i = j + 1
+            continue
+        start = i
+        while i < n and i - start < 128:
+            if i + 2 < n and data[i] == data[i + 1] == data[i + 2]:
+                break
+            i += 1
+        out.append(i - start - 1)
+        out += data[start:i]
+    return bytes(out)
+
+
+def unpackbits(data: bytes) -> bytes:
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        h = data[i]
+        if h < 128:
+            out += data[i + 1:i + 2 + h]
+            i += 2 + h
+        elif h > 128:
+            out += bytes((data[i + 1],)) * (257 - h)
+            i += 2
+        else:
+            i += 1
+    return bytes(out)
+
+
+def encode_frame(seq: int, key: bool, pages: List[Tuple[int, bytes]]) -> List[bytes]:
+    """{"t":"fb"} lines for these (page, 128 bytes) pairs; "e" marks the last line."""
+    entries = [(p, packbits(data).hex()) for p, data in pages]
+    groups, cur, size = [], [], 0
+    for e in entries:
+        if cur and size + len(e[1]) > LINE_HEX_MAX:
+            groups.append(cur)
+            cur, size = [], 0
+        cur.append(e)
+        size += len(e[1])
+    groups.append(cur)
+    lines = []
+    for i, g in enumerate(groups):
+        msg = {"t": "fb", "s": seq}
+        if key:
+            msg["k"] = 1
+        if i == len(groups) - 1:
+            msg["e"] = 1
+        msg["p"] = [[p, hx] for p, hx in g]
+        lines.append((json.dumps(msg, separators=(",", ":")) + "\n").encode("ascii"))
+    return lines
+
+
+# ------------------------------------------------------------------ drawing
+
+class Font:
+    """The firmware's 7 px proportional font and Unicode folding, from gen_font."""
+
+    def __init__(self):
+        chars, self.glyphs = gen_font.build(gen_font.DEFAULT_CHARS, True)
+        self.fold = dict((chr(cp), to) for cp, to in gen_font.fold_table(chars))
+        self.height = gen_font.HEIGHT
+        self.spacing = gen_font.SPACING
+
+    def columns(self, text: str) -> List[int]:
+        cols: List[int] = []
+        for c in text:
+            for g in self.fold.get(c, c):
+                cols.extend(self.glyphs.get(g, self.glyphs["?"]))
+                cols.extend([0] * self.spacing)
+        return cols
+
+    def width(self, text: str) -> int:
+        return len(self.columns(text))
+
+
+class Canvas:
+    """128x64, 1 bit, SH1106 page layout: byte x + (y // 8) * W, bit y % 8."""
+
+    def __init__(self, font: Font):
+        self.buf = bytearray(W * PAGES)
+        self.font = font
+
+    def clear(self) -> None:
+        self.buf[:] = bytes(len(self.buf))
+
+    def pixel(self, x: int, y: int, ink: int = 1) -> None:
+        if 0 <= x < W and 0 <= y < H:
+            i, m = x + (y >> 3) * W, 1 << (y & 7)
+            if ink == INVERT:
+                self.buf[i] ^= m
+            elif ink:
+                self.buf[i] |= m
+            else:
+                self.buf[i] &= ~m & 0xFF
+
+    def fill_rect(self, x: int, y: int, w: int, h: int, ink: int = 1) -> None:
+        for yy in range(max(0, y), min(H, y + h)):
+            for xx in range(max(0, x), min(W, x + w)):
+                self.pixel(xx, yy, ink)
+
+    def rect(self, x: int, y: int, w: int, h: int, ink: int = 1) -> None:
+        self.fill_rect(x, y, w, 1, ink)
+        self.fill_rect(x, y + h - 1, w, 1, ink)
+        self.fill_rect(x, y + 1, 1, h - 2, ink)
+        self.fill_rect(x + w - 1, y + 1, 1, h - 2, ink)
+
+    def text(self, x: int, y: int, s: str, ink: int = 1, max_w: int = W) -> int:
+        cols = self.font.columns(s)[:max_w]
+        for i, col in enumerate(cols):
+            for j in range(self.font.height):
+                if col & (1 << j):
+                    self.pixel(x + i, y + j, ink)
+        return len(cols)
+
+
+def fmt_rate(kbs: Optional[float]) -> str:
+    if kbs is None:
+        return "--"
+    return f"{kbs:.0f}K" if kbs < 1000 else f"{kbs / 1024:.1f}M"
+
+
+def fmt_mb(mb: float) -> str:
+    return f"{mb / 1024:.0f}GB" if mb > 9999 else f"{mb:.0f}MB"
+
+
+class HostRenderer:
+    """Draws the full UI from the latest payload and the live CPU/RAM sample."""
+
+    def __init__(self):
+        self.canvas = Canvas(Font())
+        self.spark: deque = deque(maxlen=60)  # (cpu %, ram %) per SPARK_STEP_S
+        self.acc: List[Tuple[float, Optional[float]]] = []
+        self.acc_t0: Optional[float] = None
+        self.alerts: Dict[int, str] = {}      # rule -> label while active
+        self.t0 = time.monotonic()
+
+    def alert(self, msg: dict) -> None:
+        r = msg.get("r")
+        if msg.get("on"):
+            self.alerts[r] = f"{msg.get('m')} {msg.get('v')}"
+        else:
+            self.alerts.pop(r, None)
+
+    def _sample(self, now: float, cpu: Optional[float], ram: Optional[float]) -> None:
+        if cpu is None:
+            return
+        if self.acc_t0 is None:
+            self.acc_t0 = now
+        self.acc.append((cpu, ram))
+        if now - self.acc_t0 >= SPARK_STEP_S:
+            rams = [r for _, r in self.acc if r is not None]
+            self.spark.append((max(c for c, _ in self.acc), sum(rams) / len(rams) if rams else None))
+            self.acc, self.acc_t0 = [], now
+
+    def ticker_text(self, p: dict) -> str:
+        parts = []
+        w = p.get("weather") or {}
+        if w.get("desc"):
+            parts.append(w["desc"])
+        if p.get("ram") and p.get("ram_used") is not None:
+            parts.append(f"RAM {(p['ram'] - p['ram_used']) // 1024}MB")
+        if p.get("disks"):
+            parts.append("DISK " + " ".join(f"{d['id']} {fmt_mb(d['free'])}" for d in p["disks"]))
+        elif p.get("disk_free") is not None:
+            parts.append(f"DISK {fmt_mb(p['disk_free'] / 1024)}")
+        if p.get("uptime") is not None:
+            m = p["uptime"] // 60
+            parts.append(f"UPT {m // 1440}d {m // 60 % 24}h{m % 60}m")
+        for k, v in (p.get("x") or {}).items():
+            parts.append(f"{k} {v:g}")
+        return "   ".join(parts)
+
+    def render(self, payload: Optional[dict], live: Tuple[Optional[float], Optional[float]], now: float) -> bytes:
+        c = self.canvas
+        c.clear()
+        p = payload or {}
+        cpu, ram = live
+        if cpu is None:
+            cpu = p.get("cpu")
+        if ram is None and p.get("ram"):
+            ram = 100.0 * p.get("ram_used", 0) / p["ram"]
+        self._sample(now, cpu, ram)
+
+        # Header: temperature, app, clock
+        c.fill_rect(0, 0, W, 10, 1)
+        temp = (p.get("weather") or {}).get("temp")
+        left = c.text(2, 2, "--C" if temp is None else f"{temp:.0f}C", 0)
+        clock = time.strftime("%H:%M")
+        cw = c.font.width(clock)
+        c.text(W - 2 - cw, 2, clock, 0)
+        app = p.get("app") or "SMON"
+        xs = 2 + left + 4
+        room = max(0, W - 2 - cw - 4 - xs)
+        aw = min(room, c.font.width(app))
+        c.text(xs + (room - aw) // 2, 2, app, 0, room)
+
+        # Left column: CPU / RAM bars, network
+        y = 12
+        for label, val in (("CPU", cpu), ("RAM", ram)):
+            c.text(0, y, label + (" --" if val is None else f" {val:.0f}%"))
+            c.rect(0, y + 8, 60, 6)
+            if val is not None:
+                c.fill_rect(1, y + 9, int(58 * max(0.0, min(100.0, val)) / 100 + 0.5), 4)
+            y += 16
+        net = p.get("net") or {}
+        c.text(0, y + 1, f"{fmt_rate(net.get('rx'))}/{fmt_rate(net.get('tx'))}", 1, 62)
+
+        # Right column: one minute of CPU (bars) and RAM (dots), newest on the right
+        gx, gy, gw, gh = 64, 12, 64, 40
+        c.rect(gx, gy, gw, gh)
+        for i, (sc, sr) in enumerate(reversed(self.spark)):
+            x = gx + gw - 2 - i
+            if x <= gx:
+                break
+            h = int((gh - 2) * sc / 100 + 0.5)
+            c.fill_rect(x, gy + gh - 1 - h, 1, h)
+            if sr is not None:
+                c.pixel(x, gy + gh - 2 - int((gh - 3) * sr / 100), INVERT)
+
+        # Ticker, or the newest alert as an inverted banner
+        ty = H - 7
+        if self.alerts:
+            c.fill_rect(0, ty - 2, W, 9, 1)
+            c.text(2, ty, "! " + list(self.alerts.values())[-1], 0)  # newest fired
+        else:
+            c.fill_rect(0, ty - 2, W, 1, 1)
+            text = self.ticker_text(p) if payload else "waiting for data"
+            tw = c.font.width(text) + W
+            c.text(W - int((now - self.t0) * TICKER_PX_S) % tw, ty, text)
+        return bytes(c.buf)
+
+
+# ------------------------------------------------------------------ streaming
+
+class FrameStreamer:
+    """Sends changed pages to the device, one frame in flight, keyframes on demand."""
+
+    def __init__(self, renderer: HostRenderer, fps: float = 20.0, keyframe_s: float = 10.0,
+                 ack_timeout_s: float = 0.5, verbose: bool = False):
+        self.renderer = renderer
+        self.period = 1.0 / max(0.5, fps)
+        self.keyframe_s = keyframe_s
+        self.ack_timeout_s = ack_timeout_s
+        self.verbose = verbose
+        self.enabled = False              # the device's hello offered "fb"
+        self.seq = 0
+        self.shown: Optional[bytes] = None  # what the device holds, None = unknown (keyframe next)
+        self.inflight: Optional[Tuple[int, float]] = None
+        self.next_at = 0.0
+        self.last_key = 0.0
+        self.counts = {"frames": 0, "keyframes": 0, "pages": 0, "bytes": 0, "acked": 0,
+                       "key_requests": 0, "ack_timeouts": 0, "render_s": 0.0}
+
+    def on_message(self, msg: dict) -> None:
+        kind = msg.get("t")
+        if kind == "hello":
+            self.enabled = msg.get("fb") == [W, H]
+            self.shown, self.inflight = None, None
+            if self.verbose:
+                print(f"[host_render] Device {'accepts' if self.enabled else 'does not accept'} host frames")
+        elif kind == "fbk":
+            if msg.get("key"):
+                self.counts["key_requests"] += 1
+                self.shown, self.inflight = None, None
+            elif self.inflight is not None and msg.get("s") == self.inflight[0]:
+                self.counts["acked"] += 1
+                self.inflight = None
+        elif kind == "alert":
+            self.renderer.alert(msg)
+
+    def next_due(self, now: float) -> float:
+        """When frame() should be called again (early while waiting for an ack)."""
+        if not self.enabled:
+            return now + 1.0
+        return max(self.next_at, now + 0.01) if self.inflight is not None else self.next_at
+
+    def frame(self, now: float, payload: Optional[dict], live: Tuple[Optional[float], Optional[float]]) -> bytes:
+        if not self.enabled or now < self.next_at:
+            return b""
+        if self.inflight is not None:
+            if now - self.inflight[1] < self.ack_timeout_s:
+                return b""
+            self.counts["ack_timeouts"] += 1
+            self.shown, self.inflight = None, None  # lost somewhere: start over from a keyframe
+        self.next_at = now + self.period
+        t = time.perf_counter()
+        buf = self.renderer.render(payload, live, now)
+        self.counts["render_s"] += time.perf_counter() - t
+        key = self.shown is None or now - self.last_key >= self.keyframe_s
+        pages = [(p, buf[p * W:(p + 1) * W]) for p in range(PAGES)
+                 if key or buf[p * W:(p + 1) * W] != self.shown[p * W:(p + 1) * W]]
+        if not pages:
+            return b""
+        self.seq = (self.seq + 1) & 0xFFFF
+        lines = encode_frame(self.seq, key, pages)
+        self.shown, self.inflight = buf, (self.seq, now)
+        if key:
+            self.last_key = now
+            self.counts["keyframes"] += 1
+        self.counts["frames"] += 1
+        self.counts["pages"] += len(pages)
+        data = b"".join(lines)
+        self.counts["bytes"] += len(data)
+        return data
+
+    def stats(self) -> Dict[str, float]:
+        c = dict(self.counts)
+        c["render_s"] = round(c["render_s"], 4)
+        return c
@@ -0,0 +1,306 @@
+"""
+Local metrics ingest for the host bridge (--ingest-uds / --ingest-udp).
+
+Other machines and local services push values in a statsd-like line format,
+one metric per line (several lines per datagram/write are fine):
+
+    name:value|g        gauge: last value of the tick
+    name:value|c        counter: summed, forwarded as a rate per second
+    name:value|ms       timer/histogram: mean of the tick ("|h" is the same)
+
+A trailing "|@rate" sample rate is honoured for counters; anything after that
+is ignored. Names are limited to [A-Za-z0-9_.-], 15 characters.
+
+Each update costs one dict lookup and a few additions; the per-key state is
+swapped out at every tick and turned into the "x" field of the payload.
+
+Backpressure and limits:
+- every source (UDS connection, UDP address) has a token bucket of `rate`
+  lines/s with a one-second burst;
+- a UDS stream that runs out of tokens is no longer read until the bucket
+  refills, so the kernel buffer fills up and the sender blocks;
+- UDP has no way to push back: lines over the budget are dropped and counted;
+- at most `max_keys` distinct names per tick (new names beyond are dropped).
+"""
+from __future__ import annotations
+
+import os
+import selectors
+import socket
+import threading
+import time
+from typing import Dict, Optional, Tuple
+
+MAX_NAME = 15
+_NAME_OK = frozenset(b"abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_.-")
+_KINDS = {b"g": "g", b"c": "c", b"ms": "t", b"h": "t"}
+
+
+class _Agg:
+    __slots__ = ("kind", "n", "total", "last", "ts")
+
+    def __init__(self, kind: str):
+        self.kind = kind
+        self.n = 0
+        self.total = 0.0
+        self.last = 0.0
+        self.ts = 0.0
+
+
+class _Bucket:
+    """Token bucket: `rate` lines/s, burst of one second (at least one line)."""
+
+    __slots__ = ("rate", "burst", "tokens", "ts")
+
+    def __init__(self, rate: float):
+        self.rate = rate
+        self.burst = max(rate, 1.0)  # below 1/s a one-second burst never holds a whole token
+        self.tokens = self.burst
+        self.ts = time.monotonic()
+
+    def take(self, n: int = 1) -> int:
+        """Consume up to n tokens; returns how many were granted."""
+        now = time.monotonic()
+        self.tokens = min(self.burst, self.tokens + (now - self.ts) * self.rate)
+        self.ts = now
+        granted = min(n, int(self.tokens))
+        self.tokens -= granted
+        return granted
+
+    def wait_s(self) -> float:
+        """Seconds until at least one token is available."""
+        self.take(0)
+        return max(0.0, (1.0 - self.tokens) / self.rate)
+
+
+class Aggregator:
+    def __init__(self, max_keys: int = 32, gauge_ttl: float = 60.0):
+        self.max_keys = max_keys
+        self.gauge_ttl = gauge_ttl
+        self.lock = threading.Lock()
+        self.keys: Dict[str, _Agg] = {}
+        self.t0 = time.monotonic()
+        self.accepted = 0
+        self.bad = 0
+        self.dropped_keys = 0
+
+    def feed_line(self, line: bytes) -> bool:
+        name, sep, rest = line.partition(b":")
+        if not sep or not name or len(name) > MAX_NAME or not _NAME_OK.issuperset(name):
+            self.bad += 1
+            return False
+        fields = rest.split(b"|")
+        kind = _KINDS.get(fields[1].strip()) if len(fields) > 1 else "g"
+        try:
+            value = float(fields[0])
+        except ValueError:
+            kind = None
+        if kind is None:
+            self.bad += 1
+            return False
+        if kind == "c" and len(fields) > 2 and fields[2].startswith(b"@"):
+            try:
+                rate = float(fields[2][1:])
+                if rate > 0:
+                    value /= rate
+            except ValueError:
+                pass
+        key = name.decode("ascii")
+        with self.lock:
+            agg = self.keys.get(key)
+            if agg is None:
+                if len(self.keys) >= self.max_keys:
+                    self.dropped_keys += 1
+                    return False
+                agg = self.keys[key] = _Agg(kind)
+            agg.n += 1
+            agg.total += value
+            agg.last = value
+            agg.ts = time.monotonic()
+            self.accepted += 1
+        return True
+
+    def drain(self) -> Dict[str, float]:
+        """Per-key values since the previous drain (gauges keep their last value)."""
+        now = time.monotonic()
+        with self.lock:
+            keys, elapsed = self.keys, max(1e-3, now - self.t0)
+            self.t0 = now
+            # Gauges persist across ticks like statsd (until their source goes
+            # quiet for gauge_ttl); counters and timers restart
+            self.keys = {k: a for k, a in keys.items() if a.kind == "g" and now - a.ts < self.gauge_ttl}
+            for a in self.keys.values():
+                a.n, a.total = 0, 0.0
+        out = {}
+        for k, a in keys.items():
+            if a.kind == "g":
+                out[k] = a.last
+            elif a.kind == "c":
+                out[k] = a.total / elapsed
+            elif a.n:
+                out[k] = a.total / a.n
+        return out
+
+
+class IngestServer(threading.Thread):
+    def __init__(self, aggregator: Aggregator, uds_path: Optional[str] = None,
+                 udp_addr: Optional[Tuple[str, int]] = None, rate: float = 200.0,
+                 max_line: int = 512):
+        super().__init__(daemon=True)
+        if not rate > 0:
+            raise ValueError("ingest rate must be > 0")  # checked here, not in the server thread
+        self.agg = aggregator
+        self.rate = rate
+        self.max_line = max_line
+        self.sel = selectors.DefaultSelector()
+        self.buckets: Dict[object, _Bucket] = {}
+        self.paused: Dict[socket.socket, float] = {}  # UDS conn -> resume time
+        self.pending: Dict[socket.socket, bytearray] = {}
+        self.dropped_rate = 0
+        self.stop_flag = False
+        self.uds_path = uds_path
+        self.udp_addr = None
+        if uds_path:
+            if os.path.exists(uds_path):
+                os.unlink(uds_path)  # stale socket from a previous run
+            srv = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+            srv.bind(uds_path)
+            srv.listen(16)
+            srv.setblocking(False)
+            self.sel.register(srv, selectors.EVENT_READ, self._accept)
+        if udp_addr:
+            udp = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+            udp.bind(udp_addr)
+            udp.setblocking(False)
+            self.udp_addr = udp.getsockname()
+            self.sel.register(udp, selectors.EVENT_READ, self._read_udp)
+
+    def _bucket(self, source) -> _Bucket:
+        b = self.buckets.get(source)
+        if b is None:
+            if len(self.buckets) > 1024:
+                self.buckets.clear()  # many short-lived UDP senders: forget old budgets
+            b = self.buckets[source] = _Bucket(self.rate)
+        return b
+
+    def _accept(self, srv: socket.socket) -> None:
+        try:
+            conn, _ = srv.accept()
+        except OSError:
+            return
+        conn.setblocking(False)
+        self.pending[conn] = bytearray()
+        self.sel.register(conn, selectors.EVENT_READ, self._read_uds)
+
+    def _feed(self, lines, bucket: _Bucket) -> int:
+        """Feed complete lines within the source budget; returns lines not fed."""
+        granted = bucket.take(len(lines))
+        for line in lines[:granted]:
+            self.agg.feed_line(line.strip())
+        return len(lines) - granted
+
+    def _read_udp(self, sock: socket.socket) -> None:
+        for _ in range(64):  # bounded work per wakeup
+            try:
+                data, addr = sock.recvfrom(4096)
+            except (BlockingIOError, InterruptedError):
+                return
+            except OSError:
+                return
+            lines = [line for line in data.split(b"\n") if line.strip()]
+            self.dropped_rate += self._feed(lines, self._bucket(addr[0]))
+
+    def _close(self, conn: socket.socket) -> None:
+        self.sel.unregister(conn)
+        self.pending.pop(conn, None)
+        self.buckets.pop(conn, None)
+        self.paused.pop(conn, None)
+        conn.close()
+
+    def _read_uds(self, conn: socket.socket) -> None:
+        buf = self.pending[conn]
+        if buf.rfind(b"\n") < 0:
+            try:
+                data = conn.recv(4096)
+            except (BlockingIOError, InterruptedError):
+                return
+            except OSError:
+                data = b""
+            if not data:
+                self._close(conn)
+                return
+            buf += data
+        end = buf.rfind(b"\n")
+        if end < 0:
+            if len(buf) > self.max_line:
+                buf.clear()  # no newline in sight: resync
+            return
+        bucket = self._bucket(conn)
+        lines = [line for line in bytes(buf[:end]).split(b"\n") if line.strip()]
+        del buf[:end + 1]
+        left = self._feed(lines, bucket)
+        if left:
+            # Keep the rest and stop reading until the budget refills: the
+            # kernel buffer fills up and the sender blocks
+            buf[:0] = b"\n".join(lines[-left:]) + b"\n"
+            self._pause(conn, bucket)
+
+    def _pause(self, conn: socket.socket, bucket: _Bucket) -> None:
+        self.sel.unregister(conn)
+        self.paused[conn] = time.monotonic() + bucket.wait_s()
+
+    def _resume_due(self) -> Optional[float]:
+        now = time.monotonic()
+        soonest = None
+        for conn, at in list(self.paused.items()):
+            if at <= now:
+                del self.paused[conn]
+                self.sel.register(conn, selectors.EVENT_READ, self._read_uds)
+                self._read_uds(conn)  # drain what was kept back
+            else:
+                soonest = at if soonest is None else min(soonest, at)
+        return None if soonest is None else max(0.0, soonest - now)
+
+    def run(self) -> None:
+        while not self.stop_flag:
+            wait = self._resume_due()
+            for key, _ in self.sel.select(0.5 if wait is None else min(0.5, wait)):
+                key.data(key.fileobj)
+
+    def stats(self) -> dict:
+        return {"accepted": self.agg.accepted, "bad": self.agg.bad,
+                "dropped_rate": self.dropped_rate, "dropped_keys": self.agg.dropped_keys}
+
+    def close(self) -> None:
+        self.stop_flag = True
+        if self.is_alive() and threading.current_thread() is not self:
+            self.join(1.0)
+        for key in list(self.sel.get_map().values()):
+            key.fileobj.close()
+        for conn in self.paused:
+            conn.close()
+        self.sel.close()
+        if self.uds_path:
+            try:
+                os.unlink(self.uds_path)
+            except OSError:
+                pass
+
+
+def parse_udp_addr(spec: str) -> Tuple[str, int]:
+    """'8125' or 'host:8125' (default host 127.0.0.1)."""
+    host, _, port = spec.rpartition(":")
+    return host or "127.0.0.1", int(port)
+
+
+def make_ingest(args) -> Optional[IngestServer]:
+    if not (getattr(args, "ingest_uds", None) or getattr(args, "ingest_udp", None)):
+        return None
+    server = IngestServer(
+        Aggregator(args.ingest_max_keys),
+        uds_path=args.ingest_uds,
+        udp_addr=parse_udp_addr(args.ingest_udp) if args.ingest_udp else None,
+        rate=args.ingest_rate,
+    )
+    server.start()
+    return server
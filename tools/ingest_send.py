@@ -0,0 +1,130 @@
+#!/usr/bin/env python3
+# Stand-in sender for the bridge's ingest socket, and a local check of it.
+#   python tools/ingest_send.py --udp 8125 queue.depth:42|g req:1|c
+#   python tools/ingest_send.py --uds /tmp/smon.sock --rate 50 --duration 10   (synthetic)
+#   python tools/ingest_send.py --check      (in-process server: parse, aggregate, limits)
+from __future__ import annotations
+import argparse
+import os
+import random
+import socket
+import sys
+import tempfile
+import time
+
+try:
+    from ingest import Aggregator, IngestServer, parse_udp_addr
+except Exception:
+    from tools.ingest import Aggregator, IngestServer, parse_udp_addr  # type: ignore
+
+
+def connect(args):
+    if args.uds:
+        s = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        s.connect(args.uds)
+        return lambda data: s.sendall(data), s
+    s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    addr = parse_udp_addr(args.udp)
+    return lambda data: s.sendto(data, addr), s
+
+
+def synthetic_lines(rng: random.Random, t: float) -> bytes:
+    depth = int(40 + 30 * rng.random() + 20 * (int(t) % 10 > 7))
+    return (f"queue.depth:{depth}|g\n"
+            f"req:{rng.randint(1, 5)}|c\n"
+            f"latency:{rng.uniform(5, 40):.1f}|ms\n").encode()
+
+
+def check() -> int:
+    """Exercise the server with real sockets; returns the number of failures."""
+    failures = 0
+
+    def expect(what: str, ok: bool, detail="") -> None:
+        nonlocal failures
+        print(("ok   " if ok else "FAIL ") + what + (f" ({detail})" if detail else ""))
+        failures += 0 if ok else 1
+
+    path = os.path.join(tempfile.mkdtemp(), "ingest.sock")
+    agg = Aggregator(max_keys=4)
+    srv = IngestServer(agg, uds_path=path, udp_addr=("127.0.0.1", 0), rate=100.0)
+    srv.start()
+    try:
+        udp = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        udp.sendto(b"depth:7|g\ndepth:9|g\nreq:10|c|@0.5\nlat:10|ms\nlat:30|ms\nbad line\n", srv.udp_addr)
+        uds = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        uds.connect(path)
+        uds.sendall(b"jobs:3|g\nother:1|g\n")
+        time.sleep(0.3)
+        out = agg.drain()
+        expect("gauge keeps last value", out.get("depth") == 9.0, out.get("depth"))
+        expect("counter scaled by sample rate, as a rate", out.get("req", 0) > 0, out.get("req"))
+        expect("timer is the mean", out.get("lat") == 20.0, out.get("lat"))
+        expect("uds source aggregated", out.get("jobs") == 3.0, out.get("jobs"))
+        expect("key cap drops new names", "other" not in out and agg.dropped_keys == 1, agg.dropped_keys)
+        expect("malformed line counted", agg.bad == 1, agg.bad)
+        out = agg.drain()
+        expect("gauges persist, counters reset", out.get("depth") == 9.0 and "req" not in out, out)
+
+        # UDP over budget: excess dropped (burst = 1 s of rate)
+        before = srv.dropped_rate
+        for _ in range(30):
+            udp.sendto(b"depth:1|g\n" * 10, srv.udp_addr)
+        time.sleep(0.3)
+        expect("udp over budget is dropped", srv.dropped_rate - before >= 150, srv.dropped_rate - before)
+
+        # UDS over budget: nothing dropped, the reader slows the sender down
+        uds2 = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        uds2.connect(path)
+        accepted0, dropped0 = agg.accepted, srv.dropped_rate
+        t0 = time.monotonic()
+        uds2.sendall(b"jobs:1|g\n" * 250)
+        while agg.accepted - accepted0 < 250 and time.monotonic() - t0 < 5:
+            time.sleep(0.05)
+        took = time.monotonic() - t0
+        expect("uds over budget is paced, not dropped",
+               agg.accepted - accepted0 == 250 and srv.dropped_rate == dropped0 and took > 1.0,
+               f"{agg.accepted - accepted0} lines in {took:.2f}s")
+        udp.close()
+        uds.close()
+        uds2.close()
+    finally:
+        srv.close()
+    print("all checks passed" if not failures else f"{failures} check(s) failed")
+    return failures
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description="Send metrics to the bridge ingest socket")
+    dest = parser.add_mutually_exclusive_group()
+    dest.add_argument("--uds", metavar="PATH", help="Unix socket (stream)")
+    dest.add_argument("--udp", metavar="[HOST:]PORT", help="UDP address")
+    parser.add_argument("--rate", type=float, default=10.0, help="Synthetic mode: batches per second")
+    parser.add_argument("--duration", type=float, default=0.0, help="Synthetic mode: seconds (0 = until Ctrl-C)")
+    parser.add_argument("--check", action="store_true", help="Run the local checks against an in-process server")
+    parser.add_argument("lines", nargs="*", help="Lines to send once, e.g. queue.depth:42|g (default: synthetic)")
+    args = parser.parse_args()
+
+    if args.check:
+        return 1 if check() else 0
+    if not (args.uds or args.udp):
+        parser.error("--uds or --udp is required")
+
+    send, sock = connect(args)
+    try:
+        if args.lines:
+            send(("\n".join(args.lines) + "\n").encode())
+            return 0
+        rng = random.Random()
+        t0 = time.monotonic()
+        while not args.duration or time.monotonic() - t0 < args.duration:
+            send(synthetic_lines(rng, time.monotonic() - t0))
+            time.sleep(1.0 / max(0.1, args.rate))
+    except KeyboardInterrupt:
+        pass
+    finally:
+        sock.close()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,156 @@
+"""
+Host-side time-series journal (fixed-size memory-mapped ring file).
+
+Every snapshot the bridge sends is appended as one fixed-size record. Appends
+are O(1) (one struct.pack_into for the record, one for the header) and never
+fsync: dirty pages are left to the kernel, so a bridge restart reopens the same
+file with its history intact.
+
+After a reconnect handshake the bridge downsamples the journal to the device's
+history slot size and sends it as a few compact {"t":"hist"} lines.
+
+File layout (little endian):
+  header (64 bytes): magic "SMJ1", version u16, record size u16, capacity u32,
+                     head u32 (next slot to write), count u32
+  records: capacity x RECORD
+"""
+from __future__ import annotations
+
+import math
+import mmap
+import os
+import struct
+import time
+from typing import Iterator, List, Optional, Tuple
+
+MAGIC = b"SMJ1"
+VERSION = 1
+HEADER = struct.Struct("<4sHHII I")
+HEADER_SIZE = 64
+# ts, cpu, cpu_max, cpu_p95, ram_total_kb, ram_used_kb, ram_max_kb, net_rx, net_tx, disk_free_kb
+RECORD = struct.Struct("<dfffIIIffQ")
+_TS = struct.Struct("<d")
+
+
+class Journal:
+    def __init__(self, path: str, size_mb: float = 16.0):
+        self.path = path
+        capacity = max(16, int(size_mb * 1024 * 1024 - HEADER_SIZE) // RECORD.size)
+        os.makedirs(os.path.dirname(os.path.abspath(path)), exist_ok=True)
+        fresh = not os.path.exists(path)
+        self.f = open(path, "w+b" if fresh else "r+b")
+        hdr = self.f.read(HEADER_SIZE)
+        size = HEADER_SIZE + capacity * RECORD.size
+        if not fresh and len(hdr) >= HEADER.size:
+            magic, ver, rsz, cap, head, count = HEADER.unpack_from(hdr)
+            if magic != MAGIC or ver != VERSION or rsz != RECORD.size or cap != capacity:
+                fresh = True  # other layout or size: start over rather than misread
+        if fresh:
+            self.f.truncate(0)
+        self.f.truncate(size)
+        self.mm = mmap.mmap(self.f.fileno(), size)
+        if fresh:
+            HEADER.pack_into(self.mm, 0, MAGIC, VERSION, RECORD.size, capacity, 0, 0)
+        _, _, _, self.capacity, self.head, self.count = HEADER.unpack_from(self.mm, 0)
+
+    def append(self, payload: dict, ts: Optional[float] = None) -> None:
+        """Store one snapshot (the payload dict as sent to the device)."""
+        off = HEADER_SIZE + self.head * RECORD.size
+        net = payload.get("net") or {}
+        RECORD.pack_into(
+            self.mm, off,
+            0.0,  # timestamp written last: a torn record reads as empty
+            float(payload.get("cpu", math.nan)), float(payload.get("cpu_max", math.nan)),
+            float(payload.get("cpu_p95", math.nan)),
+            int(payload.get("ram", 0)), int(payload.get("ram_used", 0)), int(payload.get("ram_max", 0)),
+            float(net.get("rx", math.nan)), float(net.get("tx", math.nan)),
+            max(0, int(payload.get("disk_free", 0))),
+        )
+        ts = time.time() if ts is None else ts
+        if self.count:
+            # A backwards clock step (NTP) must not break the time order records() searches on
+            ts = max(ts, _TS.unpack_from(self.mm, self._offset(self.count - 1))[0])
+        _TS.pack_into(self.mm, off, ts)
+        self.head = (self.head + 1) % self.capacity
+        self.count = min(self.count + 1, self.capacity)
+        struct.pack_into("<II", self.mm, 12, self.head, self.count)
+
+    def _offset(self, i: int) -> int:
+        """Byte offset of the i-th oldest record."""
+        return HEADER_SIZE + ((self.head - self.count + i) % self.capacity) * RECORD.size
+
+    def records(self, since: float = 0.0) -> Iterator[Tuple]:
+        """Valid records with ts >= since, oldest first."""
+        # append() keeps ts non-decreasing: binary search the first record >= since
+        lo, hi = 0, self.count
+        while lo < hi:
+            mid = (lo + hi) // 2
+            if _TS.unpack_from(self.mm, self._offset(mid))[0] < since:
+                lo = mid + 1
+            else:
+                hi = mid
+        for i in range(lo, self.count):
+            rec = RECORD.unpack_from(self.mm, self._offset(i))
+            if rec[0] > 0:
+                yield rec
+
+    def downsample(self, slot_s: float, slots: int, end: Optional[float] = None) -> List[Optional[Tuple[float, float, float]]]:
+        """`slots` buckets of `slot_s` seconds ending at `end`, oldest first.
+
+        Each bucket is (cpu mean, cpu max, ram used %) or None when empty.
+        """
+        end = time.time() if end is None else end
+        begin = end - slot_s * slots
+        acc = [[0.0, 0, 0.0, 0.0] for _ in range(slots)]  # cpu sum, n, cpu max, ram % sum
+        for rec in self.records(begin):
+            ts, cpu, cpu_max, _p95, ram_total, ram_used = rec[:6]
+            k = int((ts - begin) // slot_s)
+            if not 0 <= k < slots or math.isnan(cpu):
+                continue
+            a = acc[k]
+            a[0] += cpu
+            a[1] += 1
+            a[2] = max(a[2], cpu if math.isnan(cpu_max) else cpu_max)
+            a[3] += 100.0 * ram_used / ram_total if ram_total else 0.0
+        return [(a[0] / a[1], a[2], a[3] / a[1]) if a[1] else None for a in acc]
+
+    def close(self) -> None:
+        try:
+            self.mm.flush()
+            self.mm.close()
+            self.f.close()
+        except (ValueError, OSError):
+            pass
+
+
+def backlog_lines(journal: Journal, slot_ms: int, slots: int, chunk: int = 40) -> List[bytes]:
+    """Encode the downsampled journal as {"t":"hist"} lines for the device.
+
+    Values are 0-100 as two hex digits per slot, "ff" for an empty slot.
+    `i` is the index of the chunk's first slot among `n`, oldest first; the
+    last slot is the one that just ended.
+    """
+    buckets = journal.downsample(slot_ms / 1000.0, slots)
+    if not any(buckets):
+        return []
+
+    def hx(vals) -> str:
+        return "".join("ff" if v is None else "%02x" % max(0, min(100, int(round(v)))) for v in vals)
+
+    lines = []
+    for i in range(0, slots, chunk):
+        part = buckets[i:i + chunk]
+        if not any(part):
+            continue
+        lines.append(
+            ('{"t":"hist","slot":%d,"i":%d,"n":%d,"cpu":"%s","cpux":"%s","ram":"%s"}\n' % (
+                slot_ms, i, slots,
+                hx(b and b[0] for b in part), hx(b and b[1] for b in part), hx(b and b[2] for b in part),
+            )).encode("ascii")
+        )
+    return lines
+
+
+def default_journal_path() -> str:
+    base = os.environ.get("XDG_CACHE_HOME") or os.path.join(os.path.expanduser("~"), ".cache")
+    return os.path.join(base, "smart_monitor", "journal.bin")
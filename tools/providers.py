@@ -0,0 +1,293 @@
+"""
+Slow or expensive payload sources that run beside the send loop (providers).
+
+Each provider owns a daemon thread, keeps its latest value in a cache and only
+publishes changes; PayloadBuilder.build() reads the cache and never waits on a
+provider. Rate limits are per provider (`period`), so a stuck one cannot delay
+the others or the serial sink.
+
+- FrontAppProvider (macOS): one long-lived `osascript` coprocess that polls the
+  frontmost app itself and prints a line only when it changes; restarted with
+  backoff if it dies. Replaces one `osascript` spawn per update.
+- TopProcessProvider (any OS, the Linux fallback for `app`): the process that
+  used the most CPU time since the previous poll, from psutil Process objects
+  kept across polls (only new PIDs are looked up). The same poll also yields
+  the few busiest processes for the device's "procs" page.
+
+Cost per provider (polls, errors, time spent, plus the coprocess's own CPU
+time) is reported in the --self-profile summary.
+"""
+from __future__ import annotations
+
+import os
+import platform
+import subprocess
+import threading
+import time
+from typing import Dict, List, Optional, Tuple
+
+import psutil
+
+try:
+    from self_profile import NullProfiler
+except Exception:
+    from tools.self_profile import NullProfiler  # type: ignore
+
+
+class Provider(threading.Thread):
+    """Polls `poll()` every `period` seconds in its own thread; `get()` returns the cached value."""
+
+    source = "provider"
+
+    def __init__(self, period: float, profiler=None):
+        super().__init__(daemon=True, name=f"provider:{self.source}")
+        self.period = max(0.1, period)
+        self.profiler = profiler or NullProfiler()
+        self.lock = threading.Lock()
+        self.value: Optional[str] = None
+        self.changes = 0
+        self.polls = 0
+        self.errors = 0
+        self.busy_s = 0.0      # wall time inside poll()
+        self.cpu_s = 0.0       # this thread's CPU time inside poll()
+        self.stop_event = threading.Event()
+
+    def get(self) -> Optional[str]:
+        with self.lock:
+            return self.value
+
+    def publish(self, value: Optional[str]) -> None:
+        with self.lock:
+            if value != self.value:
+                self.value = value
+                self.changes += 1
+
+    def poll(self) -> Optional[str]:
+        raise NotImplementedError
+
+    def run(self) -> None:
+        while not self.stop_event.is_set():
+            t, c = time.perf_counter(), time.thread_time()
+            try:
+                with self.profiler.section(f"provider:{self.source}"):
+                    value = self.poll()
+                self.publish(value)
+            except Exception:
+                self.errors += 1
+            self.busy_s += time.perf_counter() - t
+            self.cpu_s += time.thread_time() - c
+            self.polls += 1
+            self.stop_event.wait(self.period)
+
+    def stop(self) -> None:
+        self.stop_event.set()
+
+    def cost(self) -> Dict[str, float]:
+        return {"polls": self.polls, "changes": self.changes, "errors": self.errors,
+                "busy_s": round(self.busy_s, 4), "cpu_s": round(self.cpu_s, 4)}
+
+
+class TopProcessProvider(Provider):
+    """Name of the process with the most CPU time (user + system) since the previous poll."""
+
+    source = "top_process"
+
+    def __init__(self, period: float = 2.0, profiler=None, keep: int = 4):
+        super().__init__(period, profiler)
+        self.procs: Dict[int, psutil.Process] = {}
+        self.prev: Dict[int, float] = {}
+        self.own_pid = os.getpid()
+        self.keep = keep
+        self.top: List[Tuple[str, float]] = []  # (name, % of one core), busiest first
+        self.last_ts: Optional[float] = None
+
+    def top_processes(self) -> List[Tuple[str, float]]:
+        with self.lock:
+            return list(self.top)
+
+    def poll(self) -> Optional[str]:
+        now = time.monotonic()
+        wall = now - self.last_ts if self.last_ts is not None else 0.0
+        self.last_ts = now
+        pids = set(psutil.pids())
+        for pid in list(self.procs):
+            if pid not in pids:
+                del self.procs[pid]
+                self.prev.pop(pid, None)
+        busy = []
+        for pid in pids:
+            if pid == 0 or pid == self.own_pid:
+                continue  # idle task, and the bridge itself
+            p = self.procs.get(pid)
+            if p is None:
+                try:
+                    p = self.procs[pid] = psutil.Process(pid)
+                except psutil.Error:
+                    continue
+            try:
+                ct = p.cpu_times()
+            except psutil.Error:
+                continue
+            total = ct.user + ct.system
+            last = self.prev.get(pid)
+            self.prev[pid] = total
+            if last is not None and total > last:
+                busy.append((total - last, pid))
+        if not busy:
+            return self.value  # first poll, or nothing ran: keep the last name
+        busy.sort(reverse=True)
+        if wall > 0:
+            top = []
+            for dt, pid in busy[:self.keep]:
+                try:
+                    top.append((self.procs[pid].name(), round(100.0 * dt / wall, 1)))
+                except psutil.Error:
+                    pass
+            with self.lock:
+                self.top = top
+        try:
+            return self.procs[busy[0][1]].name() or None
+        except psutil.Error:
+            return None
+
+
+FRONT_APP_SCRIPT = '''
+set lastName to ""
+repeat
+    try
+        tell application "System Events" to set n to name of first application process whose frontmost is true
+    on error
+        set n to ""
+    end try
+    if n is not lastName then
+        log n
+        set lastName to n
+    end if
+    delay %s
+end repeat
+'''
+
+
+class FrontAppProvider(Provider):
+    """Frontmost app from one long-lived osascript that prints on change (to stderr, via `log`)."""
+
+    source = "front_app"
+    BACKOFF_MAX_S = 60.0
+
+    def __init__(self, period: float = 1.0, profiler=None):
+        super().__init__(period, profiler)
+        self.proc: Optional[subprocess.Popen] = None
+        self.spawns = 0
+        self.child_cpu_s = 0.0  # CPU of coprocesses that already exited
+
+    def run(self) -> None:
+        backoff = 1.0
+        while not self.stop_event.is_set():
+            try:
+                self.proc = subprocess.Popen(["osascript", "-e", FRONT_APP_SCRIPT % self.period],
+                                             stdin=subprocess.DEVNULL, stdout=subprocess.DEVNULL,
+                                             stderr=subprocess.PIPE, text=True, bufsize=1)
+                self.spawns += 1
+            except OSError:
+                self.errors += 1
+                self.stop_event.wait(backoff)
+                backoff = min(self.BACKOFF_MAX_S, backoff * 2)
+                continue
+            started = time.monotonic()
+            for line in self.proc.stderr:
+                t = time.perf_counter()
+                self.publish(line.strip() or None)
+                self.busy_s += time.perf_counter() - t
+                self.polls += 1
+                if self.stop_event.is_set():
+                    break
+            self._reap()
+            if time.monotonic() - started > self.BACKOFF_MAX_S:
+                backoff = 1.0  # ran fine for a while: restart promptly
+            else:
+                self.errors += 1
+                self.stop_event.wait(backoff)
+                backoff = min(self.BACKOFF_MAX_S, backoff * 2)
+
+    def _reap(self) -> None:
+        proc, self.proc = self.proc, None
+        if proc is None:
+            return
+        try:
+            proc.kill()
+        except OSError:
+            pass
+        try:
+            _, status, ru = os.wait4(proc.pid, 0)
+            proc.returncode = status
+            self.child_cpu_s += ru.ru_utime + ru.ru_stime
+        except (ChildProcessError, OSError):
+            proc.wait()
+
+    def stop(self) -> None:
+        super().stop()
+        proc = self.proc
+        if proc is not None:
+            try:
+                proc.kill()
+            except OSError:
+                pass
+
+    def cost(self) -> Dict[str, float]:
+        c = super().cost()
+        live = 0.0
+        proc = self.proc
+        if proc is not None:
+            try:
+                t = psutil.Process(proc.pid).cpu_times()
+                live = t.user + t.system
+            except psutil.Error:
+                pass
+        c["spawns"] = self.spawns
+        c["child_cpu_s"] = round(self.child_cpu_s + live, 4)
+        return c
+
+
+class Providers:
+    """The providers of one bridge: started together, read without blocking, costed together."""
+
+    def __init__(self):
+        self.items: Dict[str, Provider] = {}
+
+    def add(self, key: str, provider: Provider) -> None:
+        self.items[key] = provider
+        provider.start()
+
+    def get(self, key: str) -> Optional[str]:
+        p = self.items.get(key)
+        return p.get() if p is not None else None
+
+    def top_processes(self) -> List[Tuple[str, float]]:
+        p = self.items.get("procs")
+        return p.top_processes() if p is not None else []
+
+    def cost(self) -> Dict[str, Dict[str, float]]:
+        return {p.source: p.cost() for p in self.items.values()}
+
+    def stop(self) -> None:
+        for p in self.items.values():
+            p.stop()
+
+
+def make_providers(app_source: str = "auto", period: float = 2.0, profiler=None, procs: bool = False) -> Providers:
+    """app_source: frontmost (macOS coprocess), top (busiest process), auto (frontmost on macOS, else top), none.
+    procs: also keep the busiest processes (shares the `app` poller when it is the top-process one)."""
+    providers = Providers()
+    if app_source == "auto":
+        app_source = "frontmost" if platform.system() == "Darwin" else "top"
+    if app_source == "frontmost":
+        providers.add("app", FrontAppProvider(min(period, 1.0), profiler))
+    elif app_source == "top":
+        providers.add("app", TopProcessProvider(period, profiler))
+    if procs:
+        app = providers.items.get("app")
+        if isinstance(app, TopProcessProvider):
+            providers.items["procs"] = app
+        else:
+            providers.add("procs", TopProcessProvider(period, profiler))
+    return providers
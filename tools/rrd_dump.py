@@ -0,0 +1,140 @@
+#!/usr/bin/env python3
+# Bulk export of the device's flash history (include/rrd_store.h) to CSV.
+#   python tools/rrd_dump.py --tier 1m --since 6h --out last6h.csv
+#   python tools/rrd_dump.py --tier raw --from 1767225600 --to 1767229200 --port /dev/ttyACM0
+# Sends {"cmd":"dump",...} and decodes the hex pages that follow. The bridge
+# must not hold the serial port meanwhile.
+from __future__ import annotations
+import argparse
+import csv
+import struct
+import sys
+import time
+from datetime import datetime, timezone
+from typing import List, Optional
+
+import serial  # pyserial
+
+try:
+    from serial_utils import LineReader, autodetect_port
+except Exception:
+    from tools.serial_utils import LineReader, autodetect_port  # type: ignore
+
+NONE = -32768  # metric absent
+# Record layouts, little-endian, CRC16-CCITT over everything but the trailing crc
+RAW = struct.Struct("<I4hHH")    # t, v[4], reserved, crc
+AGG = struct.Struct("<IH12hH")   # t, n, min[4], avg[4], max[4], crc
+
+
+def crc16(data: bytes) -> int:
+    crc = 0xFFFF
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) & 0xFFFF if crc & 0x8000 else (crc << 1) & 0xFFFF
+    return crc
+
+
+def parse_duration(s: str) -> int:
+    """'90m', '6h', '2d', '3600' -> seconds."""
+    units = {"s": 1, "m": 60, "h": 3600, "d": 86400, "w": 604800}
+    s = s.strip().lower()
+    if s and s[-1] in units:
+        return int(float(s[:-1]) * units[s[-1]])
+    return int(s)
+
+
+def decode(tier: str, blob: bytes, metrics: List[str], scale: List[float]):
+    """(header, rows, bad_crc) for the raw bytes of one dump."""
+    layout = RAW if tier == "raw" else AGG
+    val = lambda m, v: "" if v == NONE else round(v / scale[m], 2)  # noqa: E731
+    if tier == "raw":
+        header = ["time", "utc"] + metrics
+    else:
+        header = ["time", "utc", "n"] + [f"{m}_{k}" for m in metrics for k in ("min", "avg", "max")]
+    rows, bad = [], 0
+    for off in range(0, len(blob) - layout.size + 1, layout.size):
+        rec = blob[off:off + layout.size]
+        f = layout.unpack(rec)
+        if crc16(rec[:-2]) != f[-1]:
+            bad += 1
+            continue
+        t = f[0]
+        row = [t, datetime.fromtimestamp(t, timezone.utc).strftime("%Y-%m-%d %H:%M:%S")]
+        if tier == "raw":
+            row += [val(m, f[1 + m]) for m in range(len(metrics))]
+        else:
+            n, mn, avg, mx = f[1], f[2:6], f[6:10], f[10:14]
+            row.append(n)
+            for m in range(len(metrics)):
+                row += [val(m, mn[m]), val(m, avg[m]), val(m, mx[m])]
+        rows.append(row)
+    return header, rows, bad
+
+
+def dump(ser, tier: str, t_from: int, t_to: Optional[int], timeout: float):
+    """Run one dump on an open port; returns (header msg, raw bytes)."""
+    cmd = f'{{"cmd":"dump","tier":"{tier}","from":{t_from}' + (f',"to":{t_to}' if t_to is not None else "") + "}\n"
+    reader = LineReader(on_text=lambda line: print(f"[rrd_dump] device: {line}", file=sys.stderr))
+    ser.reset_input_buffer()
+    ser.write(cmd.encode())
+    head, blob, last = None, bytearray(), time.time()
+    while time.time() - last < timeout:
+        msgs = reader.poll(ser)
+        if not msgs:
+            time.sleep(0.01)
+            continue
+        last = time.time()
+        for msg in msgs:
+            if msg.get("t") != "rrd":
+                continue  # telemetry, alerts, ...
+            if "err" in msg:
+                raise RuntimeError(f"device has no flash history ({msg['err']})")
+            if msg.get("k") != tier:
+                continue
+            if "rec" in msg:
+                head = msg
+            elif "r" in msg and head is not None:
+                blob += bytes.fromhex(msg["r"])
+            elif msg.get("end") and head is not None:
+                return head, bytes(blob)
+    raise TimeoutError("no end of dump from the device" if head else "no reply to the dump command")
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description="Export the device's flash history (raw / 1m / 15m tiers) to CSV")
+    parser.add_argument("--port", help="Serial port (default: autodetect)")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--tier", choices=("raw", "1m", "15m"), default="1m")
+    parser.add_argument("--from", dest="t_from", type=int, default=0, help="Start, epoch seconds")
+    parser.add_argument("--to", dest="t_to", type=int, help="End, epoch seconds (default: newest)")
+    parser.add_argument("--since", help="Start relative to now, e.g. 90m, 6h, 2d (overrides --from)")
+    parser.add_argument("--out", help="CSV file (default: stdout)")
+    parser.add_argument("--timeout", type=float, default=5.0, help="Give up after this many seconds without a line")
+    args = parser.parse_args()
+
+    port = args.port or autodetect_port()
+    if not port:
+        print("[rrd_dump] No serial port found", file=sys.stderr)
+        return 1
+    t_from = int(time.time()) - parse_duration(args.since) if args.since else args.t_from
+    with serial.Serial(port, args.baud, timeout=0) as ser:
+        head, blob = dump(ser, args.tier, t_from, args.t_to, args.timeout)
+    if head.get("rec") != (RAW.size if args.tier == "raw" else AGG.size):
+        print(f"[rrd_dump] Unknown record size {head.get('rec')}", file=sys.stderr)
+        return 1
+    header, rows, bad = decode(args.tier, blob, head["m"], [float(s) for s in head["scale"]])
+    out = open(args.out, "w", newline="") if args.out else sys.stdout
+    try:
+        w = csv.writer(out)
+        w.writerow(header)
+        w.writerows(rows)
+    finally:
+        if args.out:
+            out.close()
+    print(f"[rrd_dump] {args.tier}: {len(rows)} record(s), {len(blob)} bytes, {bad} bad CRC", file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,169 @@
+"""
+Bridge self-profiling (--self-profile).
+
+Tracks what the bridge itself costs on the host it is measuring:
+- process CPU time (all threads) as % of one core, against a budget
+- RSS
+- wakeups/s (voluntary + involuntary context switches)
+- syscalls/s (read/write-class, from /proc/self/io; Linux only)
+- wall time per named section (collectors, encoding, serial sink) per tick
+- cumulative counters from registered reporters (provider cost)
+
+A summary is printed every `interval` seconds and optionally appended as one
+JSON object per line to a log file.
+"""
+from __future__ import annotations
+
+import json
+import os
+import resource
+import threading
+import time
+from contextlib import contextmanager
+from typing import Dict, Optional
+
+
+class _NullSection:
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        return False
+
+
+class NullProfiler:
+    """Drop-in when profiling is off: sections cost one attribute lookup."""
+
+    _section = _NullSection()
+
+    def section(self, name: str):
+        return self._section
+
+    def tick(self) -> None:
+        pass
+
+    def add_reporter(self, name: str, fn) -> None:
+        pass
+
+
+def _rss_kb() -> int:
+    try:
+        with open("/proc/self/statm", "rb") as f:
+            return int(f.read().split()[1]) * os.sysconf("SC_PAGE_SIZE") // 1024
+    except OSError:
+        pass
+    try:
+        import psutil
+        return psutil.Process().memory_info().rss // 1024
+    except Exception:
+        return 0
+
+
+def _io_syscalls() -> Optional[int]:
+    try:
+        with open("/proc/self/io", "rb") as f:
+            v = dict(line.split(b":") for line in f.read().splitlines())
+        return int(v[b"syscr"]) + int(v[b"syscw"])
+    except (OSError, KeyError, ValueError):
+        return None
+
+
+class SelfProfiler:
+    def __init__(self, interval: float = 60.0, budget_pct: float = 0.2, log_path: Optional[str] = None,
+                 prefix: str = "[self-profile]"):
+        self.interval = interval
+        self.budget_pct = budget_pct
+        self.log_path = log_path
+        self.prefix = prefix
+        self.lock = threading.Lock()
+        self.sections: Dict[str, list] = {}   # name -> [total_s, calls]
+        self.reporters: Dict[str, object] = {}  # name -> fn() -> {item: {counter: value}}
+        self.ticks = 0
+        self._start_window()
+
+    def _start_window(self) -> None:
+        ru = resource.getrusage(resource.RUSAGE_SELF)
+        self.t0 = time.monotonic()
+        self.cpu0 = ru.ru_utime + ru.ru_stime
+        self.csw0 = ru.ru_nvcsw + ru.ru_nivcsw
+        self.sys0 = _io_syscalls()
+
+    @contextmanager
+    def section(self, name: str):
+        t = time.perf_counter()
+        try:
+            yield
+        finally:
+            dt = time.perf_counter() - t
+            with self.lock:
+                s = self.sections.get(name)
+                if s is None:
+                    self.sections[name] = [dt, 1]
+                else:
+                    s[0] += dt
+                    s[1] += 1
+
+    def add_reporter(self, name: str, fn) -> None:
+        """Extra cumulative counters printed with each summary (e.g. provider cost)."""
+        self.reporters[name] = fn
+
+    def tick(self) -> None:
+        """Call once per send-loop iteration; summarizes when the window is over."""
+        self.ticks += 1
+        now = time.monotonic()
+        if now - self.t0 >= self.interval:
+            self._summarize(now)
+
+    def _summarize(self, now: float) -> None:
+        ru = resource.getrusage(resource.RUSAGE_SELF)
+        wall = max(1e-6, now - self.t0)
+        cpu_pct = 100.0 * (ru.ru_utime + ru.ru_stime - self.cpu0) / wall
+        wakeups = (ru.ru_nvcsw + ru.ru_nivcsw - self.csw0) / wall
+        sys1 = _io_syscalls()
+        syscalls = (sys1 - self.sys0) / wall if sys1 is not None and self.sys0 is not None else None
+        with self.lock:
+            sections, self.sections = self.sections, {}
+        ticks, self.ticks = max(1, self.ticks), 0
+
+        over = cpu_pct > self.budget_pct
+        print(f"{self.prefix} {wall:.0f}s: cpu {cpu_pct:.3f}% of one core (budget {self.budget_pct:g}%) "
+              f"rss {_rss_kb() / 1024:.1f}MB wakeups {wakeups:.1f}/s"
+              + (f" syscalls {syscalls:.1f}/s" if syscalls is not None else ""), flush=True)
+        for name, (total, calls) in sorted(sections.items(), key=lambda kv: -kv[1][0]):
+            print(f"{self.prefix}   {name:<18} {1000.0 * total / ticks:8.3f} ms/tick "
+                  f"{1e6 * total / calls:9.1f} us/call  {calls / wall:6.1f} calls/s")
+        extra = {}
+        for name, fn in self.reporters.items():
+            try:
+                extra[name] = fn()
+            except Exception:
+                continue
+            for item, counters in extra[name].items():
+                print(f"{self.prefix}   {name}:{item} " + " ".join(f"{k} {v}" for k, v in counters.items()))
+        if over:
+            top = max(sections.items(), key=lambda kv: kv[1][0])[0] if sections else "?"
+            print(f"{self.prefix} WARNING: over budget ({cpu_pct:.3f}% > {self.budget_pct:g}%), "
+                  f"largest section: {top}", flush=True)
+
+        if self.log_path:
+            rec = {
+                "ts": time.time(), "wall_s": round(wall, 3), "cpu_pct": round(cpu_pct, 4),
+                "budget_pct": self.budget_pct, "over_budget": over, "rss_kb": _rss_kb(),
+                "wakeups_s": round(wakeups, 2), "syscalls_s": None if syscalls is None else round(syscalls, 2),
+                "ticks": ticks,
+                "sections": {k: {"ms_per_tick": round(1000.0 * v[0] / ticks, 4), "calls": v[1]}
+                             for k, v in sections.items()},
+            }
+            rec.update(extra)
+            try:
+                with open(self.log_path, "a") as f:
+                    f.write(json.dumps(rec, separators=(",", ":")) + "\n")
+            except OSError as e:
+                print(f"{self.prefix} cannot write {self.log_path}: {e}")
+        self._start_window()
+
+
+def make_profiler(args) -> "SelfProfiler | NullProfiler":
+    if not getattr(args, "self_profile", False):
+        return NullProfiler()
+    return SelfProfiler(args.self_profile_interval, args.self_profile_budget, args.self_profile_log)
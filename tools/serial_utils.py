@@ -1,4 +1,5 @@
 from __future__ import annotations
+import json
 from typing import Optional, List, Tuple
 
 from serial.tools import list_ports
@@ -73,3 +74,45 @@ def autodetect_port(preferred: Optional[str] = None) -> Optional[str]:
         # No strong hints; pick first
         return ports[0].device
     return best[1]
+
+
+class LineReader:
+    """Non-blocking reader for the device's line-delimited output.
+
+    poll() returns the JSON messages completed since the last call; other
+    lines (firmware logs such as "Erreur JSON: ...") go to `on_text` if set.
+    """
+
+    def __init__(self, max_line: int = 4096, on_text=None):
+        self.buf = bytearray()
+        self.max_line = max_line
+        self.on_text = on_text
+
+    def reset(self) -> None:
+        self.buf.clear()
+
+    def poll(self, ser) -> List[dict]:
+        try:
+            n = ser.in_waiting
+            if n:
+                self.buf += ser.read(n)
+        except Exception:
+            return []
+        msgs: List[dict] = []
+        while True:
+            nl = self.buf.find(b"\n")
+            if nl < 0:
+                if len(self.buf) > self.max_line:
+                    self.buf.clear()  # garbage without newline: resync
+                break
+            raw = bytes(self.buf[:nl]).strip()
+            del self.buf[:nl + 1]
+            if raw.startswith(b"{"):
+                try:
+                    msgs.append(json.loads(raw))
+                    continue
+                except ValueError:
+                    pass
+            if raw and self.on_text:
+                self.on_text(raw.decode("utf-8", "replace"))
+        return msgs
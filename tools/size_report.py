@@ -0,0 +1,375 @@
+# PlatformIO post-build script (extra_scripts = post:tools/size_report.py).
+# After each link, prints the flash/RAM used by the firmware and records it in
+# .pio/size_report.csv (one row per environment, i.e. per build profile), then
+# prints every recorded profile side by side.
+#   pio run -e esp32-c3-devkitm-1 -e high-fps -e low-power -e instrumented -e minimal-flash
+#
+# It also breaks the totals down and enforces budgets:
+# - per symbol and per subsystem (app, lib:<name>, arduino-core, idf:<lib>),
+#   from the linker map (-Wl,-Map is added here);
+# - stack per function from -fstack-usage (.su files). When the compiler also
+#   supports -fcallgraph-info (GCC >= 10), the worst case of setup()/loop() is
+#   followed through the call graph; otherwise only the largest frames are known.
+# - custom_budget_flash / custom_budget_ram / custom_budget_stack (bytes) in an
+#   environment of platformio.ini: the build fails when one is exceeded.
+# The full breakdown goes to .pio/size_<env>.json.
+#
+# Standalone, on an existing build:
+#   python tools/size_report.py --elf .pio/build/native/program --map .pio/build/native/program.map \
+#       --build-dir .pio/build/native [--budget-ram N ...]
+import argparse
+import csv
+import json
+import os
+import re
+import subprocess
+import sys
+import time
+
+# Generic ELF sections when the platform does not provide its own regexps (native)
+DEFAULT_PROG_RE = r"^(?:\.text|\.rodata|\.data|\.init_array|\.fini_array|\.eh_frame)\s+([0-9]+).*"
+DEFAULT_DATA_RE = r"^(?:\.data|\.bss|\.noinit)\s+([0-9]+).*"
+FIELDS = ["env", "profile", "flash", "ram", "stack", "updated"]
+
+# Output sections of the map, by what they cost (names of GNU ld and of the ESP-IDF linker scripts)
+MAP_RAM_ONLY = re.compile(r"bss|noinit")                      # zeroed at boot: RAM only
+MAP_RAM_AND_FLASH = re.compile(r"^\.(?:s?data|tdata)|iram|dram0\.data|rtc\.data")  # copied from flash to RAM
+MAP_FLASH = re.compile(r"text|rodata|init_array|fini_array|eh_frame|gcc_except_table|^\.flash")
+SECTION_PREFIX = re.compile(r"^\.(?:text|literal|rodata|data|sdata|bss|sbss|srodata|tbss|tdata|iram1|dram1|gcc_except_table)\."
+                            r"(?:(?:unlikely|hot|startup|exit)\.)?")
+ENTRY_POINTS = ("setup", "loop")
+TOP = 12
+
+
+def _sum(regexp: str, text: str) -> int:
+    rx = re.compile(regexp, re.M)
+    return sum(int(m.group(1)) for m in rx.finditer(text))
+
+
+def _profile(env) -> str:
+    for d in env.get("CPPDEFINES", []):
+        if isinstance(d, (list, tuple)) and d and d[0] == "SMON_PROFILE":
+            return str(d[1])
+    return "0"
+
+
+# ------------------------------------------------------------------ linker map
+
+def subsystem(obj: str) -> str:
+    """'.pio/build/x/src/main.cpp.o' -> 'app', 'libFrameworkArduino.a(..)' -> 'arduino-core', ..."""
+    obj = obj.replace("\\", "/")
+    m = re.match(r"^(.*?)([^/]+)\.a\((.*)\)$", obj)
+    if m:
+        name = m.group(2)[3:] if m.group(2).startswith("lib") else m.group(2)
+        if name == "FrameworkArduino":
+            return "arduino-core"
+        if "/sdk/" in m.group(1) or "esp-idf" in m.group(1) or "framework-" in m.group(1):
+            return "idf:" + name
+        return "lib:" + name
+    if "/src/" in obj or obj.startswith("src/"):
+        return "app"
+    m = re.search(r"/lib[0-9a-f]*/([^/]+)/", obj)
+    if m:
+        return "lib:" + m.group(1)
+    if obj.startswith("/usr/") or "/toolchain-" in obj:
+        return "toolchain"
+    return os.path.basename(obj)
+
+
+def parse_map(path: str) -> list:
+    """[(symbol, subsystem, flash_bytes, ram_bytes)] per input section of the allocated output sections."""
+    out = []
+    with open(path, "r", errors="replace") as f:
+        lines = f.read().splitlines()
+    try:
+        start = lines.index("Linker script and memory map") + 1
+    except ValueError:
+        return out
+    section, pending = None, None
+    cost = (0, 0)
+    for line in lines[start:]:
+        if line and not line[0].isspace():
+            # Output section: ".text   0x... 0x..." or name alone
+            section = line.split()[0]
+            if MAP_RAM_ONLY.search(section):
+                cost = (0, 1)
+            elif MAP_RAM_AND_FLASH.search(section):
+                cost = (1, 1)
+            elif MAP_FLASH.search(section):
+                cost = (1, 0)
+            else:
+                cost = (0, 0)
+            pending = None
+            continue
+        if cost == (0, 0):
+            continue
+        m = re.match(r"^ (\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(.+)$", line)
+        if m is None and pending is not None:
+            m2 = re.match(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(.+)$", line)
+            if m2:
+                m = (pending, m2.group(1), m2.group(2), m2.group(3))
+        elif m is not None:
+            m = m.groups()
+        if m is None:
+            n = re.match(r"^ (\.\S+|COMMON)$", line)
+            pending = n.group(1) if n else None
+            continue
+        pending = None
+        name, size, obj = m[0], int(m[2], 16), m[3].strip()
+        if size == 0 or name == "*fill*":
+            continue
+        sym = SECTION_PREFIX.sub("", name)
+        if sym == name:  # section without -ffunction-sections: one entry per object
+            sym = f"{name} ({os.path.basename(obj)})"
+        out.append((sym, subsystem(obj), size * cost[0], size * cost[1]))
+    return out
+
+
+def demangle(names: list, tool: str) -> dict:
+    mangled = [n for n in names if n.startswith("_Z")]
+    if not mangled:
+        return {}
+    try:
+        r = subprocess.run([tool], input="\n".join(mangled), capture_output=True, text=True, check=True)
+        return dict(zip(mangled, r.stdout.splitlines()))
+    except (OSError, subprocess.CalledProcessError):
+        return {}
+
+
+# ------------------------------------------------------------------ stack
+
+def parse_su(build_dir: str) -> dict:
+    """{function: (bytes, qualifier)} from every .su file (largest frame per name)."""
+    frames = {}
+    for root, _, files in os.walk(build_dir):
+        for fn in files:
+            if not fn.endswith(".su"):
+                continue
+            with open(os.path.join(root, fn), errors="replace") as f:
+                for line in f:
+                    parts = line.rstrip("\n").split("\t")
+                    if len(parts) != 3:
+                        continue
+                    name = parts[0].split(":", 3)[-1]
+                    size = int(parts[1])
+                    if size > frames.get(name, (-1, ""))[0]:
+                        frames[name] = (size, parts[2])
+    return frames
+
+
+def parse_callgraph(build_dir: str) -> tuple:
+    """Nodes {title: (label, bytes|None, dynamic)} and edges {title: {callee titles}} from .ci files."""
+    nodes, edges = {}, {}
+    node_re = re.compile(r'^node: \{ title: "([^"]+)" label: "([^"]*)"')
+    edge_re = re.compile(r'^edge: \{ sourcename: "([^"]+)" targetname: "([^"]+)"')
+    for root, _, files in os.walk(build_dir):
+        for fn in files:
+            if not fn.endswith(".ci"):
+                continue
+            with open(os.path.join(root, fn), errors="replace") as f:
+                for line in f:
+                    m = node_re.match(line)
+                    if m:
+                        label = m.group(2).split("\\n")
+                        b = re.match(r"(\d+) bytes \((\w[\w,]*)\)", label[-1])
+                        prev = nodes.get(m.group(1))
+                        if b or prev is None:
+                            nodes[m.group(1)] = (label[0], int(b.group(1)) if b else None,
+                                                 bool(b and "dynamic" in b.group(2) and "bounded" not in b.group(2)))
+                        continue
+                    m = edge_re.match(line)
+                    if m:
+                        edges.setdefault(m.group(1), set()).add(m.group(2))
+    return nodes, edges
+
+
+def worst_stack(nodes: dict, edges: dict, root: str, memo: dict, active: set) -> tuple:
+    """(bytes, path, caveats) of the deepest call chain from root; recursion and indirect calls are cut."""
+    if root in memo:
+        return memo[root]
+    label, size, dynamic = nodes.get(root, (root, None, False))
+    caveats = set()
+    if size is None:
+        caveats.add("unknown" if root != "__indirect_call" else "indirect")
+    if dynamic:
+        caveats.add("dynamic")
+    active.add(root)
+    best = (0, [], set())
+    for callee in edges.get(root, ()):
+        if callee in active:
+            caveats.add("recursion")
+            continue
+        sub = worst_stack(nodes, edges, callee, memo, active)
+        if sub[0] > best[0]:
+            best = sub
+        caveats |= sub[2]
+    active.discard(root)
+    memo[root] = ((size or 0) + best[0], [label] + best[1], caveats)
+    return memo[root]
+
+
+def stack_report(build_dir: str) -> dict:
+    nodes, edges = parse_callgraph(build_dir)
+    frames = parse_su(build_dir)
+    top = sorted(frames.items(), key=lambda kv: -kv[1][0])[:TOP]
+    rep = {"frames": [{"function": n, "bytes": b, "kind": q} for n, (b, q) in top]}
+    if nodes:
+        memo = {}
+        roots = [t for t, (label, _, _) in nodes.items() if label.split("(")[0].split()[-1] in ENTRY_POINTS]
+        chains = [worst_stack(nodes, edges, t, memo, set()) for t in roots]
+        rep["chains"] = [{"bytes": b, "path": p, "caveats": sorted(c)} for b, p, c in sorted(chains, key=lambda c: -c[0])]
+        rep["worst"] = rep["chains"][0]["bytes"] if rep["chains"] else 0
+        rep["method"] = "call graph"
+    else:
+        rep["worst"] = top[0][1][0] if top else 0
+        rep["method"] = "largest frame (no -fcallgraph-info)"
+    return rep
+
+
+# ------------------------------------------------------------------ report
+
+def breakdown(map_path: str, cxxfilt: str) -> dict:
+    entries = parse_map(map_path) if map_path and os.path.exists(map_path) else []
+    names = demangle(sorted({e[0] for e in entries}), cxxfilt)
+    subs, syms = {}, {}
+    for sym, sub, flash, ram in entries:
+        s = subs.setdefault(sub, [0, 0])
+        s[0] += flash
+        s[1] += ram
+        k = (names.get(sym, sym), sub)
+        v = syms.setdefault(k, [0, 0])
+        v[0] += flash
+        v[1] += ram
+    return {
+        "subsystems": {k: {"flash": v[0], "ram": v[1]} for k, v in sorted(subs.items(), key=lambda kv: -kv[1][0])},
+        "symbols": [{"symbol": k[0], "subsystem": k[1], "flash": v[0], "ram": v[1]}
+                    for k, v in sorted(syms.items(), key=lambda kv: -(kv[1][0] + kv[1][1]))][:200],
+    }
+
+
+def print_breakdown(name: str, detail: dict, stack: dict) -> None:
+    print(f"[size] {name}: by subsystem (flash / RAM)")
+    for sub, v in list(detail["subsystems"].items())[:TOP]:
+        print(f"[size]   {sub:<28} {v['flash']:>9} {v['ram']:>8}")
+    for col in ("ram", "flash"):
+        print(f"[size] {name}: largest symbols ({col})")
+        for s in sorted(detail["symbols"], key=lambda s: -s[col])[:TOP]:
+            if s[col]:
+                print(f"[size]   {s[col]:>8}  {s['symbol'][:70]}  [{s['subsystem']}]")
+    print(f"[size] {name}: worst stack {stack['worst']} B ({stack['method']})")
+    for c in stack.get("chains", [])[:2]:
+        print(f"[size]   {c['bytes']:>6} B  " + " -> ".join(p.split("(")[0].split()[-1] for p in c["path"][:8])
+              + (f"  ({', '.join(c['caveats'])})" if c["caveats"] else ""))
+    for fr in stack["frames"][:6]:
+        print(f"[size]   frame {fr['bytes']:>5} B  {fr['function'][:70]} ({fr['kind']})")
+
+
+def check_budgets(name: str, budgets: dict, measured: dict) -> list:
+    failures = []
+    for key, limit in budgets.items():
+        if limit and measured[key] > limit:
+            failures.append(f"{key} {measured[key]} B > budget {limit} B")
+    for f in failures:
+        print(f"[size] {name}: OVER BUDGET: {f}")
+    return failures
+
+
+def record(project_dir: str, name: str, profile: str, flash: int, ram: int, stack: int) -> None:
+    path = os.path.join(project_dir, ".pio", "size_report.csv")
+    rows = {}
+    if os.path.exists(path):
+        with open(path, newline="") as f:
+            rows = {r["env"]: r for r in csv.DictReader(f)}
+    prev = rows.get(name)
+    if prev is not None:
+        print(f"[size] {name}: {flash - int(prev['flash']):+d} B flash, {ram - int(prev['ram']):+d} B RAM since the last build")
+    rows[name] = {"env": name, "profile": profile, "flash": flash, "ram": ram, "stack": stack,
+                  "updated": time.strftime("%Y-%m-%d %H:%M:%S")}
+    os.makedirs(os.path.dirname(path), exist_ok=True)
+    with open(path, "w", newline="") as f:
+        w = csv.DictWriter(f, fieldnames=FIELDS)
+        w.writeheader()
+        w.writerows(rows.values())
+
+    base = rows.get("esp32-c3-devkitm-1")
+    print(f"[size] {'env':<20} {'profile':>7} {'flash':>9} {'ram':>8} {'stack':>6}   (vs default profile)")
+    for r in sorted(rows.values(), key=lambda r: r["env"]):
+        delta = ""
+        if base is not None and r is not base and r["env"] != "native":
+            delta = f"   {int(r['flash']) - int(base['flash']):+d} / {int(r['ram']) - int(base['ram']):+d}"
+        print(f"[size] {r['env']:<20} {r['profile']:>7} {int(r['flash']):>9} {int(r['ram']):>8} {r.get('stack') or '?':>6}{delta}")
+
+
+def analyze(elf: str, map_path: str, build_dir: str, size_tool: str, cxxfilt: str,
+            prog_re: str = DEFAULT_PROG_RE, data_re: str = DEFAULT_DATA_RE) -> tuple:
+    out = subprocess.run([size_tool, "-A", "-d", elf], capture_output=True, text=True, check=True).stdout
+    totals = {"flash": _sum(prog_re, out), "ram": _sum(data_re, out)}
+    detail = breakdown(map_path, cxxfilt)
+    stack = stack_report(build_dir)
+    totals["stack"] = stack["worst"]
+    return totals, detail, stack
+
+
+def report(source, target, env):
+    elf = str(target[0])
+    tool = env.subst("$SIZETOOL") or "size"
+    cxxfilt = re.sub(r"size$", "c++filt", tool) if tool.endswith("size") else "c++filt"
+    name = env["PIOENV"]
+    try:
+        totals, detail, stack = analyze(elf, env.subst(MAP_PATH), env.subst("$BUILD_DIR"), tool, cxxfilt,
+                                        env.get("SIZEPROGREGEXP") or DEFAULT_PROG_RE,
+                                        env.get("SIZEDATAREGEXP") or DEFAULT_DATA_RE)
+    except (OSError, subprocess.CalledProcessError) as e:
+        print(f"[size] cannot run {tool}: {e}")
+        return 0
+    print(f"[size] {name}: flash {totals['flash']} B, static RAM {totals['ram']} B, worst stack {totals['stack']} B")
+    print_breakdown(name, detail, stack)
+    project_dir = env.subst("$PROJECT_DIR")
+    with open(os.path.join(project_dir, ".pio", f"size_{name}.json"), "w") as f:
+        json.dump({"env": name, **totals, **detail, "stack": stack}, f, indent=1)
+    record(project_dir, name, _profile(env), totals["flash"], totals["ram"], totals["stack"])
+    budgets = {k: int(env.GetProjectOption(f"custom_budget_{k}", "0") or 0) for k in ("flash", "ram", "stack")}
+    return 1 if check_budgets(name, budgets, totals) else 0
+
+
+def main() -> int:
+    ap = argparse.ArgumentParser(description="Flash/RAM/stack breakdown of a linked firmware")
+    ap.add_argument("--elf", required=True)
+    ap.add_argument("--map", help="linker map (-Wl,-Map)")
+    ap.add_argument("--build-dir", default=".", help="where the .su/.ci files are")
+    ap.add_argument("--size-tool", default="size")
+    ap.add_argument("--cxxfilt", default="c++filt")
+    for k in ("flash", "ram", "stack"):
+        ap.add_argument(f"--budget-{k}", type=int, default=0)
+    ap.add_argument("--json", help="also write the breakdown here")
+    args = ap.parse_args()
+    totals, detail, stack = analyze(args.elf, args.map, args.build_dir, args.size_tool, args.cxxfilt)
+    name = os.path.basename(args.elf)
+    print(f"[size] {name}: flash {totals['flash']} B, static RAM {totals['ram']} B, worst stack {totals['stack']} B")
+    print_breakdown(name, detail, stack)
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump({**totals, **detail, "stack": stack}, f, indent=1)
+    budgets = {"flash": args.budget_flash, "ram": args.budget_ram, "stack": args.budget_stack}
+    return 1 if check_budgets(name, budgets, totals) else 0
+
+
+MAP_PATH = "$BUILD_DIR/${PROGNAME}.map"
+
+try:
+    Import("env")  # noqa: F821  (PlatformIO post-build script)
+except NameError:
+    if __name__ == "__main__":
+        sys.exit(main())
+else:
+    # Map file and per-function stack for every build; the call graph needs GCC >= 10
+    env.Append(LINKFLAGS=["-Wl,-Map," + MAP_PATH], CCFLAGS=["-fstack-usage"])  # noqa: F821
+    if env.get("PIOPLATFORM") == "native":  # noqa: F821
+        env.Append(CCFLAGS=["-ffunction-sections", "-fdata-sections"])  # noqa: F821
+    try:
+        ver = subprocess.run([env.subst("$CC"), "-dumpversion"], capture_output=True, text=True).stdout  # noqa: F821
+        if int(ver.split(".")[0]) >= 10:
+            env.Append(CCFLAGS=["-fcallgraph-info=su"])  # noqa: F821
+    except (OSError, ValueError):
+        pass
+    env.AddPostAction("$PROG_PATH", report)  # noqa: F821
@@ -0,0 +1,343 @@
+"""
+Soak / saturation harness for Smart Monitor.
+
+Drives the firmware (native build over a pty, or a real board) with synthetic
+payloads and reads back its {"t":"stat"} telemetry lines to report:
+- lines/sec offered, sent, accepted and dropped
+- render cost and frame interval percentiles under load
+- heap (and RSS on the native build) growth over time
+
+Entry point is run_soak(args), called by host_bridge.py --soak.
+"""
+from __future__ import annotations
+
+import csv
+import json
+import os
+import random
+import selectors
+import string
+import subprocess
+import threading
+import time
+from dataclasses import dataclass, field
+from typing import List, Optional, Tuple
+
+import serial  # pyserial
+
+ALL_FIELDS = ("cpu", "ram", "disk", "net", "weather", "app", "host", "time", "uptime", "disks", "nics")
+# Arrays sized past the firmware's capacity (4) and ids past its length (8) on purpose
+LIST_SIZES = (1, 2, 4, 6)
+MOUNT_IDS = ("/", "home", "data", "backup", "scratch", "containers", "C:", "media")
+NIC_IDS = ("eth0", "wlan0", "enp0s31f6", "docker0", "tailscale0", "en0", "utun3", "bond0")
+
+APP_WORDS = (
+    "Code", "Safari", "Terminal", "Slack", "Xcode", "Finder", "Chrome", "Mail",
+    "Electron", "Preview", "Music", "Docker", "Notes", "Zoom", "Figma", "iTerm2",
+)
+
+
+def spawn_native(binary: str, verbose: bool = False) -> Tuple[subprocess.Popen, str]:
+    """Start the native firmware build and return (process, pty path)."""
+    proc = subprocess.Popen([binary], stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+    assert proc.stdout is not None
+    fd = proc.stdout.fileno()
+    buf = b""
+    deadline = time.monotonic() + 10.0
+    with selectors.DefaultSelector() as sel:
+        sel.register(fd, selectors.EVENT_READ)
+        # Non-blocking wait: a binary that hangs before its PTY line must not hang us
+        while time.monotonic() < deadline:
+            if not sel.select(deadline - time.monotonic()):
+                continue
+            chunk = os.read(fd, 4096)
+            if not chunk:
+                break
+            buf += chunk
+            while b"\n" in buf:
+                raw, buf = buf.split(b"\n", 1)
+                line = raw.decode("utf-8", "replace").strip()
+                if verbose:
+                    print(f"[soak] native: {line}")
+                if line.startswith("PTY "):
+                    # Keep the pipe drained: a full one would block the firmware mid-soak
+                    threading.Thread(target=_drain, args=(fd, verbose), daemon=True).start()
+                    return proc, line[4:].strip()
+    proc.kill()
+    raise RuntimeError(f"native build {binary} did not announce its pty")
+
+
+def _drain(fd: int, verbose: bool) -> None:
+    """Read the native build's output until it exits, echoing it when verbose."""
+    while True:
+        try:
+            chunk = os.read(fd, 4096)
+        except OSError:
+            return
+        if not chunk:
+            return
+        if verbose:
+            for line in chunk.decode("utf-8", "replace").splitlines():
+                print(f"[soak] native: {line}")
+
+
+class SyntheticLoad:
+    """Generates payload lines with a configurable field mix and target size."""
+
+    def __init__(self, fields: List[str], size: int = 0, seed: Optional[int] = None):
+        unknown = [f for f in fields if f not in ALL_FIELDS]
+        if unknown:
+            raise ValueError(f"unknown soak fields: {', '.join(unknown)}")
+        self.fields = fields
+        self.size = size
+        self.rng = random.Random(seed)
+        self.t0 = time.time()
+        self.cpu = 20.0
+
+    def _app_name(self) -> str:
+        name = self.rng.choice(APP_WORDS)
+        # Random suffix so the firmware sees a stream of distinct strings
+        if self.rng.random() < 0.5:
+            name += " " + "".join(self.rng.choices(string.ascii_letters + string.digits, k=self.rng.randint(1, 24)))
+        return name
+
+    def next_line(self) -> bytes:
+        r = self.rng
+        self.cpu = min(100.0, max(0.0, self.cpu + r.uniform(-15, 15)))
+        p: dict = {}
+        if "cpu" in self.fields:
+            p["cpu"] = round(self.cpu, 1)
+        if "ram" in self.fields:
+            total = 16 * 1024 * 1024
+            p["ram"] = total
+            p["ram_used"] = int(total * r.uniform(0.2, 0.95))
+        if "weather" in self.fields:
+            p["weather"] = {"temp": round(r.uniform(-10, 35), 1), "desc": "Couvert", "wcode": 3}
+        if "host" in self.fields:
+            p["host"] = "soak-host"
+        if "time" in self.fields:
+            p["time"] = int(time.time())
+        if "uptime" in self.fields:
+            p["uptime"] = int(time.time() - self.t0)
+        if "disk" in self.fields:
+            p["disk_free"] = r.randint(0, 512 * 1024 * 1024)
+        if "net" in self.fields:
+            p["net"] = {"rx": round(r.expovariate(1 / 200.0), 1), "tx": round(r.expovariate(1 / 50.0), 1)}
+        if "disks" in self.fields:
+            p["disks"] = [{"id": i, "free": r.randint(0, 4 << 20), "size": 4 << 20}
+                          for i in r.sample(MOUNT_IDS, r.choice(LIST_SIZES))]
+        if "nics" in self.fields:
+            p["nics"] = [{"id": i, "rx": round(r.expovariate(1 / 200.0), 1), "tx": round(r.expovariate(1 / 50.0), 1)}
+                         for i in r.sample(NIC_IDS, r.choice(LIST_SIZES))]
+        if "app" in self.fields:
+            p["app"] = self._app_name()
+        line = json.dumps(p, separators=(",", ":"))
+        if self.size and len(line) + 1 < self.size:
+            # Unknown key: parsed and ignored by the firmware, only costs bytes
+            pad = self.size - len(line) - len(',"pad":""') - 1
+            if pad > 0:
+                line = line[:-1] + ',"pad":"' + "x" * pad + '"}'
+        return (line + "\n").encode("utf-8")
+
+
+def parse_burst(spec: Optional[str]) -> Tuple[int, float]:
+    """'50@10' -> 50 extra lines back-to-back every 10 seconds."""
+    if not spec:
+        return 0, 0.0
+    count, _, period = spec.partition("@")
+    return int(count), float(period or 10)
+
+
+@dataclass
+class SoakStats:
+    offered: int = 0
+    sent: int = 0
+    skipped: int = 0          # dropped host-side: schedule fell > 1 s behind
+    tele: List[dict] = field(default_factory=list)
+    lock: threading.Lock = field(default_factory=threading.Lock)
+
+    def last_tele(self) -> Optional[dict]:
+        with self.lock:
+            return self.tele[-1] if self.tele else None
+
+
+def _reader(ser: serial.Serial, stats: SoakStats, stop: threading.Event, verbose: bool) -> None:
+    while not stop.is_set():
+        try:
+            raw = ser.readline()
+        except Exception:
+            break
+        if not raw:
+            continue
+        text = raw.decode("utf-8", "replace").strip()
+        if text.startswith("{"):
+            try:
+                msg = json.loads(text)
+            except ValueError:
+                continue
+            if msg.get("t") == "stat":
+                msg["host_ts"] = time.time()
+                with stats.lock:
+                    stats.tele.append(msg)
+                continue
+        if verbose and text:
+            print(f"[soak] device: {text}")
+
+
+def _slope_per_hour(points: List[Tuple[float, float]]) -> float:
+    """Least-squares slope of (seconds, value) samples, per hour."""
+    n = len(points)
+    if n < 2:
+        return 0.0
+    mx = sum(p[0] for p in points) / n
+    my = sum(p[1] for p in points) / n
+    den = sum((p[0] - mx) ** 2 for p in points)
+    if den <= 0:
+        return 0.0
+    return sum((p[0] - mx) * (p[1] - my) for p in points) / den * 3600.0
+
+
+def _report(stats: SoakStats, prev: dict, elapsed: float, dt: float, writer) -> dict:
+    t = stats.last_tele() or {}
+    ok, bad, ovf = t.get("ok", 0), t.get("bad", 0), t.get("ovf", 0)
+    sk = t.get("sk", 0)  # superseded by a newer snapshot on the device: coalesced, not lost
+    sent, offered, skipped = stats.sent, stats.offered, stats.skipped
+    d = lambda k, v: (v - prev.get(k, 0)) / dt if dt > 0 else 0.0  # noqa: E731
+    backlog = max(0, sent - ok - bad - ovf - sk)
+    print(
+        f"[soak] t={elapsed:7.0f}s offered={d('offered', offered):7.1f}/s sent={d('sent', sent):7.1f}/s "
+        f"ok={d('ok', ok):7.1f}/s drop={d('drop', bad + ovf + skipped):6.1f}/s "
+        f"coalesced={d('sk', sk):6.1f}/s backlog={backlog:5d} "
+        f"render p50/p95/p99={t.get('r50', 0)}/{t.get('r95', 0)}/{t.get('r99', 0)}us "
+        f"frame p95/p99/max={t.get('i95', 0) / 1000:.0f}/{t.get('i99', 0) / 1000:.0f}/{t.get('imax', 0) / 1000:.0f}ms "
+        f"heap={t.get('heap', 0)}B" + (f" rss={t['rss']}KB" if "rss" in t else ""),
+        flush=True,
+    )
+    if writer is not None:
+        writer.writerow([
+            round(elapsed, 1), offered, sent, skipped, ok, bad, ovf, sk, backlog,
+            t.get("r50", 0), t.get("r95", 0), t.get("r99", 0),
+            t.get("i50", 0), t.get("i95", 0), t.get("i99", 0), t.get("imax", 0),
+            t.get("heap", 0), t.get("rss", t.get("heapPeak", 0)),
+        ])
+    return {"offered": offered, "sent": sent, "ok": ok, "drop": bad + ovf + skipped, "sk": sk}
+
+
+def _summary(stats: SoakStats, elapsed: float) -> None:
+    with stats.lock:
+        tele = list(stats.tele)
+    if not tele:
+        print("[soak] no telemetry received: is the firmware built with SMON_INSTRUMENT=1?")
+        return
+    last = tele[-1]
+    ok, bad, ovf, sk = last.get("ok", 0), last.get("bad", 0), last.get("ovf", 0), last.get("sk", 0)
+    dropped = max(0, stats.sent - ok - sk) + stats.skipped
+    print(f"[soak] ---- summary after {elapsed:.0f}s ----")
+    print(f"[soak] offered={stats.offered} sent={stats.sent} accepted={ok} "
+          f"coalesced={sk} dropped={dropped} (parse={bad} overflow={ovf} host-skipped={stats.skipped})")
+    print(f"[soak] accepted rate={ok / max(elapsed, 1e-6):.1f} lines/s, "
+          f"drop ratio={dropped / max(stats.offered, 1):.2%}")
+    if any(last.get(k) for k in ("trd", "trn", "tri")):
+        print(f"[soak] truncated (firmware capacity): disks={last.get('trd', 0)} nics={last.get('trn', 0)} "
+              f"ids={last.get('tri', 0)}")
+    for key, label in (("r99", "render p99"), ("i99", "frame interval p99"), ("imax", "frame interval max")):
+        vals = sorted(t.get(key, 0) for t in tele)
+        print(f"[soak] {label}: median window={vals[len(vals) // 2]}us worst window={vals[-1]}us")
+    # Skip the first windows: allocator warm-up is not a leak
+    warm = tele[min(len(tele) - 1, 5):]
+    t0 = warm[0]["host_ts"]
+    heap_slope = _slope_per_hour([(t["host_ts"] - t0, t.get("heap", 0)) for t in warm])
+    print(f"[soak] heap {warm[0].get('heap', 0)} -> {last.get('heap', 0)} B "
+          f"(trend {heap_slope:+.0f} B/h)")
+    if "rss" in last:
+        rss_slope = _slope_per_hour([(t["host_ts"] - t0, t.get("rss", 0)) for t in warm])
+        print(f"[soak] rss {warm[0].get('rss', 0)} -> {last['rss']} KB (trend {rss_slope:+.1f} KB/h)")
+
+
+def run_soak(args) -> int:
+    proc = None
+    port = args.port
+    if args.soak_native:
+        proc, port = spawn_native(args.soak_native, args.verbose)
+        print(f"[soak] native build on {port}")
+    if not port:
+        print("[soak] --port or --soak-native is required")
+        return 2
+
+    fields = [f.strip() for f in args.soak_fields.split(",") if f.strip()]
+    load = SyntheticLoad(fields, size=args.soak_size, seed=args.soak_seed)
+    burst_n, burst_period = parse_burst(args.soak_burst)
+    stats = SoakStats()
+    stop = threading.Event()
+
+    ser = serial.Serial(port, args.baud, timeout=0.2)
+    ser.write(b'{"cmd":"telemetry","ms":1000}\n')
+    reader = threading.Thread(target=_reader, args=(ser, stats, stop, args.verbose), daemon=True)
+    reader.start()
+
+    csv_file = open(args.soak_csv, "w", newline="") if args.soak_csv else None
+    writer = csv.writer(csv_file) if csv_file else None
+    if writer:
+        writer.writerow(["elapsed_s", "offered", "sent", "host_skipped", "accepted", "parse_err", "overflow",
+                         "coalesced", "backlog", "render_p50_us", "render_p95_us", "render_p99_us", "frame_p50_us",
+                         "frame_p95_us", "frame_p99_us", "frame_max_us", "heap_b", "rss_kb_or_heap_peak_b"])
+
+    period = 1.0 / args.soak_rate if args.soak_rate > 0 else 0.0
+    start = time.time()
+    next_send = start
+    next_burst = start + burst_period if burst_n else float("inf")
+    next_report = start + args.soak_report
+    last_report = start
+    prev: dict = {}
+    try:
+        while args.soak_duration <= 0 or time.time() - start < args.soak_duration:
+            now = time.time()
+            if proc is not None and proc.poll() is not None:
+                print(f"[soak] native build exited with code {proc.returncode}")
+                break
+            count = 1
+            if now >= next_burst:
+                count += burst_n
+                next_burst += burst_period
+            if period > 0:
+                # Behind schedule by more than a second: drop instead of catching up
+                behind = int((now - next_send) / period) if now > next_send + 1.0 else 0
+                if behind:
+                    stats.offered += behind
+                    stats.skipped += behind
+                    next_send += behind * period
+            for _ in range(count):
+                stats.offered += 1
+                ser.write(load.next_line())
+                stats.sent += 1
+            if now >= next_report:
+                prev = _report(stats, prev, now - start, now - last_report, writer)
+                last_report, next_report = now, next_report + args.soak_report
+                if csv_file:
+                    csv_file.flush()
+            if period > 0:
+                next_send += period
+                delay = next_send - time.time()
+                if delay > 0:
+                    time.sleep(delay)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        time.sleep(1.5)  # let in-flight lines drain and one more stat arrive
+        _summary(stats, time.time() - start)
+        stop.set()
+        try:
+            ser.write(b'{"cmd":"telemetry","ms":0}\n')
+            ser.close()
+        except Exception:
+            pass
+        if csv_file:
+            csv_file.close()
+        if proc is not None:
+            proc.terminate()
+            try:
+                proc.wait(timeout=3)
+            except subprocess.TimeoutExpired:
+                proc.kill()
+    return 0
+
@@ -9,12 +9,8 @@ Smart Monitor Tray App (macOS)
 
 import threading
 import time
-import socket
 import json
-import psutil
-import requests
 import serial
-import platform
 
 import rumps  # type: ignore
 
@@ -22,11 +18,7 @@ import rumps  # type: ignore
 # Import bridge helpers from host_bridge.py
 from host_bridge import (
 	autodetect_port,
-	get_system_stats,
-	get_disk_free_kb,
-	get_active_app_name_macos,
-	get_weather,
-	Weather,
+	PayloadBuilder,
 )
 
 
@@ -41,10 +33,7 @@ class BridgeThread(threading.Thread):
 		self.stop_flag = False
 		self.preferred_port: str | None = None
 		self.ser: serial.Serial | None = None
-		self.last_weather: Weather | None = None
-		self.last_weather_ts: float = 0.0
-		self.last_net = psutil.net_io_counters()
-		self.last_net_ts = time.time()
+		self.builder = PayloadBuilder(lat, lon)
 
 	def log(self, msg: str):
 		if self.verbose:
@@ -74,62 +63,7 @@ class BridgeThread(threading.Thread):
 				if self.ser is None:
 					continue
 
-			# Build payload
-			cpu, total_kb, used_kb = get_system_stats()
-			payload = {"cpu": round(cpu, 1), "ram": total_kb, "ram_used": used_kb}
-			try:
-				payload["host"] = socket.gethostname()
-			except Exception:
-				pass
-			payload["time"] = int(time.time())
-			try:
-				payload["uptime"] = int(time.time() - psutil.boot_time())
-			except Exception:
-				pass
-
-			disk_free_kb = get_disk_free_kb()
-			if disk_free_kb >= 0:
-				payload["disk_free"] = disk_free_kb
-
-			# Net rate
-			try:
-				now_ts = time.time()
-				cur = psutil.net_io_counters()
-				dt = max(0.1, now_ts - self.last_net_ts)
-				rx_rate = (cur.bytes_recv - self.last_net.bytes_recv) / 1024.0 / dt
-				tx_rate = (cur.bytes_sent - self.last_net.bytes_sent) / 1024.0 / dt
-				payload["net"] = {"rx": round(rx_rate, 1), "tx": round(tx_rate, 1)}
-				self.last_net, self.last_net_ts = cur, now_ts
-			except Exception:
-				pass
-
-			# Active app (macOS)
-			if platform.system() == "Darwin":
-				try:
-					app = get_active_app_name_macos()
-					if app:
-						payload["app"] = app
-				except Exception:
-					pass
-
-			# Weather
-			now_ts = time.time()
-			if self.lat is not None and self.lon is not None and (self.last_weather is None or now_ts - self.last_weather_ts > 300):
-				self.last_weather = get_weather(self.lat, self.lon)
-				self.last_weather_ts = now_ts
-			if self.last_weather is not None:
-				w = {}
-				if self.last_weather.temp is not None:
-					w["temp"] = round(float(self.last_weather.temp), 1)
-				if self.last_weather.desc:
-					w["desc"] = self.last_weather.desc
-				if self.last_weather.code is not None:
-					try:
-						w["wcode"] = int(self.last_weather.code)
-					except Exception:
-						pass
-				if w:
-					payload["weather"] = w
+			payload = self.builder.build()
 
 			line = json.dumps(payload, separators=(",", ":")) + "\n"
 			try: